@@ -238,8 +238,15 @@ void AudioDataStore::parseNewData(const AudioSegmentPayload *payload)
     }
 }
 
+size_t AudioDataStore::getNoPendingData()
+{
+    std::lock_guard<std::mutex> lock(pendingAudioDataMutex);
+    return pendingAudioData.size();
+}
+
 void AudioDataStore::pushAudioDatumToQueue(AudioDatumWithStorageId datum)
 {
+    datum.queuedTime = std::chrono::steady_clock::now();
     {
         std::lock_guard<std::mutex> lock(pendingAudioDataMutex);
         pendingAudioData.emplace(datum);
@@ -4,6 +4,7 @@
 #include "AudioTransportData.h"
 #include "DawInfo.h"
 #include "TrackInfo.h"
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
@@ -40,6 +41,7 @@ class AudioDataStore
     {
         std::shared_ptr<AudioTransportData> datum;
         uint64_t storageIdentifier;
+        std::chrono::steady_clock::time_point queuedTime; /**< when the datum was pushed to the queue */
     };
 
     /**
@@ -59,6 +61,13 @@ class AudioDataStore
      */
     void freeStoredDatum(uint64_t storageIndentifier);
 
+    /**
+     * @brief Number of datums that are waiting in the queue to be read with waitForDatum.
+     *
+     * @return size_t the queue depth
+     */
+    size_t getNoPendingData();
+
     /**
      * @brief Called by server when it received AudioSegmentPayload structs
      * and will copy the data to preallocated buffers, and split it into
@@ -4,6 +4,7 @@
 #include "AudioTransport.pb.h"
 #include "ColorBytes.h"
 #include "TrackInfo.h"
+#include <chrono>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -178,6 +179,11 @@ void AudioDataStoreTestSuite::testParse01()
 
     store.parseNewData(&payload);
 
+    if (store.getNoPendingData() != 4)
+    {
+        throw std::runtime_error("queue depth is not 4 after parsing the payload");
+    }
+
     auto datum1 = store.waitForDatum();
     auto datum2 = store.waitForDatum();
     auto datum3 = store.waitForDatum();
@@ -190,6 +196,14 @@ void AudioDataStoreTestSuite::testParse01()
             throw std::runtime_error("Size of queue is not 3 after the 3 first events");
         }
     }
+    if (store.getNoPendingData() != 0)
+    {
+        throw std::runtime_error("queue depth is not 0 after reading all events");
+    }
+    if (datum1->queuedTime > datum2->queuedTime || datum1->queuedTime > std::chrono::steady_clock::now())
+    {
+        throw std::runtime_error("datums queued times are not consistent");
+    }
 
     auto datum1Segment = std::dynamic_pointer_cast<AudioSegment>(datum1->datum);
     if (datum1Segment == nullptr)
@@ -31,6 +31,11 @@ class ServerStatusTask : public Task
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<ServerStatusTask>();
+    }
+
     std::pair<bool, uint32_t> runningAndPort; /**<first is true if running false otherwise, and second is port */
 };
 } // namespace AudioTransport
\ No newline at end of file
@@ -149,4 +149,9 @@ std::optional<AudioDataStore::AudioDatumWithStorageId> SyncServer::waitForDatum(
 void SyncServer::freeStoredDatum(uint64_t storageIndentifier)
 {
     store.freeStoredDatum(storageIndentifier);
+}
+
+size_t SyncServer::getNoPendingData()
+{
+    return store.getNoPendingData();
 }
\ No newline at end of file
@@ -76,6 +76,13 @@ class SyncServer final
      */
     void freeStoredDatum(uint64_t storageIndentifier);
 
+    /**
+     * @brief Number of datums that are waiting to be read with waitForDatum.
+     *
+     * @return size_t the queue depth
+     */
+    size_t getNoPendingData();
+
     /**
      * @brief Tells if the server is running
      *
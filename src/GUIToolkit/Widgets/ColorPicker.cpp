@@ -150,7 +150,7 @@ std::vector<juce::Colour> ColorPicker::getDefaultColours()
 
 bool ColorPicker::taskHandler(std::shared_ptr<Task> task)
 {
-    auto colorUpdateTask = std::dynamic_pointer_cast<ColorPickerUpdateTask>(task);
+    auto colorUpdateTask = taskCast<ColorPickerUpdateTask>(task);
     // either we update based on completed task, or either we process a color update request
     if (colorUpdateTask != nullptr && colorUpdateTask->colorPickerIdentifier == identifier &&
         !colorUpdateTask->hasFailed() && !colorUpdateTask->isCompleted())
@@ -184,6 +184,11 @@ bool ColorPicker::taskHandler(std::shared_ptr<Task> task)
     return false;
 }
 
+std::vector<TaskTypeId> ColorPicker::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<ColorPickerUpdateTask>()};
+}
+
 void ColorPicker::setColour(uint8_t r, uint8_t g, uint8_t b)
 {
     int64_t colorId = -1;
@@ -32,6 +32,11 @@ class ColorPicker : public juce::Component, public TaskListener
 
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
   private:
     std::string identifier; /**< uniquely identifies this colorPicker */
     TaskingManager &taskManager;
@@ -36,6 +36,11 @@ class ColorPickerUpdateTask : public Task
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<ColorPickerUpdateTask>();
+    }
+
     std::vector<std::shared_ptr<Task>> getOppositeTasks() override
     {
         auto rev =
@@ -45,6 +50,16 @@ class ColorPickerUpdateTask : public Task
         return response;
     }
 
+    bool supportsUndo() override
+    {
+        return true;
+    }
+
+    size_t getHistorySizeInBytes() override
+    {
+        return sizeof(ColorPickerUpdateTask) + colorPickerIdentifier.capacity();
+    }
+
     std::string colorPickerIdentifier;
     uint8_t red;
     uint8_t green;
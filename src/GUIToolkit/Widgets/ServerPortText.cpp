@@ -36,7 +36,7 @@ void ServerPortText::paint(juce::Graphics &g)
 
 bool ServerPortText::taskHandler(std::shared_ptr<Task> task)
 {
-    auto taskToParse = std::dynamic_pointer_cast<AudioTransport::ServerStatusTask>(task);
+    auto taskToParse = taskCast<AudioTransport::ServerStatusTask>(task);
     if (taskToParse != nullptr)
     {
         std::lock_guard lock(currentPortMutex);
@@ -44,4 +44,9 @@ bool ServerPortText::taskHandler(std::shared_ptr<Task> task)
     }
 
     return false;
+}
+
+std::vector<TaskTypeId> ServerPortText::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<AudioTransport::ServerStatusTask>()};
 }
\ No newline at end of file
@@ -32,6 +32,11 @@ class ServerPortText : public juce::Component, public TaskListener
      */
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
   private:
     std::optional<uint32_t> currentPort;                  /**< The port of server displayed on screen */
     juce::SharedResourcePointer<FontsLoader> sharedFonts; /**< Singleton that loads fonts */
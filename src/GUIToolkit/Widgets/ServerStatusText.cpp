@@ -42,7 +42,7 @@ void ServerStatusText::paint(juce::Graphics &g)
 
 bool ServerStatusText::taskHandler(std::shared_ptr<Task> task)
 {
-    auto serverUpdate = std::dynamic_pointer_cast<AudioTransport::ServerStatusTask>(task);
+    auto serverUpdate = taskCast<AudioTransport::ServerStatusTask>(task);
     if (serverUpdate != nullptr)
     {
         {
@@ -58,4 +58,9 @@ bool ServerStatusText::taskHandler(std::shared_ptr<Task> task)
         }
     }
     return false;
+}
+
+std::vector<TaskTypeId> ServerStatusText::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<AudioTransport::ServerStatusTask>()};
 }
\ No newline at end of file
@@ -37,6 +37,11 @@ class ServerStatusText : public juce::Component, public TaskListener
      */
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
     // enumeration of all possible displayed states
     enum DisplayedServerState
     {
@@ -81,7 +81,7 @@ void TextEntry::textEditorTextChanged(juce::TextEditor &te)
 
 bool TextEntry::taskHandler(std::shared_ptr<Task> task)
 {
-    auto textUpdateTask = std::dynamic_pointer_cast<TextEntryUpdateTask>(task);
+    auto textUpdateTask = taskCast<TextEntryUpdateTask>(task);
     if (textUpdateTask != nullptr && !textUpdateTask->isCompleted() &&
         textUpdateTask->textEntryIdentifier == identifier)
     {
@@ -105,4 +105,9 @@ bool TextEntry::taskHandler(std::shared_ptr<Task> task)
         return true;
     }
     return false;
+}
+
+std::vector<TaskTypeId> TextEntry::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<TextEntryUpdateTask>()};
 }
\ No newline at end of file
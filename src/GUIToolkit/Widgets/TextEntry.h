@@ -40,6 +40,11 @@ class TextEntry : public juce::Component, public juce::TextEditor::Listener, pub
 
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
   private:
     std::string identifier; /**< unique identifier for this component */
     std::string name;       /**< text displayed next to the entry */
@@ -85,6 +90,11 @@ class TextEntryUpdateTask : public Task
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<TextEntryUpdateTask>();
+    }
+
     std::vector<std::shared_ptr<Task>> getOppositeTasks() override
     {
         std::vector<std::shared_ptr<Task>> response;
@@ -97,6 +107,17 @@ class TextEntryUpdateTask : public Task
         return response;
     }
 
+    bool supportsUndo() override
+    {
+        return undoable;
+    }
+
+    size_t getHistorySizeInBytes() override
+    {
+        return sizeof(TextEntryUpdateTask) + textEntryIdentifier.capacity() + previousText.capacity() +
+               newText.capacity();
+    }
+
     std::string textEntryIdentifier;
     std::string previousText;
     std::string newText;
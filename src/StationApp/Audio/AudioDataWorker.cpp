@@ -3,32 +3,136 @@
 #include "AudioTransport/DawInfo.h"
 #include "AudioTransport/SyncServer.h"
 #include "AudioTransport/TrackInfo.h"
+#include "StationApp/Audio/AudioWorkersMetricsTask.h"
 #include "StationApp/Audio/BpmUpdateTask.h"
-#include "StationApp/Audio/FftResultVectorReuseTask.h"
 #include "StationApp/Audio/NewFftDataTask.h"
 #include "StationApp/Audio/ProcessingTimer.h"
 #include "StationApp/Audio/TimeSignatureUpdateTask.h"
 #include "StationApp/Audio/TrackInfoUpdateTask.h"
+#include "StationApp/GUI/ClearTask.h"
 #include "TaskManagement/TaskingManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <new>
 #include <spdlog/spdlog.h>
 
-#define NUM_AUDIO_WORKER_THREADS 2
-
 AudioDataWorker::AudioDataWorker(AudioTransport::SyncServer &server, TaskingManager &tm)
-    : shouldStop(false), taskingManager(tm), audioDataServer(server), processingTimerDelayMs(0)
+    : shouldStop(false), noActiveWorkers(AUDIO_WORKERS_MIN_THREADS), taskingManager(tm), audioDataServer(server),
+      emitDisplayResolution(true), metricsNoSegments(0), metricsMaxQueueDepth(0),
+      metricsQueueLatencySumMs(0), metricsAnalysisLatencySumMs(0), metricsLastTaskHeapAllocations(0),
+      newFftDataTasksPool(AUDIO_WORKERS_FFT_TASKS_POOL_SIZE), trackInfoTasksPool(AUDIO_WORKERS_INFO_TASKS_POOL_SIZE),
+      timeSignatureTasksPool(AUDIO_WORKERS_INFO_TASKS_POOL_SIZE), bpmTasksPool(AUDIO_WORKERS_INFO_TASKS_POOL_SIZE)
 {
-    // create the worker threads
-    for (size_t i = 0; i < NUM_AUDIO_WORKER_THREADS; i++)
+    metricsPeriodStart = std::chrono::steady_clock::now();
+    // pick the spectral analysis engine based on envar
+    if (const char *spectrumEngine = std::getenv("KHOLORS_SPECTRUM_ENGINE"))
+    {
+        if (std::strcmp(spectrumEngine, "multires") == 0)
+        {
+            spdlog::info("Using the multi resolution spectral analysis engine");
+            multiResolutionProcessor = std::make_unique<MultiResolutionFftRunner>();
+        }
+    }
+    // the FFT stage maps its bins to display rows unless raw bins are requested
+    if (const char *fftOutput = std::getenv("KHOLORS_FFT_OUTPUT"))
+    {
+        if (std::strcmp(fftOutput, "bins") == 0)
+        {
+            spdlog::info("FFT stage will emit raw frequency bins");
+            emitDisplayResolution = false;
+        }
+    }
+    // create the worker threads, the ones above AUDIO_WORKERS_MIN_THREADS start parked
+    for (size_t i = 0; i < AUDIO_WORKERS_MAX_THREADS; i++)
     {
-        dataProcessingThreads.emplace_back(std::thread(&AudioDataWorker::workerThreadLoop, this));
+        dataProcessingThreads.emplace_back(std::thread(&AudioDataWorker::workerThreadLoop, this, i));
     }
     tm.registerTaskListener(this);
 }
 
-void AudioDataWorker::workerThreadLoop()
+void AudioDataWorker::scaleUpIfBackedUp(size_t queueDepth)
+{
+    {
+        std::lock_guard lock(audioWorkerThreadMutex);
+        if (noActiveWorkers >= AUDIO_WORKERS_MAX_THREADS ||
+            queueDepth <= noActiveWorkers * AUDIO_WORKERS_SCALE_UP_QUEUE_DEPTH)
+        {
+            return;
+        }
+        noActiveWorkers++;
+        spdlog::debug("Audio data queue is backing up ({} pending), using {} workers", queueDepth, noActiveWorkers);
+    }
+    parkedWorkersCondVar.notify_all();
+}
+
+void AudioDataWorker::scaleDownIfLastWorker(size_t workerIndex)
+{
+    std::lock_guard lock(audioWorkerThreadMutex);
+    if (workerIndex + 1 == noActiveWorkers && noActiveWorkers > AUDIO_WORKERS_MIN_THREADS)
+    {
+        noActiveWorkers--;
+        spdlog::debug("Audio data queue is idle, using {} workers", noActiveWorkers);
+    }
+}
+
+void AudioDataWorker::recordSegmentMetrics(std::chrono::steady_clock::time_point queuedTime,
+                                           std::chrono::steady_clock::time_point dequeuedTime, size_t queueDepth)
+{
+    auto now = std::chrono::steady_clock::now();
+    std::shared_ptr<AudioWorkersMetricsTask> metricsTask;
+    {
+        std::lock_guard lock(metricsMutex);
+        metricsNoSegments++;
+        metricsMaxQueueDepth = std::max(metricsMaxQueueDepth, queueDepth);
+        metricsQueueLatencySumMs += std::chrono::duration<double, std::milli>(dequeuedTime - queuedTime).count();
+        metricsAnalysisLatencySumMs += std::chrono::duration<double, std::milli>(now - dequeuedTime).count();
+
+        if (now - metricsPeriodStart < std::chrono::milliseconds(AUDIO_WORKERS_METRICS_PERIOD_MS))
+        {
+            return;
+        }
+
+        size_t activeWorkers;
+        {
+            std::lock_guard workersLock(audioWorkerThreadMutex);
+            activeWorkers = noActiveWorkers;
+        }
+        // once the pools are warm, the pooled tasks should not allocate anymore
+        uint64_t taskHeapAllocations = newFftDataTasksPool.getNoHeapAllocations() +
+                                       trackInfoTasksPool.getNoHeapAllocations() +
+                                       timeSignatureTasksPool.getNoHeapAllocations() +
+                                       bpmTasksPool.getNoHeapAllocations();
+        metricsTask = std::make_shared<AudioWorkersMetricsTask>(
+            activeWorkers, metricsMaxQueueDepth, metricsNoSegments,
+            float(metricsQueueLatencySumMs / double(metricsNoSegments)),
+            float(metricsAnalysisLatencySumMs / double(metricsNoSegments)),
+            taskHeapAllocations - metricsLastTaskHeapAllocations, admissionController.takeNoDecimatedSegments(),
+            admissionController.takeNoDroppedSegments());
+        metricsLastTaskHeapAllocations = taskHeapAllocations;
+
+        metricsPeriodStart = now;
+        metricsNoSegments = 0;
+        metricsMaxQueueDepth = 0;
+        metricsQueueLatencySumMs = 0;
+        metricsAnalysisLatencySumMs = 0;
+    }
+    spdlog::debug("Audio workers: {} active, max queue depth {}, {} segments, queue latency {:.2f}ms, analysis "
+                  "latency {:.2f}ms, {} task heap allocations",
+                  metricsTask->noActiveWorkers, metricsTask->maxQueueDepth, metricsTask->noSegments,
+                  metricsTask->avgQueueLatencyMs, metricsTask->avgAnalysisLatencyMs,
+                  metricsTask->noTaskHeapAllocations);
+    if (metricsTask->noDecimatedSegments > 0 || metricsTask->noDroppedSegments > 0)
+    {
+        spdlog::warn("Audio pipeline is overloaded: {} segments decimated and {} dropped before their analysis",
+                     metricsTask->noDecimatedSegments, metricsTask->noDroppedSegments);
+    }
+    taskingManager.broadcastTask(metricsTask);
+}
+
+void AudioDataWorker::workerThreadLoop(size_t workerIndex)
 {
     auto audioBuffer = std::make_shared<juce::AudioSampleBuffer>();
     audioBuffer->setSize(1, AUDIO_SEGMENTS_BLOCK_SIZE);
@@ -44,15 +148,66 @@ void AudioDataWorker::workerThreadLoop()
                 return;
             }
         }
+        // if this worker is parked, wait until it's needed (or one second to check shouldStop)
+        {
+            std::unique_lock lock(audioWorkerThreadMutex);
+            if (workerIndex >= noActiveWorkers)
+            {
+                parkedWorkersCondVar.wait_for(lock, std::chrono::seconds(1),
+                                              [this, workerIndex] { return workerIndex < noActiveWorkers; });
+                continue;
+            }
+        }
         // poll on an audio data update
         auto audioDataUpdate = audioDataServer.waitForDatum();
         if (audioDataUpdate.has_value())
         {
+            auto dequeuedTime = std::chrono::steady_clock::now();
+            size_t queueDepth = audioDataServer.getNoPendingData();
+            scaleUpIfBackedUp(queueDepth);
+
             // if it's an audio segment, perform SFFT and update cursor position
             std::shared_ptr<AudioTransport::AudioSegment> audioSegment =
                 std::dynamic_pointer_cast<AudioTransport::AudioSegment>(audioDataUpdate->datum);
             if (audioSegment != nullptr)
             {
+                // decide before the analysis, so that no FFT is computed only to be discarded on overload
+                SegmentAdmission admission =
+                    admissionController.admit(juce::Time::currentTimeMillis() - audioSegment->payloadSentTimeMs);
+                if (admission == SEGMENT_ADMISSION_DROP)
+                {
+                    // the empty task still reaches the display so that the processing time keeps being reported
+                    auto droppedTask = newFftDataTasksPool.make(
+                        audioSegment->trackIdentifier, audioSegment->noChannels, audioSegment->channel,
+                        audioSegment->sampleRate, audioSegment->segmentStartSample, audioSegment->noAudioSamples, 0,
+                        PooledBlock(), audioSegment->payloadSentTimeMs, emitDisplayResolution);
+                    droppedTask->skip = true;
+                    taskingManager.broadcastTask(droppedTask);
+                    audioDataServer.freeStoredDatum(audioDataUpdate->storageIdentifier);
+                    recordSegmentMetrics(audioDataUpdate->queuedTime, dequeuedTime, queueDepth);
+                    continue;
+                }
+
+                // the multi resolution engine reads the segment samples directly and outputs display rows,
+                // its long windows span several segments so it is never decimated
+                if (multiResolutionProcessor != nullptr)
+                {
+                    int numWindows = FftRunner::getNumFftFromNumSamples(audioSegment->noAudioSamples);
+                    auto displayRows = multiResolutionProcessor->performAnalysis(
+                        audioSegment->trackIdentifier, audioSegment->channel, audioSegment->sampleRate,
+                        audioSegment->segmentStartSample, audioSegment->audioSamples, audioSegment->noAudioSamples);
+
+                    auto newDataTask = newFftDataTasksPool.make(
+                        audioSegment->trackIdentifier, audioSegment->noChannels, audioSegment->channel,
+                        audioSegment->sampleRate, audioSegment->segmentStartSample, audioSegment->noAudioSamples,
+                        (uint32_t)numWindows, std::move(displayRows), audioSegment->payloadSentTimeMs, true);
+
+                    taskingManager.broadcastTask(newDataTask);
+                    audioDataServer.freeStoredDatum(audioDataUpdate->storageIdentifier);
+                    recordSegmentMetrics(audioDataUpdate->queuedTime, dequeuedTime, queueDepth);
+                    continue;
+                }
+
                 // eventually resize the buffer that will hold the data we perform FFT on. Should not do anything most
                 // of the time as we preallocated with the AUDIO_SEGMENTS_BLOCK_SIZE at thread start.
                 try
@@ -72,30 +227,35 @@ void AudioDataWorker::workerThreadLoop()
                     audioBuffer->setSample(0, (int)i, audioSegment->audioSamples[i]);
                 }
 
-                // perform SFFTs
+                // perform SFFTs, a decimated segment has the same windows but only some of them are computed
                 int numFFTs = fftProcessor.getNumFftFromNumSamples(audioSegment->noAudioSamples);
-                auto shortTimeFFTs = fftProcessor.performFft(audioBuffer);
+                int windowStride = admission == SEGMENT_ADMISSION_DECIMATE ? ADMISSION_DECIMATION_STRIDE : 1;
+                PooledBlock shortTimeFFTs;
+                if (emitDisplayResolution)
+                {
+                    shortTimeFFTs =
+                        fftProcessor.performDisplayResolutionFft(audioBuffer, audioSegment->sampleRate, windowStride);
+                }
+                else
+                {
+                    shortTimeFFTs = fftProcessor.performFft(audioBuffer, windowStride);
+                }
 
                 // emit a task with the new data to be added to the visualizer
-                auto newDataTask = std::make_shared<NewFftDataTask>(
+                auto newDataTask = newFftDataTasksPool.make(
                     audioSegment->trackIdentifier, audioSegment->noChannels, audioSegment->channel,
                     audioSegment->sampleRate, audioSegment->segmentStartSample, audioSegment->noAudioSamples,
-                    (uint32_t)numFFTs, shortTimeFFTs, audioSegment->payloadSentTimeMs);
-
-                // if the delay is too severe, skip processing this audio segment
-                if (processingTimerDelayMs > MAX_AUDIO_SEGMENT_PROCESSING_DELAY_MS)
-                {
-                    spdlog::warn("skipped a NewFftDataTask due to high processing delay");
-                    newDataTask->skip = true;
-                }
+                    (uint32_t)numFFTs, std::move(shortTimeFFTs), audioSegment->payloadSentTimeMs,
+                    emitDisplayResolution);
 
                 taskingManager.broadcastTask(newDataTask);
+                recordSegmentMetrics(audioDataUpdate->queuedTime, dequeuedTime, queueDepth);
             }
             // if it's a TrackInfo, copy it and emit a task
             auto trackInfo = std::dynamic_pointer_cast<AudioTransport::TrackInfo>(audioDataUpdate->datum);
             if (trackInfo != nullptr)
             {
-                auto trackudpateTask = std::make_shared<TrackInfoUpdateTask>(
+                auto trackudpateTask = trackInfoTasksPool.make(
                     trackInfo->identifier, trackInfo->name, trackInfo->redColorLevel, trackInfo->greenColorLevel,
                     trackInfo->blueColorLevel);
                 taskingManager.broadcastTask(trackudpateTask);
@@ -104,36 +264,46 @@ void AudioDataWorker::workerThreadLoop()
             auto dawInfo = std::dynamic_pointer_cast<AudioTransport::DawInfo>(audioDataUpdate->datum);
             if (dawInfo != nullptr)
             {
-                auto timeSignatureUpdate = std::make_shared<TimeSignatureUpdateTask>(dawInfo->timeSignatureNumerator);
+                auto timeSignatureUpdate = timeSignatureTasksPool.make(dawInfo->timeSignatureNumerator);
                 taskingManager.broadcastTask(timeSignatureUpdate);
 
-                auto bpmUpdate = std::make_shared<BpmUpdateTask>(dawInfo->bpm);
+                auto bpmUpdate = bpmTasksPool.make(dawInfo->bpm);
                 taskingManager.broadcastTask(bpmUpdate);
             }
             audioDataServer.freeStoredDatum(audioDataUpdate->storageIdentifier);
         }
+        else
+        {
+            // nothing came for a second, we have too many workers
+            scaleDownIfLastWorker(workerIndex);
+        }
     }
 }
 
 bool AudioDataWorker::taskHandler(std::shared_ptr<Task> task)
 {
-    auto reuseVectorTask = std::dynamic_pointer_cast<FftResultVectorReuseTask>(task);
-    if (reuseVectorTask != nullptr && !reuseVectorTask->isCompleted())
+    auto processingTimerDelayUpdate = taskCast<ProcessingTimeUpdateTask>(task);
+    if (processingTimerDelayUpdate != nullptr)
     {
-        fftProcessor.reuseResultArray(reuseVectorTask->resultArray);
-        reuseVectorTask->setCompleted(true);
-        return true;
+        admissionController.updatePipelineState(processingTimerDelayUpdate->averageProcesingTimeMs,
+                                                processingTimerDelayUpdate->drawingBacklog);
     }
 
-    auto processingTimerDelayUpdate = std::dynamic_pointer_cast<ProcessingTimeUpdateTask>(task);
-    if (processingTimerDelayUpdate != nullptr)
+    // the cleared display starts over, so do the multi resolution histories
+    auto clearTask = taskCast<ClearTask>(task);
+    if (clearTask != nullptr && multiResolutionProcessor != nullptr)
     {
-        processingTimerDelayMs = processingTimerDelayUpdate->averageProcesingTimeMs;
+        multiResolutionProcessor->clearHistories();
     }
 
     return false;
 }
 
+std::vector<TaskTypeId> AudioDataWorker::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<ProcessingTimeUpdateTask>(), getTaskTypeIdOf<ClearTask>()};
+}
+
 AudioDataWorker::~AudioDataWorker()
 {
     // take lock and set shouldStop to true
@@ -141,6 +311,12 @@ AudioDataWorker::~AudioDataWorker()
         std::lock_guard lock(shouldStopMutex);
         shouldStop = true;
     }
+    // wake up the parked workers so that they see shouldStop
+    {
+        std::lock_guard lock(audioWorkerThreadMutex);
+        noActiveWorkers = AUDIO_WORKERS_MAX_THREADS;
+    }
+    parkedWorkersCondVar.notify_all();
     // for each thread, join it
     for (size_t i = 0; i < dataProcessingThreads.size(); i++)
     {
@@ -2,15 +2,40 @@
 
 #include "AudioTransport/SyncServer.h"
 #include "StationApp/Audio/FftRunner.h"
+#include "StationApp/Audio/BpmUpdateTask.h"
+#include "StationApp/Audio/MultiResolutionFftRunner.h"
+#include "StationApp/Audio/NewFftDataTask.h"
+#include "StationApp/Audio/SegmentAdmissionController.h"
+#include "StationApp/Audio/TimeSignatureUpdateTask.h"
+#include "StationApp/Audio/TrackInfoUpdateTask.h"
 #include "TaskManagement/TaskListener.h"
+#include "TaskManagement/TaskPool.h"
 #include "TaskManagement/TaskingManager.h"
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <nlohmann/json.hpp>
 
-#define MAX_AUDIO_SEGMENT_PROCESSING_DELAY_MS 500.0f
-
 #define SIMPLE_PAYLOAD_CHECK_INTERVAL_MS 600000
 
+/**< Number of worker threads that are always reading the server queue */
+#define AUDIO_WORKERS_MIN_THREADS 2
+
+/**< Maximum number of worker threads reading the server queue when it backs up */
+#define AUDIO_WORKERS_MAX_THREADS 8
+
+/**< A parked worker is woken up when there are more than this many pending datums per active worker */
+#define AUDIO_WORKERS_SCALE_UP_QUEUE_DEPTH 4
+
+/**< How often the AudioWorkersMetricsTask is emitted */
+#define AUDIO_WORKERS_METRICS_PERIOD_MS 1000
+
+/**< Number of NewFftDataTask whose memory is kept for reuse, as many as FFT results can be in flight */
+#define AUDIO_WORKERS_FFT_TASKS_POOL_SIZE 256
+
+/**< Number of track and daw info tasks whose memory is kept for reuse */
+#define AUDIO_WORKERS_INFO_TASKS_POOL_SIZE 32
+
 class AudioDataWorker : public TaskListener
 {
   public:
@@ -26,18 +51,68 @@ class AudioDataWorker : public TaskListener
 
     /**
      * @brief Loop the worker threads will run until stopProcessing is called.
+     * Workers with an index above the number of active workers stay parked until the queue backs up.
+     *
+     * @param workerIndex index of the worker thread
      */
-    void workerThreadLoop();
+    void workerThreadLoop(size_t workerIndex);
 
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
   private:
+    /**
+     * @brief Wake up a parked worker if the server queue is backing up.
+     *
+     * @param queueDepth number of datums waiting in the server queue
+     */
+    void scaleUpIfBackedUp(size_t queueDepth);
+
+    /**
+     * @brief Park the last active worker if it is the one calling, as long as we keep the minimum workers.
+     *
+     * @param workerIndex index of the calling worker
+     */
+    void scaleDownIfLastWorker(size_t workerIndex);
+
+    /**
+     * @brief Record the latencies of an audio segment and emit the metrics task when the period is over.
+     *
+     * @param queuedTime time at which the segment was pushed in the server queue
+     * @param dequeuedTime time at which a worker picked the segment
+     * @param queueDepth number of datums waiting in the server queue when the segment was picked
+     */
+    void recordSegmentMetrics(std::chrono::steady_clock::time_point queuedTime,
+                              std::chrono::steady_clock::time_point dequeuedTime, size_t queueDepth);
+
     bool shouldStop;            /**< This will switch to true if we are waiting to stop the task processing */
     std::mutex shouldStopMutex; /**< Mutex to protect concurrent access of shouldStop variable */
     std::vector<std::thread> dataProcessingThreads; /**< threads that read data from server and emit tasks from it */
     std::mutex audioWorkerThreadMutex;              /**< protectd variables shared between audio processing threads */
+    size_t noActiveWorkers;                         /**< workers with a bigger index are parked */
+    std::condition_variable parkedWorkersCondVar;   /**< parked workers wait on it to be woken up */
     TaskingManager &taskingManager;                 /**< Tasking manager to emit new tasks */
     AudioTransport::SyncServer &audioDataServer;    /**< Audio server to read audio data from */
     FftRunner fftProcessor;                         /**< Multi threaded FFT processor */
-    std::atomic<float> processingTimerDelayMs;      /**< last average audio segment processing delay */
+    std::unique_ptr<MultiResolutionFftRunner>
+        multiResolutionProcessor; /**< used instead of fftProcessor if KHOLORS_SPECTRUM_ENGINE=multires, or nullptr */
+    bool emitDisplayResolution;   /**< fftProcessor outputs display rows, unless KHOLORS_FFT_OUTPUT=bins */
+    SegmentAdmissionController admissionController; /**< process, decimate or drop the segments on overload */
+
+    std::mutex metricsMutex;                                  /**< protect the metrics accumulators */
+    std::chrono::steady_clock::time_point metricsPeriodStart; /**< when the current metrics period started */
+    size_t metricsNoSegments;                                 /**< segments processed during the period */
+    size_t metricsMaxQueueDepth;                              /**< highest queue depth seen during the period */
+    double metricsQueueLatencySumMs;                          /**< sum of the time segments waited in the queue */
+    double metricsAnalysisLatencySumMs;                       /**< sum of the time to analyse segments */
+    uint64_t metricsLastTaskHeapAllocations;                  /**< pooled tasks heap allocations at period start */
+
+    TaskPool<NewFftDataTask> newFftDataTasksPool;             /**< recycles the memory of the NewFftDataTask */
+    TaskPool<TrackInfoUpdateTask> trackInfoTasksPool;         /**< recycles the memory of the TrackInfoUpdateTask */
+    TaskPool<TimeSignatureUpdateTask> timeSignatureTasksPool; /**< recycles the memory of the TimeSignatureUpdateTask */
+    TaskPool<BpmUpdateTask> bpmTasksPool;                     /**< recycles the memory of the BpmUpdateTask */
 };
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+#include "TaskManagement/Task.h"
+
+/**
+ * @brief Task periodically emitted by the AudioDataWorker with the state of the ingest pipeline,
+ * averaged over the audio segments processed since the previous one. The spectrogram view shows it
+ * under its render stats when they are enabled.
+ */
+class AudioWorkersMetricsTask : public SilentTask
+{
+  public:
+    AudioWorkersMetricsTask(size_t _noActiveWorkers, size_t _maxQueueDepth, size_t _noSegments,
+                            float _avgQueueLatencyMs, float _avgAnalysisLatencyMs, uint64_t _noTaskHeapAllocations,
+                            uint64_t _noDecimatedSegments, uint64_t _noDroppedSegments)
+    {
+        noActiveWorkers = _noActiveWorkers;
+        maxQueueDepth = _maxQueueDepth;
+        noSegments = _noSegments;
+        avgQueueLatencyMs = _avgQueueLatencyMs;
+        avgAnalysisLatencyMs = _avgAnalysisLatencyMs;
+        noTaskHeapAllocations = _noTaskHeapAllocations;
+        noDecimatedSegments = _noDecimatedSegments;
+        noDroppedSegments = _noDroppedSegments;
+    }
+
+    /**
+    Dumps the task data to a string as json
+    */
+    std::string marshal() override
+    {
+        nlohmann::json taskj = {{"object", "task"},
+                                {"task", "audio_workers_metrics_task"},
+                                {"no_active_workers", noActiveWorkers},
+                                {"max_queue_depth", maxQueueDepth},
+                                {"no_segments", noSegments},
+                                {"avg_queue_latency_ms", avgQueueLatencyMs},
+                                {"avg_analysis_latency_ms", avgAnalysisLatencyMs},
+                                {"no_task_heap_allocations", noTaskHeapAllocations},
+                                {"no_decimated_segments", noDecimatedSegments},
+                                {"no_dropped_segments", noDroppedSegments},
+                                {"failed", hasFailed()},
+                                {"recordable_in_history", recordableInHistory},
+                                {"is_part_of_reversion", isPartOfReversion}};
+        return taskj.dump();
+    }
+
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<AudioWorkersMetricsTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_DATA;
+    }
+
+    size_t noActiveWorkers;         /**< number of audio worker threads reading the queue */
+    size_t maxQueueDepth;           /**< highest number of datums seen waiting in the server queue */
+    size_t noSegments;              /**< number of audio segments processed during the period */
+    float avgQueueLatencyMs;        /**< average time segments waited in the server queue */
+    float avgAnalysisLatencyMs;     /**< average time to run the spectral analysis and emit the task */
+    uint64_t noTaskHeapAllocations; /**< number of pooled tasks that had to be heap allocated during the period */
+    uint64_t noDecimatedSegments;   /**< number of segments the admission controller decimated during the period */
+    uint64_t noDroppedSegments;     /**< number of segments the admission controller dropped during the period */
+};
@@ -2,7 +2,9 @@
 
 #include <nlohmann/json.hpp>
 
+#include "StationApp/Audio/TaskBinaryTags.h"
 #include "TaskManagement/Task.h"
+#include "TaskManagement/TaskBinaryStream.h"
 
 /**
  * @brief Bpm Update task emitted upon DawInfo receivable by server AudioDataWorker.
@@ -30,5 +32,38 @@ class BpmUpdateTask : public SilentTask
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<BpmUpdateTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_UI;
+    }
+
+    uint64_t getCoalescingKey() override
+    {
+        return getTaskTypeIdOf<BpmUpdateTask>();
+    }
+
+    uint32_t getBinaryTag() override
+    {
+        return BPM_UPDATE_TASK_BINARY_TAG;
+    }
+
+    void serializeBinary(TaskBinaryWriter &writer) override
+    {
+        writer.write<float>(bpm);
+    }
+
+    /**
+     * @brief Recreate a task written by serializeBinary.
+     */
+    static std::shared_ptr<Task> decodeBinary(TaskBinaryReader &reader)
+    {
+        return std::make_shared<BpmUpdateTask>(reader.read<float>());
+    }
+
     float bpm; /**< bpm to set or that was set if completed */
 };
@@ -0,0 +1,23 @@
+#include "DataTasksJournal.h"
+#include "StationApp/Audio/BpmUpdateTask.h"
+#include "StationApp/Audio/FftResultsPools.h"
+#include "StationApp/Audio/FftRunner.h"
+#include "StationApp/Audio/NewFftDataTask.h"
+#include "StationApp/Audio/TaskBinaryTags.h"
+#include "StationApp/Audio/TimeSignatureUpdateTask.h"
+#include "StationApp/Audio/TrackInfoUpdateTask.h"
+#include <juce_core/juce_core.h>
+#include <memory>
+
+void registerDataTasksDecoders(TaskJournalDecoders &decoders)
+{
+    // only the pool of the output mode the journal was recorded with gets its blocks allocated
+    auto fftDataPools = std::make_shared<FftResultsPools>(FFT_RESULTS_POOL_NO_BLOCKS);
+
+    decoders.registerDecoder(NEW_FFT_DATA_TASK_BINARY_TAG, [fftDataPools](TaskBinaryReader &reader) {
+        return NewFftDataTask::decodeBinary(reader, *fftDataPools, juce::Time::currentTimeMillis());
+    });
+    decoders.registerDecoder(TRACK_INFO_UPDATE_TASK_BINARY_TAG, TrackInfoUpdateTask::decodeBinary);
+    decoders.registerDecoder(BPM_UPDATE_TASK_BINARY_TAG, BpmUpdateTask::decodeBinary);
+    decoders.registerDecoder(TIME_SIGNATURE_UPDATE_TASK_BINARY_TAG, TimeSignatureUpdateTask::decodeBinary);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "TaskManagement/TaskJournal.h"
+
+/**
+ * @brief Register the decoders of the data tasks emitted by the AudioDataWorker, so that a
+ * task journal recorded from a live session can be replayed by a TaskJournalReplayer.
+ * The replayed NewFftDataTask get their FFT data from pools owned by the decoders and
+ * the replay time as plugin send time.
+ *
+ * @param decoders where to register the decoders
+ */
+void registerDataTasksDecoders(TaskJournalDecoders &decoders);
@@ -0,0 +1,97 @@
+#include "DisplayRowsMapper.h"
+#include <algorithm>
+#include <cmath>
+
+DisplayRowsMapper::DisplayRowsMapper() : lastSampleRate(0), lastNoBins(0), lastProjection(nullptr)
+{
+    rowFirstBin.resize(DISPLAY_RESOLUTION_NO_ROWS);
+    rowLastBin.resize(DISPLAY_RESOLUTION_NO_ROWS);
+    rowWidthInBins.resize(DISPLAY_RESOLUTION_NO_ROWS);
+}
+
+const std::shared_ptr<NormalizedBijectiveProjection> &DisplayRowsMapper::getDisplayFrequencyProjection()
+{
+    static const std::shared_ptr<NormalizedBijectiveProjection> projection =
+        std::make_shared<Log10Projection>(DISPLAY_FREQUENCY_LOG10_SHIFT);
+    return projection;
+}
+
+void DisplayRowsMapper::prepare(const NormalizedBijectiveProjection &projection, uint32_t sampleRate, size_t noBins)
+{
+    if (sampleRate == lastSampleRate && noBins == lastNoBins && &projection == lastProjection)
+    {
+        return;
+    }
+    lastSampleRate = sampleRate;
+    lastNoBins = noBins;
+    lastProjection = &projection;
+
+    // ratio to convert a frequency normalized to display nyquist into a fractional bin index
+    float displayToBinsRatio =
+        (float(DISPLAY_RESOLUTION_SAMPLE_RATE) / float(sampleRate)) * float(noBins > 0 ? noBins - 1 : 0);
+    float rowStrafe = 1.0f / float(DISPLAY_RESOLUTION_NO_ROWS - 1);
+
+    for (size_t row = 0; row < DISPLAY_RESOLUTION_NO_ROWS; row++)
+    {
+        // rows are centered on row * strafe, like the rows the GPU backend draws
+        float lowerBound = std::max(0.0f, (float(row) - 0.5f) * rowStrafe);
+        float upperBound = std::min(1.0f, (float(row) + 0.5f) * rowStrafe);
+        float lowerBin = projection.projectOut(lowerBound) * displayToBinsRatio;
+        float upperBin = projection.projectOut(upperBound) * displayToBinsRatio;
+        float centerBin = projection.projectOut(float(row) * rowStrafe) * displayToBinsRatio;
+
+        rowWidthInBins[row] = upperBin - lowerBin;
+
+        if (noBins == 0 || centerBin > float(noBins - 1))
+        {
+            // above the signal nyquist frequency
+            rowFirstBin[row] = noBins;
+            rowLastBin[row] = noBins;
+            continue;
+        }
+
+        if (rowWidthInBins[row] < 1.0f)
+        {
+            size_t nearestBin = (size_t)(centerBin + 0.5f);
+            rowFirstBin[row] = std::min(nearestBin, noBins - 1);
+            rowLastBin[row] = rowFirstBin[row];
+        }
+        else
+        {
+            rowFirstBin[row] = std::min((size_t)std::ceil(lowerBin), noBins - 1);
+            rowLastBin[row] = std::max(rowFirstBin[row], std::min((size_t)upperBin, noBins - 1));
+        }
+    }
+}
+
+float DisplayRowsMapper::projectRow(const float *bins, size_t row, float minDb) const
+{
+    size_t firstBin = rowFirstBin[row];
+    if (firstBin >= lastNoBins)
+    {
+        return minDb;
+    }
+    size_t lastBin = rowLastBin[row];
+    float loudest = bins[firstBin];
+    for (size_t bin = firstBin + 1; bin <= lastBin; bin++)
+    {
+        if (bins[bin] > loudest)
+        {
+            loudest = bins[bin];
+        }
+    }
+    return loudest;
+}
+
+void DisplayRowsMapper::project(const float *bins, float *rows, float minDb) const
+{
+    for (size_t row = 0; row < DISPLAY_RESOLUTION_NO_ROWS; row++)
+    {
+        rows[row] = projectRow(bins, row, minDb);
+    }
+}
+
+float DisplayRowsMapper::getRowWidthInBins(size_t row) const
+{
+    return rowWidthInBins[row];
+}
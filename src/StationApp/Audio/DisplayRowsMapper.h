@@ -0,0 +1,84 @@
+#pragma once
+
+#include "StationApp/Maths/NormalizedBijectiveProjection.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**< Number of vertical rows an analysis stage emits when it outputs display resolution spectra.
+ * Must match the half height of a tile (SECOND_TILE_HEIGHT / 2) as each channel takes half of it. */
+#define DISPLAY_RESOLUTION_NO_ROWS 256
+
+/**< Sample rate the display frequency axis is built for. Must match VISUAL_SAMPLE_RATE. */
+#define DISPLAY_RESOLUTION_SAMPLE_RATE 48000
+
+/**< Shift of the Log10Projection used for the frequency axis of the spectrogram */
+#define DISPLAY_FREQUENCY_LOG10_SHIFT 0.005f
+
+/**
+ * @brief Maps linear frequency bins of a real FFT (bin 0 at 0Hz, last bin at the signal nyquist
+ * frequency) to the DISPLAY_RESOLUTION_NO_ROWS rows of the spectrogram, using the display frequency projection.
+ * Row 0 is the lowest frequency, as in the tiles where rows are drawn from the center towards the borders.
+ * A row covering multiple bins takes the loudest one, a row narrower than a bin takes the nearest bin.
+ * It is not thread safe, each thread should own its mapper.
+ */
+class DisplayRowsMapper
+{
+  public:
+    DisplayRowsMapper();
+
+    /**
+     * @brief The frequency projection of the spectrogram. The FFT stages emitting display rows, the rows of
+     * the tiles and the GUI frequency transformer all use this instance, as the tiles keep the rows computed
+     * by the FFT stages and only map them to the screen.
+     *
+     * @return const std::shared_ptr<NormalizedBijectiveProjection>& the display frequency projection
+     */
+    static const std::shared_ptr<NormalizedBijectiveProjection> &getDisplayFrequencyProjection();
+
+    /**
+     * @brief Recompute the bin ranges of each row if the projection, sample rate or number of bins changed.
+     *
+     * @param projection the display frequency projection (the one the GUI frequency transformer uses)
+     * @param sampleRate sample rate of the signal that was passed through the FFT
+     * @param noBins number of bins in the FFT output (half the FFT size plus one)
+     */
+    void prepare(const NormalizedBijectiveProjection &projection, uint32_t sampleRate, size_t noBins);
+
+    /**
+     * @brief Writes the DISPLAY_RESOLUTION_NO_ROWS rows intensities (in dB) from the FFT bins (in dB).
+     *
+     * @param bins pointer to the noBins FFT bins passed to prepare
+     * @param rows pointer to where the DISPLAY_RESOLUTION_NO_ROWS rows will be written
+     * @param minDb value to write in rows that are above the signal nyquist frequency
+     */
+    void project(const float *bins, float *rows, float minDb) const;
+
+    /**
+     * @brief Compute a single row intensity (in dB) from the FFT bins (in dB).
+     *
+     * @param bins pointer to the noBins FFT bins passed to prepare
+     * @param row index of the row
+     * @param minDb value to return if the row is above the signal nyquist frequency
+     * @return float the row intensity in dB
+     */
+    float projectRow(const float *bins, size_t row, float minDb) const;
+
+    /**
+     * @brief Tells how many bins (fractional) fit in the frequency range a row covers.
+     * Used to decide which FFT size gives enough resolution for this row.
+     *
+     * @param row index of the row
+     * @return float number of bins covered by the row
+     */
+    float getRowWidthInBins(size_t row) const;
+
+  private:
+    std::vector<size_t> rowFirstBin; /**< first bin of each row. Equals noBins if the row is above nyquist */
+    std::vector<size_t> rowLastBin;  /**< last bin (included) of each row */
+    std::vector<float> rowWidthInBins; /**< how many bins each row covers */
+    uint32_t lastSampleRate;           /**< sample rate the ranges were computed for */
+    size_t lastNoBins;                 /**< number of bins the ranges were computed for */
+    const NormalizedBijectiveProjection *lastProjection; /**< projection the ranges were computed for */
+};
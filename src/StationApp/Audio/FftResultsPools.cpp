@@ -0,0 +1,27 @@
+#include "FftResultsPools.h"
+#include "AudioTransport/Constants.h"
+#include "StationApp/Audio/DisplayRowsMapper.h"
+#include "StationApp/Audio/FftRunner.h"
+
+FftResultsPools::FftResultsPools(size_t noBlocksParam) : noBlocks(noBlocksParam)
+{
+}
+
+AlignedBlockPool &FftResultsPools::getPool(bool displayResolution)
+{
+    if (displayResolution)
+    {
+        std::call_once(rowsPoolCreated,
+                       [this]() { rowsPool = AlignedBlockPool::create(getSegmentResultsSize(true), noBlocks); });
+        return *rowsPool;
+    }
+    std::call_once(binsPoolCreated,
+                   [this]() { binsPool = AlignedBlockPool::create(getSegmentResultsSize(false), noBlocks); });
+    return *binsPool;
+}
+
+size_t FftResultsPools::getSegmentResultsSize(bool displayResolution)
+{
+    size_t floatsPerFft = displayResolution ? DISPLAY_RESOLUTION_NO_ROWS : FFT_OUTPUT_NO_FREQS;
+    return (size_t)FftRunner::getNumFftFromNumSamples(AUDIO_SEGMENTS_BLOCK_SIZE) * floatsPerFft;
+}
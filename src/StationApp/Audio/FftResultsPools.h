@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Utils/AlignedBlockPool.h"
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief The pools the FFT results of the audio segments are acquired from, one for the segments
+ * of display rows and one for the segments of raw frequency bins. Each pool is only created
+ * the first time it is needed, so that only the output mode in use holds preallocated blocks
+ * (a segment of raw bins is several times larger than a segment of display rows).
+ * It is thread safe.
+ */
+class FftResultsPools
+{
+  public:
+    /**
+     * @brief Construct the pools object, without creating any pool.
+     *
+     * @param noBlocks number of blocks of each pool
+     */
+    FftResultsPools(size_t noBlocks);
+
+    /**
+     * @brief Get the pool of an output mode, creating it on first use. Its blocks hold the FFTs
+     * of a channel of an audio segment of AUDIO_SEGMENTS_BLOCK_SIZE samples.
+     *
+     * @param displayResolution true for the display rows pool, false for the raw bins pool
+     * @return AlignedBlockPool& the pool
+     */
+    AlignedBlockPool &getPool(bool displayResolution);
+
+    /**
+     * @brief Number of floats of the FFTs of a channel of an audio segment of AUDIO_SEGMENTS_BLOCK_SIZE samples.
+     *
+     * @param displayResolution true for display rows, false for raw bins
+     * @return size_t the number of floats
+     */
+    static size_t getSegmentResultsSize(bool displayResolution);
+
+  private:
+    size_t noBlocks;                            /**< number of blocks of each pool */
+    std::once_flag rowsPoolCreated;             /**< set once rowsPool is created */
+    std::once_flag binsPoolCreated;             /**< set once binsPool is created */
+    std::shared_ptr<AlignedBlockPool> rowsPool; /**< blocks of display rows, or nullptr if not used yet */
+    std::shared_ptr<AlignedBlockPool> binsPool; /**< blocks of raw bins, or nullptr if not used yet */
+};
@@ -1,17 +1,25 @@
 #include "FftRunner.h"
+#include "AudioTransport/Constants.h"
 #include "fft.h"
 #include "fft_internal.h"
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <memory>
 #include <mutex>
 #include <spdlog/spdlog.h>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
 using namespace std::chrono_literals;
 
-FftRunner::FftRunner() : exiting(false)
+FftRunner::FftRunner() : FftRunner(FftWorkersConfig::load())
+{
+}
+
+FftRunner::FftRunner(const FftWorkersConfig &config)
+    : exiting(false), noActiveWorkers(0), workersConfig(config), resultsPools(FFT_RESULTS_POOL_NO_BLOCKS)
 {
     lowIntensityBounds =
         std::pow(10.0f, MIN_DB / 10.0f) / (HANN_AMPLITUDE_CORRECTION_FACTOR * HANN_AMPLITUDE_CORRECTION_FACTOR);
@@ -34,12 +42,23 @@ FftRunner::FftRunner() : exiting(false)
             0.5 * (1 - std::cos(2.0f * juce::MathConstants<float>::pi * (float)i / float(hannWindowTable.size() - 1)));
     }
 
-    // Pick the number of threads and start them.
-    // Copy pasted from the post linked in the header file, it's already perfect like this.
-    const uint32_t num_threads = std::thread::hardware_concurrency(); // Max # of threads the system supports
-    for (uint32_t ii = 0; ii < num_threads; ++ii)
+    // the workers are only started by the first FFTs, so that the self benchmark neither delays
+    // the startup nor runs at all when another spectrum engine is used
+}
+
+void FftRunner::startWorkers()
+{
+    // Start the configured number of threads, or pick it by benchmarking.
+    // Running as many workers as the system supports oversubscribes the cores we share with
+    // the render thread, the audio data workers and the server.
+    if (workersConfig.noWorkers > 0)
+    {
+        setNoWorkers(workersConfig.noWorkers);
+        spdlog::info("Started {} FFT workers", workersConfig.noWorkers);
+    }
+    else
     {
-        workerThreads.emplace_back(std::thread(&FftRunner::fftThreadsLoop, this));
+        runSelfBenchmark();
     }
 }
 
@@ -59,6 +78,68 @@ FftRunner::~FftRunner()
     workerThreads.clear();
 }
 
+void FftRunner::setNoWorkers(size_t noWorkers)
+{
+    {
+        std::scoped_lock<std::mutex> lock(queueMutex);
+        noActiveWorkers = noWorkers;
+    }
+    // wake up the workers that have to exit
+    mutexCondition.notify_all();
+    while (workerThreads.size() > noWorkers)
+    {
+        workerThreads.back().join();
+        workerThreads.pop_back();
+    }
+    while (workerThreads.size() < noWorkers)
+    {
+        workerThreads.emplace_back(std::thread(&FftRunner::fftThreadsLoop, this, workerThreads.size()));
+    }
+}
+
+void FftRunner::runSelfBenchmark()
+{
+    // a signal loud enough for the dB conversion to run on most bins
+    auto benchmarkSignal = std::make_shared<juce::AudioSampleBuffer>();
+    benchmarkSignal->setSize(1, FFT_BENCHMARK_NO_SAMPLES);
+    for (int i = 0; i < FFT_BENCHMARK_NO_SAMPLES; i++)
+    {
+        benchmarkSignal->setSample(0, i, 0.5f * std::sin(0.05f * float(i)) + 0.25f * std::sin(0.7f * float(i)));
+    }
+    double noFftsPerRun = double(getNumFftFromNumSamples(FFT_BENCHMARK_NO_SAMPLES));
+    // the results are written to a block of their own, freed with the benchmark
+    auto benchmarkPool = AlignedBlockPool::create((size_t)noFftsPerRun * DISPLAY_RESOLUTION_NO_ROWS, 1);
+
+    size_t maxWorkers = workersConfig.getMaxAutoWorkers();
+    size_t bestNoWorkers = 1;
+    double bestThroughput = 0.0;
+    for (size_t noWorkers = 1; noWorkers <= maxWorkers; noWorkers++)
+    {
+        setNoWorkers(noWorkers);
+        // untimed run to let the new worker create its muFFT plan
+        runFfts(benchmarkSignal, DISPLAY_RESOLUTION_SAMPLE_RATE, true, 1, *benchmarkPool);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int run = 0; run < FFT_BENCHMARK_NO_RUNS; run++)
+        {
+            runFfts(benchmarkSignal, DISPLAY_RESOLUTION_SAMPLE_RATE, true, 1, *benchmarkPool);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double throughput = (noFftsPerRun * FFT_BENCHMARK_NO_RUNS) / std::max(elapsed.count(), 1e-9);
+        spdlog::debug("FFT self benchmark: {} workers run {:.0f} FFT/s", noWorkers, throughput);
+
+        if (throughput < bestThroughput * (1.0 + FFT_BENCHMARK_MIN_GAIN))
+        {
+            break;
+        }
+        bestThroughput = throughput;
+        bestNoWorkers = noWorkers;
+    }
+
+    setNoWorkers(bestNoWorkers);
+    spdlog::info("FFT self benchmark picked {} workers ({:.0f} FFT/s)", bestNoWorkers, bestThroughput);
+}
+
 int FftRunner::getNumFftFromNumSamples(int numSamples)
 {
     // how many non overlapping fft windows we can fit if we pad the end with zeros
@@ -67,45 +148,56 @@ int FftRunner::getNumFftFromNumSamples(int numSamples)
     return (numWindowsNoOverlap * FFT_OVERLAP_DIVISION) - (FFT_OVERLAP_DIVISION - 1);
 }
 
-void FftRunner::reuseResultArray(std::shared_ptr<std::vector<float>> ptr)
+PooledBlock FftRunner::performFft(std::shared_ptr<juce::AudioSampleBuffer> audioFile, int windowStride)
 {
-    {
-        std::lock_guard lock(resultsArrayMutex);
-        freeResultsArrays.push(ptr);
-    }
+    std::call_once(workersStarted, &FftRunner::startWorkers, this);
+    return runFfts(audioFile, 0, false, windowStride, resultsPools.getPool(false));
+}
+
+PooledBlock FftRunner::performDisplayResolutionFft(std::shared_ptr<juce::AudioSampleBuffer> audioFile,
+                                                   uint32_t sampleRate, int windowStride)
+{
+    std::call_once(workersStarted, &FftRunner::startWorkers, this);
+    return runFfts(audioFile, sampleRate, true, windowStride, resultsPools.getPool(true));
 }
 
-std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::AudioSampleBuffer> audioFile)
+PooledBlock FftRunner::runFfts(std::shared_ptr<juce::AudioSampleBuffer> audioFile, uint32_t sampleRate,
+                               bool displayResolution, int windowStride, AlignedBlockPool &resultsPool)
 {
     // NOTE: one job = one fft
 
-    // OPTIMIZATION: reuse result, wg and batchJobs to avoid allocating at every fft
+    // OPTIMIZATION: results come from a preallocated pool, and wg and batchJobs are reused
+    // to avoid allocating at every fft
 
     // number of jobs to send per channel
     int noJobsPerChannel = getNumFftFromNumSamples(audioFile->getNumSamples());
 
+    // number of floats each fft writes in the result
+    size_t outputSize = displayResolution ? DISPLAY_RESOLUTION_NO_ROWS : FFT_OUTPUT_NO_FREQS;
+
     // compute size (in # of floats!) and allocate response array
-    int respArraySize = audioFile->getNumChannels() * noJobsPerChannel * FFT_OUTPUT_NO_FREQS;
+    size_t respArraySize = (size_t)audioFile->getNumChannels() * (size_t)noJobsPerChannel * outputSize;
 
-    std::shared_ptr<std::vector<float>> result;
+    PooledBlock result = resultsPool.acquire(respArraySize);
+    if (!result.isPooled())
     {
-        std::lock_guard lock(resultsArrayMutex);
-        if (freeResultsArrays.size() > 0)
-        {
-            result = freeResultsArrays.front();
-            freeResultsArrays.pop();
-        }
-        else
-        {
-            result = std::make_shared<std::vector<float>>();
-        }
+        spdlog::debug("FFT results pool is exhausted or too small, allocated {} floats", respArraySize);
     }
-    result->resize((size_t)respArraySize);
 
-    // jobs sent in the current batch
+    // jobs sent in the current batch and waitgroup for successive batches of jobs
     std::shared_ptr<std::vector<std::shared_ptr<FftRunnerJob>>> batchJobs;
+    std::shared_ptr<WaitGroup> wg;
     {
         std::lock_guard lock(jobListsMutex);
+        if (freeWaitGroups.size() > 0)
+        {
+            wg = freeWaitGroups.front();
+            freeWaitGroups.pop();
+        }
+        else
+        {
+            wg = std::make_shared<WaitGroup>();
+        }
         if (freeJobLists.size() > 0)
         {
             batchJobs = freeJobLists.front();
@@ -119,9 +211,6 @@ std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::
     batchJobs->resize(0);
     batchJobs->reserve(FFT_JOBS_BATCH_SIZE);
 
-    // waitgroup for successive batches of jobs
-    auto wg = std::make_shared<WaitGroup>();
-
     size_t windowPadding = ((size_t)FFT_INPUT_NO_INTENSITIES / (size_t)FFT_OVERLAP_DIVISION);
 
     size_t numSamples = (size_t)audioFile->getNumSamples();
@@ -130,13 +219,13 @@ std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::
     for (int ch = 0; ch < audioFile->getNumChannels(); ch++)
     {
         // channel offset in the destination array (result)
-        size_t channelResultArrayOffset = (size_t)ch * (size_t)noJobsPerChannel * FFT_OUTPUT_NO_FREQS;
+        size_t channelResultArrayOffset = (size_t)ch * (size_t)noJobsPerChannel * outputSize;
 
         // pointer to the start of the next job
         const float *nextJobStart = audioFile->getReadPointer(ch);
 
-        // total jobs still to be sent for this channel
-        int remainingJobs = noJobsPerChannel;
+        // total jobs still to be sent for this channel, one per stride when decimating
+        int remainingJobs = (noJobsPerChannel + windowStride - 1) / windowStride;
 
         // index of the fft in posted jobs
         int fftPosition = 0;
@@ -187,6 +276,8 @@ std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::
                 currentJob->input = nextJobStart;
                 currentJob->wg = wg;
                 currentJob->position = fftPosition;
+                currentJob->sampleRate = sampleRate;
+                currentJob->displayResolution = displayResolution;
                 wg->Add(1);
                 // if our buffer will extend past end of channel, prevent it
                 size_t windowStart = ((size_t)fftPosition * windowPadding);
@@ -202,9 +293,9 @@ std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::
                 }
                 // decrement remaining job and increment position pointer
                 remainingJobs--;
-                fftPosition++;
+                fftPosition += windowStride;
                 // move the data pointer forward
-                nextJobStart += windowPadding;
+                nextJobStart += windowPadding * (size_t)windowStride;
                 // iterate to next batchJobPtr
                 batchJobPtr++;
             }
@@ -233,10 +324,15 @@ std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::
             {
                 // helper to locate the destination area
                 FftRunnerJob *currentJob = (*batchJobPtr).get();
-                size_t fftChannelOffset = ((size_t)currentJob->position * FFT_OUTPUT_NO_FREQS);
+                size_t fftChannelOffset = ((size_t)currentJob->position * outputSize);
                 size_t fftResultArrayOffset = channelResultArrayOffset + fftChannelOffset;
-                // copy the memory from job data to destination buffer
-                memcpy(result->data() + fftResultArrayOffset, currentJob->output, sizeof(float) * FFT_OUTPUT_NO_FREQS);
+                // copy the memory from job data to destination buffer, and over the windows we skipped
+                int noCopies = std::min(windowStride, noJobsPerChannel - currentJob->position);
+                for (int copy = 0; copy < noCopies; copy++)
+                {
+                    memcpy(result.data() + fftResultArrayOffset + (size_t)copy * outputSize, currentJob->output,
+                           sizeof(float) * outputSize);
+                }
                 {
                     std::scoped_lock<std::mutex> lock(emptyJobsMutex);
                     emptyJobPool.push(*batchJobPtr);
@@ -248,17 +344,21 @@ std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::
         }
     }
 
-    // let's reuse this heap allocated vector
+    // let's reuse this heap allocated vector and the waitgroup
     {
         std::lock_guard lock(jobListsMutex);
         freeJobLists.push(batchJobs);
+        freeWaitGroups.push(wg);
     }
 
     return result;
 }
 
-void FftRunner::fftThreadsLoop()
+void FftRunner::fftThreadsLoop(size_t workerIndex)
 {
+    // pin the thread before allocating so that its buffers are local to its NUMA node
+    workersConfig.applyToCurrentThread();
+
     // instanciate mufft objects
     float *fftInput;
     cfloat *fftOutput;
@@ -282,12 +382,20 @@ void FftRunner::fftThreadsLoop()
         fftInput[i] = 0.0f;
     }
 
+    // buffer for the bins and mapper for the jobs that output display rows
+    std::vector<float> displayBins(FFT_OUTPUT_NO_FREQS);
+    DisplayRowsMapper rowsMapper;
+
     while (true)
     {
         // try to pull a job on the queue
         std::shared_ptr<FftRunnerJob> nextJob = nullptr;
         {
             std::scoped_lock<std::mutex> lock(queueMutex);
+            if (exiting || workerIndex >= noActiveWorkers)
+            {
+                break;
+            }
             if (!todoJobQueue.empty())
             {
                 nextJob = todoJobQueue.front();
@@ -301,29 +409,29 @@ void FftRunner::fftThreadsLoop()
             // note that the processJob function will
             // call the WaitGroup pointer at by the job
             // to notify the job poster that is currently waiting.
-            processJob(nextJob, mufftPlan, fftInput, fftOutput);
+            processJob(nextJob, mufftPlan, fftInput, fftOutput, displayBins.data(), rowsMapper);
         }
         else
         // if no more job on the queue, wait for condition variable
         {
             std::unique_lock<std::mutex> lock(queueMutex);
-            mutexCondition.wait(lock, [this] { return !todoJobQueue.empty() || exiting; });
-            if (exiting)
-            {
-                // free the muFFT resources
-                {
-                    std::scoped_lock<std::mutex> lockFft(fftMutex);
-                    mufft_free_plan_1d(mufftPlan);
-                    mufft_free(fftInput);
-                    mufft_free(fftOutput);
-                }
-                return;
-            }
+            mutexCondition.wait(lock, [this, workerIndex] {
+                return !todoJobQueue.empty() || exiting || workerIndex >= noActiveWorkers;
+            });
         }
     }
+
+    // free the muFFT resources
+    {
+        std::scoped_lock<std::mutex> lockFft(fftMutex);
+        mufft_free_plan_1d(mufftPlan);
+        mufft_free(fftInput);
+        mufft_free(fftOutput);
+    }
 }
 
-void FftRunner::processJob(std::shared_ptr<FftRunnerJob> job, mufft_plan_1d *plan, float *in, cfloat *out)
+void FftRunner::processJob(std::shared_ptr<FftRunnerJob> job, mufft_plan_1d *plan, float *in, cfloat *out, float *bins,
+                           DisplayRowsMapper &rowsMapper)
 {
 
     // copy data into the input
@@ -354,7 +462,8 @@ void FftRunner::processJob(std::shared_ptr<FftRunnerJob> job, mufft_plan_1d *pla
     // copy back the output intensities normalized
     float re, im, dist; /**< real and imaginary parts buffers */
 
-    float *outPtr = job->output;
+    // display rows are computed from the bins, so write them in the thread buffer first
+    float *outPtr = job->displayResolution ? bins : job->output;
 
     for (size_t i = 0; i < FFT_OUTPUT_NO_FREQS; ++i)
     {
@@ -380,6 +489,12 @@ void FftRunner::processJob(std::shared_ptr<FftRunnerJob> job, mufft_plan_1d *pla
         outPtr++;
     }
 
+    if (job->displayResolution)
+    {
+        rowsMapper.prepare(*DisplayRowsMapper::getDisplayFrequencyProjection(), job->sampleRate, FFT_OUTPUT_NO_FREQS);
+        rowsMapper.project(bins, job->output, MIN_DB);
+    }
+
     job->wg->Done();
 }
 
@@ -6,6 +6,11 @@
 #include <mutex>
 #include <vector>
 
+#include "StationApp/Audio/DisplayRowsMapper.h"
+#include "StationApp/Audio/FftResultsPools.h"
+#include "StationApp/Audio/FftWorkersConfig.h"
+#include "StationApp/Maths/NormalizedBijectiveProjection.h"
+#include "Utils/AlignedBlockPool.h"
 #include "Utils/WaitGroup.h"
 #include "fft.h"
 #include "fft_internal.h"
@@ -45,6 +50,18 @@
 /**< Minimum DB intensity to consider possible */
 #define MIN_DB -64.0f
 
+/**< Number of preallocated blocks to hold FFT results, each one can hold the result of an audio segment */
+#define FFT_RESULTS_POOL_NO_BLOCKS 256
+
+/**< Number of samples of the signal the self benchmark runs FFTs on at each run */
+#define FFT_BENCHMARK_NO_SAMPLES (FFT_INPUT_NO_INTENSITIES * 256)
+
+/**< Number of timed runs the self benchmark does for each number of workers */
+#define FFT_BENCHMARK_NO_RUNS 4
+
+/**< Minimum throughput gain (0.05 = 5%) an additional worker must bring for the self benchmark to keep it */
+#define FFT_BENCHMARK_MIN_GAIN 0.05
+
 /**
  * @brief Jobs that are posted in the job queue and picked by threads.
  *        Preallocated at runner startup.
@@ -55,6 +72,8 @@ struct FftRunnerJob
     const float *input; /**< Audio intensities as inputs. Must be readable up to input+(sizeof(float)*inputLength) */
     float output[FFT_OUTPUT_NO_FREQS]; /**< frequency bins as output */
     float inputLength;                 /**< how many samples in the input are to be picked (from start) */
+    uint32_t sampleRate;               /**< sample rate of the input, used to map bins to display rows */
+    bool displayResolution; /**< if true, output holds DISPLAY_RESOLUTION_NO_ROWS display rows instead of bins */
     std::shared_ptr<WaitGroup> wg;     /**< Synchronisation utility for batch of jobs across threads */
 };
 
@@ -68,11 +87,21 @@ class FftRunner
 {
   public:
     /**
-     * @brief Construct a new Fft Runner object
+     * @brief Construct a new Fft Runner object with the workers settings from FftWorkersConfig::load.
      *
      */
     FftRunner();
 
+    /**
+     * @brief Construct a new Fft Runner object.
+     *
+     * @param config number, affinity and priority of the worker threads. If the number of workers is 0,
+     * it is picked by a self benchmark that stops adding workers once they don't increase the throughput.
+     * The workers are started, and the self benchmark is run, by the first call to performFft or
+     * performDisplayResolutionFft.
+     */
+    FftRunner(const FftWorkersConfig &config);
+
     /**
      * @brief Destroy the Fft Runner object
      *
@@ -92,9 +121,23 @@ class FftRunner
      * @brief Perfom a (sequence of short) Fast Fourier Transform on an audio buffer and return its data.
      *
      * @param audioFile A JUCE library audio sample buffer with the audio samples inside.
-     * @return std::shared_ptr<std::vector<float>>  A vector of resulting fourier transform.
+     * @param windowStride only compute one window out of windowStride, and repeat it over the next ones
+     * @return PooledBlock The resulting fourier transforms, given back to the results pool when destroyed.
      */
-    std::shared_ptr<std::vector<float>> performFft(std::shared_ptr<juce::AudioSampleBuffer> audioFile);
+    PooledBlock performFft(std::shared_ptr<juce::AudioSampleBuffer> audioFile, int windowStride = 1);
+
+    /**
+     * @brief Perfom a (sequence of short) Fast Fourier Transform on an audio buffer and return, for each FFT,
+     * DISPLAY_RESOLUTION_NO_ROWS rows already mapped on the display frequency projection instead of the
+     * FFT_OUTPUT_NO_FREQS linear frequency bins. The mapping is done by the worker threads.
+     *
+     * @param audioFile A JUCE library audio sample buffer with the audio samples inside.
+     * @param sampleRate sample rate of the audio samples
+     * @param windowStride only compute one window out of windowStride, and repeat it over the next ones
+     * @return PooledBlock The display rows intensities in decibels, given back to the results pool when destroyed.
+     */
+    PooledBlock performDisplayResolutionFft(std::shared_ptr<juce::AudioSampleBuffer> audioFile, uint32_t sampleRate,
+                                            int windowStride = 1);
 
     /**
      * @brief Processes a job using the provided muFFT processing plan.
@@ -103,27 +146,61 @@ class FftRunner
      * @param plan A muFFT library optimized processing plan for floats.
      * @param in The input FFT data (to copy job input into)
      * @param out The output FFT data (to copy job output from)
+     * @param bins A buffer of FFT_OUTPUT_NO_FREQS floats for bins when the job outputs display rows
+     * @param rowsMapper The thread display rows mapper, used if the job outputs display rows
      */
-    void processJob(std::shared_ptr<FftRunnerJob> jobRef, mufft_plan_1d *plan, float *in, cfloat *out);
+    void processJob(std::shared_ptr<FftRunnerJob> jobRef, mufft_plan_1d *plan, float *in, cfloat *out, float *bins,
+                    DisplayRowsMapper &rowsMapper);
 
+  private:
     /**
-     * @brief Reuse the vector returned by processJob for another processJob call.
+     * @brief Main loop of the threads that are performing FFT.
      *
-     * @param ptr a vector that processJob returned and that is not used anymore
+     * @param workerIndex index of the worker, it exits when it is not below noActiveWorkers anymore
      */
-    void reuseResultArray(std::shared_ptr<std::vector<float>> ptr);
+    void fftThreadsLoop(size_t workerIndex);
 
-  private:
     /**
-     * @brief Main loop of the threads that are performing FFT.
+     * @brief Start or stop worker threads until there are noWorkers of them.
+     * Must not be called while FFTs are running.
+     *
+     * @param noWorkers the number of worker threads to have
+     */
+    void setNoWorkers(size_t noWorkers);
+
+    /**
+     * @brief Start the configured number of workers, or run the self benchmark if it is 0.
+     * Called once, by the first FFTs.
+     */
+    void startWorkers();
+
+    /**
+     * @brief Find the number of workers after which adding a worker does not increase the FFT throughput
+     * by FFT_BENCHMARK_MIN_GAIN anymore, up to FftWorkersConfig::getMaxAutoWorkers, and leave
+     * that number of workers running.
+     */
+    void runSelfBenchmark();
+
+    /**
+     * @brief Run the FFTs of the audio buffer on the worker threads.
      *
+     * @param audioFile the audio samples
+     * @param sampleRate sample rate of the audio samples
+     * @param displayResolution if true, output display rows instead of linear bins
+     * @param windowStride only compute one window out of windowStride, the results keep the same layout
+     * @param resultsPool the pool to acquire the results block from
+     * @return PooledBlock the FFTs results
      */
-    void fftThreadsLoop();
+    PooledBlock runFfts(std::shared_ptr<juce::AudioSampleBuffer> audioFile, uint32_t sampleRate,
+                        bool displayResolution, int windowStride, AlignedBlockPool &resultsPool);
 
     bool exiting;                                           /**< Do threads needs to exit ? */
+    size_t noActiveWorkers;                                 /**< workers with a bigger index have to exit */
+    FftWorkersConfig workersConfig;                         /**< number, affinity and priority of the workers */
     std::mutex queueMutex;                                  /**< Mutex for the job queue */
     std::condition_variable mutexCondition;                 /**< For the thread to poll on jobs or termination */
     std::vector<std::thread> workerThreads;                 /**< list of worker threads */
+    std::once_flag workersStarted;                          /**< set once the first FFTs started the workers */
     std::queue<std::shared_ptr<FftRunnerJob>> todoJobQueue; /**< queue of jobs to be picked by workers */
     std::queue<std::shared_ptr<FftRunnerJob>>
         emptyJobPool;                   /**< Preallocated structures to carry job information. If empty, please wait. */
@@ -131,12 +208,12 @@ class FftRunner
     std::mutex fftMutex;                /**< Mutex for non thread safe muFFT init functions */
     std::vector<float> hannWindowTable; /**< factors of the hann windowing function for our desired input size */
 
-    std::queue<std::shared_ptr<std::vector<float>>> freeResultsArrays; /**< array to hold responses to reuse */
-    std::mutex resultsArrayMutex;
+    FftResultsPools resultsPools; /**< preallocated blocks the results are written to, for the output mode in use */
 
     std::queue<std::shared_ptr<std::vector<std::shared_ptr<FftRunnerJob>>>>
         freeJobLists; /**< list of fft jobs to reuse (prevent too much heap allocs) */
-    std::mutex jobListsMutex;
+    std::queue<std::shared_ptr<WaitGroup>> freeWaitGroups; /**< waitgroups to reuse for the batches of jobs */
+    std::mutex jobListsMutex;                               /**< protect freeJobLists and freeWaitGroups */
 
     float lowIntensityBounds; /**< if an intensity is lower than this, no need to perform conversion to db */
     float highIntensityBounds;
@@ -0,0 +1,196 @@
+#include "FftWorkersConfig.h"
+#include "StationApp/StationSettings.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+FftWorkersConfig::FftWorkersConfig() : noWorkers(0), hasPriority(false), priority(0)
+{
+}
+
+FftWorkersConfig FftWorkersConfig::load()
+{
+    FftWorkersConfig config;
+
+    // settings keys and the environment variables that override them
+    const std::vector<std::pair<std::string, std::string>> entries = {{"fft_workers", "KHOLORS_FFT_WORKERS"},
+                                                                      {"fft_cpus", "KHOLORS_FFT_CPUS"},
+                                                                      {"fft_numa_node", "KHOLORS_FFT_NUMA_NODE"},
+                                                                      {"fft_priority", "KHOLORS_FFT_PRIORITY"}};
+
+    for (auto &value : StationSettings::read(entries))
+    {
+        config.setEntry(value.first, value.second);
+    }
+
+    if (config.cpus.size() == 0 && config.numaNode.size() > 0)
+    {
+        config.applyNumaNode();
+    }
+
+    return config;
+}
+
+void FftWorkersConfig::setEntry(const std::string &key, const std::string &value)
+{
+    try
+    {
+        if (key == "fft_workers")
+        {
+            if (value == "auto")
+            {
+                noWorkers = 0;
+                return;
+            }
+            int parsedWorkers = std::stoi(value);
+            if (parsedWorkers <= 0)
+            {
+                throw std::invalid_argument("number of workers must be positive");
+            }
+            noWorkers = (uint32_t)parsedWorkers;
+        }
+        else if (key == "fft_cpus")
+        {
+            cpus = parseCpuList(value);
+        }
+        else if (key == "fft_numa_node")
+        {
+            // check it's a number as it ends up in a path
+            std::stoi(value);
+            numaNode = value;
+        }
+        else if (key == "fft_priority")
+        {
+            int parsedPriority = std::stoi(value);
+            if (parsedPriority < -20 || parsedPriority > 19)
+            {
+                throw std::invalid_argument("priority must be a nice value between -20 and 19");
+            }
+            priority = parsedPriority;
+            hasPriority = true;
+        }
+    }
+    catch (std::logic_error &e)
+    {
+        spdlog::warn("Ignoring invalid value \"{}\" for setting {}: {}", value, key, e.what());
+    }
+}
+
+std::vector<int> FftWorkersConfig::parseCpuList(const std::string &cpuList)
+{
+    std::vector<int> parsedCpus;
+    std::stringstream listStream(cpuList);
+    std::string range;
+    while (std::getline(listStream, range, ','))
+    {
+        // sysfs lists end with a newline
+        range.erase(std::remove_if(range.begin(), range.end(), [](unsigned char c) { return std::isspace(c); }),
+                    range.end());
+        if (range.size() == 0)
+        {
+            continue;
+        }
+        size_t dashPos = range.find('-');
+        int first = std::stoi(range.substr(0, dashPos));
+        int last = dashPos == std::string::npos ? first : std::stoi(range.substr(dashPos + 1));
+        if (first < 0 || last < first)
+        {
+            throw std::invalid_argument("invalid cpu range " + range);
+        }
+        for (int cpu = first; cpu <= last; cpu++)
+        {
+            parsedCpus.push_back(cpu);
+        }
+    }
+    if (parsedCpus.size() == 0)
+    {
+        throw std::invalid_argument("empty cpu list");
+    }
+    return parsedCpus;
+}
+
+void FftWorkersConfig::applyNumaNode()
+{
+    std::string cpuListPath = "/sys/devices/system/node/node" + numaNode + "/cpulist";
+    std::ifstream cpuListStream(cpuListPath);
+    std::string cpuList;
+    if (!cpuListStream.is_open() || !std::getline(cpuListStream, cpuList))
+    {
+        spdlog::warn("Unable to read the cpus of NUMA node {}, FFT workers will not be pinned", numaNode);
+        return;
+    }
+    try
+    {
+        cpus = parseCpuList(cpuList);
+    }
+    catch (std::logic_error &e)
+    {
+        spdlog::warn("Unable to parse the cpus of NUMA node {}: {}", numaNode, e.what());
+    }
+}
+
+uint32_t FftWorkersConfig::getMaxAutoWorkers() const
+{
+    // the user picked the cpus, use them all
+    if (cpus.size() > 0)
+    {
+        return (uint32_t)cpus.size();
+    }
+    uint32_t noCores = std::thread::hardware_concurrency();
+    if (noCores <= FFT_WORKERS_RESERVED_CORES)
+    {
+        return 1;
+    }
+    return noCores - FFT_WORKERS_RESERVED_CORES;
+}
+
+void FftWorkersConfig::applyToCurrentThread() const
+{
+#ifdef __linux__
+    if (cpus.size() > 0)
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (size_t i = 0; i < cpus.size(); i++)
+        {
+            if (cpus[i] < CPU_SETSIZE)
+            {
+                CPU_SET(cpus[i], &cpuSet);
+            }
+        }
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+        if (err != 0)
+        {
+            spdlog::warn("Unable to set FFT worker cpu affinity: {}", std::strerror(err));
+        }
+    }
+    if (hasPriority)
+    {
+        // on linux the nice value of a thread is set using its thread id
+        pid_t threadId = (pid_t)syscall(SYS_gettid);
+        if (setpriority(PRIO_PROCESS, (id_t)threadId, priority) != 0)
+        {
+            spdlog::warn("Unable to set FFT worker priority: {}", std::strerror(errno));
+        }
+    }
+#else
+    if (cpus.size() > 0 || hasPriority)
+    {
+        spdlog::warn("FFT workers affinity and priority settings are only supported on Linux");
+    }
+#endif
+}
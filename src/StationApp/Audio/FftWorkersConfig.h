@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**< Number of cores the FFT workers leave to the render thread and the audio data workers */
+#define FFT_WORKERS_RESERVED_CORES 2
+
+/**
+ * @brief Settings of the FftRunner worker threads. They are read with StationSettings from
+ * the json settings file and then from the environment variables, which take precedence:
+ * - KHOLORS_FFT_WORKERS / "fft_workers": number of workers, or "auto" (the default) to pick it
+ *   with a self benchmark run by the first FFTs.
+ * - KHOLORS_FFT_CPUS / "fft_cpus": cpu list the workers are pinned to, like "0-7,16-23".
+ * - KHOLORS_FFT_NUMA_NODE / "fft_numa_node": pin the workers to the cpus of this NUMA node,
+ *   ignored if a cpu list is set.
+ * - KHOLORS_FFT_PRIORITY / "fft_priority": nice value of the workers, from -20 to 19.
+ * Affinity and priority are only applied on Linux.
+ */
+struct FftWorkersConfig
+{
+    FftWorkersConfig();
+
+    /**
+     * @brief Read the config from the settings file and the environment variables.
+     * Invalid values are logged and ignored.
+     *
+     * @return FftWorkersConfig the config to start the FftRunner with
+     */
+    static FftWorkersConfig load();
+
+    /**
+     * @brief Parse a linux style cpu list, like "0-3,8,10-11".
+     *
+     * @param cpuList the list to parse
+     * @return std::vector<int> the cpus indexes
+     * @throws std::invalid_argument if the list is malformed
+     */
+    static std::vector<int> parseCpuList(const std::string &cpuList);
+
+    /**
+     * @brief Apply the affinity and priority to the calling thread.
+     */
+    void applyToCurrentThread() const;
+
+    /**
+     * @brief Maximum number of workers the self benchmark is allowed to try.
+     */
+    uint32_t getMaxAutoWorkers() const;
+
+    uint32_t noWorkers;    /**< number of worker threads, 0 means picking it with the self benchmark */
+    std::vector<int> cpus; /**< cpus the workers are pinned to, empty to leave it to the scheduler */
+    bool hasPriority;      /**< true if priority was set */
+    int priority;          /**< nice value of the workers */
+
+  private:
+    /**
+     * @brief Set a config entry from its textual value.
+     *
+     * @param key name of the entry in the settings file
+     * @param value value of the entry
+     */
+    void setEntry(const std::string &key, const std::string &value);
+
+    /**
+     * @brief Read the cpu list of the NUMA node from sysfs and set it as the cpus.
+     */
+    void applyNumaNode();
+
+    std::string numaNode; /**< NUMA node to pin the workers to if no cpu list is set, or empty */
+};
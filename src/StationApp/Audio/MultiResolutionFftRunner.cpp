@@ -0,0 +1,278 @@
+#include "MultiResolutionFftRunner.h"
+#include "AudioTransport/Constants.h"
+#include "fft.h"
+#include "fft_internal.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <vector>
+
+MultiResolutionFftRunner::MultiResolutionFftRunner()
+{
+    lowIntensityBounds =
+        std::pow(10.0f, MIN_DB / 10.0f) / (HANN_AMPLITUDE_CORRECTION_FACTOR * HANN_AMPLITUDE_CORRECTION_FACTOR);
+    highIntensityBounds = 1.0f / (HANN_AMPLITUDE_CORRECTION_FACTOR * HANN_AMPLITUDE_CORRECTION_FACTOR);
+
+    // the FftRunner hop between two output windows, which we keep to output the same windows positions
+    size_t outputHop = (size_t)FFT_INPUT_NO_INTENSITIES / (size_t)FFT_OVERLAP_DIVISION;
+
+    size_t windowSize = MULTIRES_SHORTEST_WINDOW;
+    for (size_t band = 0; band < MULTIRES_NO_BANDS; band++)
+    {
+        bandWindowSizes[band] = windowSize;
+        // long windows are recomputed less often to keep roughly the same overlap as FftRunner
+        bandHopInWindows[band] = std::max((size_t)1, windowSize / (outputHop * FFT_OVERLAP_DIVISION));
+
+        hannWindowTables[band].resize(windowSize);
+        for (size_t i = 0; i < windowSize; i++)
+        {
+            hannWindowTables[band][i] =
+                0.5 * (1 - std::cos(2.0f * juce::MathConstants<float>::pi * (float)i / float(windowSize - 1)));
+        }
+
+        windowSize *= MULTIRES_WINDOW_GROWTH_FACTOR;
+    }
+
+    resultsPool =
+        AlignedBlockPool::create(FftResultsPools::getSegmentResultsSize(true), FFT_RESULTS_POOL_NO_BLOCKS);
+
+    for (size_t i = 0; i < MULTIRES_PREALLOCATED_CONTEXTS; i++)
+    {
+        idleContexts.push_back(createContext());
+    }
+}
+
+MultiResolutionFftRunner::~MultiResolutionFftRunner()
+{
+    std::lock_guard lock(contextsMutex);
+    for (size_t i = 0; i < idleContexts.size(); i++)
+    {
+        freeContext(*idleContexts[i]);
+    }
+    idleContexts.clear();
+}
+
+void MultiResolutionFftRunner::clearHistories()
+{
+    std::lock_guard lock(historiesMutex);
+    histories.clear();
+}
+
+void MultiResolutionFftRunner::expireHistories(std::chrono::steady_clock::time_point now)
+{
+    auto expiry = std::chrono::milliseconds(MULTIRES_HISTORY_EXPIRY_MS);
+    if (now - lastHistoriesExpiry < expiry)
+    {
+        return;
+    }
+    lastHistoriesExpiry = now;
+    for (auto it = histories.begin(); it != histories.end();)
+    {
+        if (now - it->second.lastUsed >= expiry)
+        {
+            it = histories.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+std::unique_ptr<MultiResolutionFftRunner::AnalysisContext> MultiResolutionFftRunner::createContext()
+{
+    auto ctx = std::make_unique<AnalysisContext>();
+    ctx->sampleRate = 0;
+    ctx->rowBands.resize(DISPLAY_RESOLUTION_NO_ROWS);
+    std::scoped_lock<std::mutex> lock(fftMutex);
+    for (size_t band = 0; band < MULTIRES_NO_BANDS; band++)
+    {
+        size_t fftSize = bandWindowSizes[band] * FFT_ZERO_PADDING_FACTOR;
+        size_t noBins = (fftSize >> 1) + 1;
+        ctx->fftInputs[band] = (float *)mufft_alloc(fftSize * sizeof(float));
+        ctx->fftOutputs[band] = (cfloat *)mufft_alloc(noBins * sizeof(cfloat));
+        ctx->plans[band] = mufft_create_plan_1d_r2c(fftSize, MUFFT_FLAG_CPU_ANY);
+        if (ctx->plans[band] == nullptr)
+        {
+            throw std::runtime_error("Unable to initialize muFFT plan, is MULTIRES_SHORTEST_WINDOW a power of two ?");
+        }
+        // the zero padded part of the input is never written by computeBand
+        std::fill(ctx->fftInputs[band], ctx->fftInputs[band] + fftSize, 0.0f);
+        ctx->bandBins[band].resize(noBins);
+        std::fill(ctx->bandBins[band].begin(), ctx->bandBins[band].end(), MIN_DB);
+        ctx->bandIsUsed[band] = false;
+    }
+    return ctx;
+}
+
+void MultiResolutionFftRunner::freeContext(AnalysisContext &ctx)
+{
+    std::scoped_lock<std::mutex> lock(fftMutex);
+    for (size_t band = 0; band < MULTIRES_NO_BANDS; band++)
+    {
+        mufft_free_plan_1d(ctx.plans[band]);
+        mufft_free(ctx.fftInputs[band]);
+        mufft_free(ctx.fftOutputs[band]);
+    }
+}
+
+std::unique_ptr<MultiResolutionFftRunner::AnalysisContext> MultiResolutionFftRunner::acquireContext()
+{
+    {
+        std::lock_guard lock(contextsMutex);
+        if (idleContexts.size() > 0)
+        {
+            auto ctx = std::move(idleContexts.back());
+            idleContexts.pop_back();
+            return ctx;
+        }
+    }
+    spdlog::debug("Allocating a new multi resolution analysis context");
+    return createContext();
+}
+
+void MultiResolutionFftRunner::releaseContext(std::unique_ptr<AnalysisContext> ctx)
+{
+    std::lock_guard lock(contextsMutex);
+    idleContexts.push_back(std::move(ctx));
+}
+
+void MultiResolutionFftRunner::prepareContext(AnalysisContext &ctx, uint32_t sampleRate)
+{
+    if (ctx.sampleRate == sampleRate)
+    {
+        return;
+    }
+    ctx.sampleRate = sampleRate;
+
+    const NormalizedBijectiveProjection &projection = *DisplayRowsMapper::getDisplayFrequencyProjection();
+    for (size_t band = 0; band < MULTIRES_NO_BANDS; band++)
+    {
+        ctx.mappers[band].prepare(projection, sampleRate, ctx.bandBins[band].size());
+        ctx.bandIsUsed[band] = false;
+    }
+
+    // pick for each row the shortest window with enough frequency resolution
+    for (size_t row = 0; row < DISPLAY_RESOLUTION_NO_ROWS; row++)
+    {
+        size_t pickedBand = MULTIRES_NO_BANDS - 1;
+        for (size_t band = 0; band < MULTIRES_NO_BANDS; band++)
+        {
+            if (ctx.mappers[band].getRowWidthInBins(row) >= MULTIRES_MIN_BINS_PER_ROW)
+            {
+                pickedBand = band;
+                break;
+            }
+        }
+        ctx.rowBands[row] = pickedBand;
+        ctx.bandIsUsed[pickedBand] = true;
+    }
+}
+
+PooledBlock MultiResolutionFftRunner::performAnalysis(uint64_t trackIdentifier, uint32_t channel, uint32_t sampleRate,
+                                                      uint32_t segmentStartSample, const float *samples,
+                                                      size_t noSamples)
+{
+    int noWindows = FftRunner::getNumFftFromNumSamples((int)noSamples);
+
+    PooledBlock result = resultsPool->acquire((size_t)noWindows * DISPLAY_RESOLUTION_NO_ROWS);
+
+    auto ctx = acquireContext();
+    prepareContext(*ctx, sampleRate);
+
+    // The signal we run windows on is the track channel history followed by the segment,
+    // followed by zeros up to the end of the last FftRunner window.
+    size_t historySize = MULTIRES_LONGEST_WINDOW;
+    size_t paddedSegmentSize = (size_t)std::ceil(float(noSamples) / float(FFT_INPUT_NO_INTENSITIES)) *
+                               (size_t)FFT_INPUT_NO_INTENSITIES;
+    ctx->signal.resize(historySize + paddedSegmentSize);
+    {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard lock(historiesMutex);
+        expireHistories(now);
+        ChannelHistory &history = histories[std::pair<uint64_t, uint32_t>(trackIdentifier, channel)];
+        history.lastUsed = now;
+        // if this segment does not follow the previous one, don't smear unrelated signal into it
+        if (history.samples.size() != historySize || history.nextSegmentStart != segmentStartSample)
+        {
+            history.samples.resize(historySize);
+            std::fill(history.samples.begin(), history.samples.end(), 0.0f);
+        }
+        memcpy(ctx->signal.data(), history.samples.data(), sizeof(float) * historySize);
+        memcpy(ctx->signal.data() + historySize, samples, sizeof(float) * noSamples);
+        // the new history is the end of the history followed by the segment
+        memcpy(history.samples.data(), ctx->signal.data() + noSamples, sizeof(float) * historySize);
+        history.nextSegmentStart = (uint64_t)segmentStartSample + noSamples;
+    }
+    std::fill(ctx->signal.begin() + historySize + noSamples, ctx->signal.end(), 0.0f);
+
+    size_t outputHop = (size_t)FFT_INPUT_NO_INTENSITIES / (size_t)FFT_OVERLAP_DIVISION;
+    float *rowsPtr = result.data();
+    for (size_t window = 0; window < (size_t)noWindows; window++)
+    {
+        // end of the FftRunner window at the same position
+        size_t windowEnd = historySize + (window * outputHop) + FFT_INPUT_NO_INTENSITIES;
+
+        for (size_t band = 0; band < MULTIRES_NO_BANDS; band++)
+        {
+            if (ctx->bandIsUsed[band] && (window % bandHopInWindows[band]) == 0)
+            {
+                computeBand(*ctx, band, windowEnd);
+            }
+        }
+
+        for (size_t row = 0; row < DISPLAY_RESOLUTION_NO_ROWS; row++)
+        {
+            size_t band = ctx->rowBands[row];
+            *rowsPtr = ctx->mappers[band].projectRow(ctx->bandBins[band].data(), row, MIN_DB);
+            rowsPtr++;
+        }
+    }
+
+    releaseContext(std::move(ctx));
+    return result;
+}
+
+void MultiResolutionFftRunner::computeBand(AnalysisContext &ctx, size_t band, size_t windowEnd)
+{
+    size_t windowSize = bandWindowSizes[band];
+    float *in = ctx.fftInputs[band];
+    cfloat *out = ctx.fftOutputs[band];
+
+    // copy the windowed signal, the zero padding after it is never touched
+    const float *signalPtr = ctx.signal.data() + (windowEnd - windowSize);
+    const float *hannPtr = hannWindowTables[band].data();
+    for (size_t i = 0; i < windowSize; i++)
+    {
+        in[i] = signalPtr[i] * hannPtr[i];
+    }
+
+    mufft_execute_plan_1d(ctx.plans[band], out, in);
+
+    float noIntensitiesF = float(windowSize);
+    float re, im, dist;
+    float *binsPtr = ctx.bandBins[band].data();
+    size_t noBins = ctx.bandBins[band].size();
+    for (size_t i = 0; i < noBins; i++)
+    {
+        re = out[i].real / noIntensitiesF;
+        im = out[i].imag / noIntensitiesF;
+        dist = (re * re) + (im * im);
+        if (dist <= lowIntensityBounds)
+        {
+            binsPtr[i] = MIN_DB;
+        }
+        else if (dist >= highIntensityBounds)
+        {
+            binsPtr[i] = 0.0f;
+        }
+        else
+        {
+            binsPtr[i] = 20.0f * std::log10(std::sqrt(dist) * HANN_AMPLITUDE_CORRECTION_FACTOR);
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "StationApp/Audio/DisplayRowsMapper.h"
+#include "StationApp/Audio/FftRunner.h"
+#include "StationApp/Maths/NormalizedBijectiveProjection.h"
+#include "Utils/AlignedBlockPool.h"
+#include "fft.h"
+
+/**< Number of FFT sizes used, from shortest (highs) to longest (lows) */
+#define MULTIRES_NO_BANDS 3
+
+/**< Size of the window of the shortest band, the one used for high frequencies */
+#define MULTIRES_SHORTEST_WINDOW 1024
+
+/**< Each band window is this much larger than the previous one */
+#define MULTIRES_WINDOW_GROWTH_FACTOR 4
+
+/**< Size of the window of the longest band (used for the lowest frequencies), must follow MULTIRES_NO_BANDS */
+#define MULTIRES_LONGEST_WINDOW                                                                                        \
+    (MULTIRES_SHORTEST_WINDOW * MULTIRES_WINDOW_GROWTH_FACTOR * MULTIRES_WINDOW_GROWTH_FACTOR)
+
+/**< Minimum number of bins a row must cover for a band to be picked to compute it */
+#define MULTIRES_MIN_BINS_PER_ROW 1.0f
+
+/**< Number of analysis contexts (muFFT plans and buffers) created at startup */
+#define MULTIRES_PREALLOCATED_CONTEXTS 2
+
+/**< The history of a track channel that received no segment for this long is freed */
+#define MULTIRES_HISTORY_EXPIRY_MS 10000
+
+/**
+ * @brief A spectral analysis engine that computes its output directly at the display vertical resolution
+ * (DISPLAY_RESOLUTION_NO_ROWS rows per window, on the display frequency projection) instead of returning linear
+ * frequency bins. Each row is computed from the shortest FFT window that gives at least one bin per row, so that lows
+ * get long windows (fine frequency resolution) and highs get short ones (fine time resolution and cheaper FFTs).
+ *
+ * It returns as many windows as FftRunner, at the same positions, so that both outputs can be drawn the same way.
+ * Windows are aligned on the end of the FftRunner ones and long windows reach back into previous segments
+ * of the same track channel, which are kept in a per track history.
+ *
+ * This continuity is best-effort: when several workers analyse consecutive segments of a channel, they can
+ * reach the engine out of order, and a segment that does not start where the previous one ended gets an
+ * empty history (and resets it), so that its long windows only miss some lows instead of mixing unrelated
+ * signal. Histories are freed by clearHistories, or when their channel received nothing for
+ * MULTIRES_HISTORY_EXPIRY_MS, as no task tells when a track is removed.
+ *
+ * Unlike FftRunner, it runs in the calling thread, long windows being recomputed at a lower rate.
+ */
+class MultiResolutionFftRunner
+{
+  public:
+    /**
+     * @brief Construct a new Multi Resolution Fft Runner object
+     */
+    MultiResolutionFftRunner();
+
+    /**
+     * @brief Destroy the Multi Resolution Fft Runner object and free the muFFT resources.
+     */
+    ~MultiResolutionFftRunner();
+
+    /**
+     * @brief Perform the multi resolution analysis of an audio segment of a track channel.
+     *
+     * @param trackIdentifier identifier of the track the segment comes from
+     * @param channel index of the channel the segment comes from
+     * @param sampleRate sample rate of the segment
+     * @param segmentStartSample position of the segment in the track, to detect discontinuities
+     * @param samples pointer to the audio samples
+     * @param noSamples number of audio samples
+     * @return PooledBlock getNumFftFromNumSamples(noSamples) windows of DISPLAY_RESOLUTION_NO_ROWS intensities
+     * in decibels, given back to the results pool when destroyed
+     */
+    PooledBlock performAnalysis(uint64_t trackIdentifier, uint32_t channel, uint32_t sampleRate,
+                                uint32_t segmentStartSample, const float *samples, size_t noSamples);
+
+    /**
+     * @brief Free the histories of all the track channels, for example when the display is cleared.
+     */
+    void clearHistories();
+
+  private:
+    /**
+     * @brief muFFT plans and buffers for each band, owned by one thread at a time.
+     */
+    struct AnalysisContext
+    {
+        mufft_plan_1d *plans[MULTIRES_NO_BANDS]; /**< muFFT plans for each band */
+        float *fftInputs[MULTIRES_NO_BANDS];     /**< zero padded inputs for each band */
+        cfloat *fftOutputs[MULTIRES_NO_BANDS];   /**< complex outputs of each band */
+        std::vector<float> bandBins[MULTIRES_NO_BANDS]; /**< last computed bins in dB for each band */
+        DisplayRowsMapper mappers[MULTIRES_NO_BANDS];   /**< row to bins mapping for each band */
+        std::vector<size_t> rowBands;  /**< index of the band used to compute each row */
+        bool bandIsUsed[MULTIRES_NO_BANDS]; /**< tells if at least one row is computed with this band */
+        uint32_t sampleRate;           /**< sample rate the mappers and rowBands were computed for */
+        std::vector<float> signal;     /**< track history followed by the segment samples */
+    };
+
+    /**
+     * @brief History of the last samples of a track channel.
+     */
+    struct ChannelHistory
+    {
+        std::vector<float> samples;                     /**< last MULTIRES_LONGEST_WINDOW samples received */
+        uint64_t nextSegmentStart;                      /**< position the next segment must start at to be contiguous */
+        std::chrono::steady_clock::time_point lastUsed; /**< when the last segment of the channel was received */
+    };
+
+    /**
+     * @brief Free the histories of the channels that received nothing for MULTIRES_HISTORY_EXPIRY_MS.
+     * Must be called holding historiesMutex.
+     *
+     * @param now current time
+     */
+    void expireHistories(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Get an idle analysis context or create one.
+     */
+    std::unique_ptr<AnalysisContext> acquireContext();
+
+    /**
+     * @brief Give back an analysis context for other threads to use.
+     */
+    void releaseContext(std::unique_ptr<AnalysisContext> ctx);
+
+    /**
+     * @brief Allocate a new analysis context and create its muFFT plans.
+     */
+    std::unique_ptr<AnalysisContext> createContext();
+
+    /**
+     * @brief Free the muFFT resources of a context.
+     */
+    void freeContext(AnalysisContext &ctx);
+
+    /**
+     * @brief Compute the row to band assignment if the sample rate changed.
+     */
+    void prepareContext(AnalysisContext &ctx, uint32_t sampleRate);
+
+    /**
+     * @brief Run the FFT of one band on a window ending at windowEnd in the context signal.
+     *
+     * @param ctx analysis context to use
+     * @param band index of the band
+     * @param windowEnd index in ctx.signal of the sample after the window end
+     */
+    void computeBand(AnalysisContext &ctx, size_t band, size_t windowEnd);
+
+    size_t bandWindowSizes[MULTIRES_NO_BANDS];   /**< size of the window of each band */
+    size_t bandHopInWindows[MULTIRES_NO_BANDS];  /**< a band is recomputed every this much output windows */
+    std::vector<float> hannWindowTables[MULTIRES_NO_BANDS]; /**< hann function for each band window size */
+    float lowIntensityBounds;  /**< below this squared magnitude, no need to convert to dB */
+    float highIntensityBounds; /**< above this squared magnitude, no need to convert to dB */
+
+    std::vector<std::unique_ptr<AnalysisContext>> idleContexts; /**< contexts waiting to be used */
+    std::mutex contextsMutex;                                   /**< protect the idleContexts */
+    std::mutex fftMutex;                                        /**< Mutex for non thread safe muFFT init functions */
+
+    std::map<std::pair<uint64_t, uint32_t>, ChannelHistory> histories; /**< history by track id and channel */
+    std::mutex historiesMutex;                                         /**< protect the histories */
+    std::chrono::steady_clock::time_point lastHistoriesExpiry;         /**< when expireHistories last ran */
+
+    std::shared_ptr<AlignedBlockPool> resultsPool; /**< preallocated blocks the results are written to */
+};
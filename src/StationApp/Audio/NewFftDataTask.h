@@ -4,7 +4,11 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 
+#include "StationApp/Audio/FftResultsPools.h"
+#include "StationApp/Audio/TaskBinaryTags.h"
 #include "TaskManagement/Task.h"
+#include "TaskManagement/TaskBinaryStream.h"
+#include "Utils/AlignedBlockPool.h"
 
 /**
  * @brief This task is emmited when Short Time FFTs were generated from audio data
@@ -15,7 +19,7 @@ class NewFftDataTask : public SilentTask
   public:
     NewFftDataTask(uint64_t _trackIdentifier, uint32_t _noChannels, uint32_t _channelIndex, uint32_t _sampleRate,
                    uint32_t _segmentStartSample, uint64_t _segmentSampleLength, uint32_t _noFFTs,
-                   std::shared_ptr<std::vector<float>> _data, int64_t _sentTimeUnixMs)
+                   PooledBlock &&_data, int64_t _sentTimeUnixMs, bool _displayResolution = false)
     {
         trackIdentifier = _trackIdentifier;
         totalNoChannels = _noChannels;
@@ -24,8 +28,9 @@ class NewFftDataTask : public SilentTask
         segmentStartSample = _segmentStartSample;
         segmentSampleLength = _segmentSampleLength;
         noFFTs = _noFFTs;
-        fftData = _data;
+        fftData = std::move(_data);
         sentTimeUnixMs = _sentTimeUnixMs;
+        displayResolution = _displayResolution;
         skip = false;
     }
 
@@ -45,11 +50,72 @@ class NewFftDataTask : public SilentTask
                                 {"segment_start_sample", segmentStartSample},
                                 {"segment_sample_length", segmentSampleLength},
                                 {"no_ffts", noFFTs},
+                                {"display_resolution", displayResolution},
                                 {"recordable_in_history", recordableInHistory},
                                 {"is_part_of_reversion", isPartOfReversion}};
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<NewFftDataTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        // not ordered with the ClearTask of the control lane, FreqTimeView drops the ones sent before a clear
+        return TASK_LANE_DATA;
+    }
+
+    uint32_t getBinaryTag() override
+    {
+        // the segments dropped by the admission controller carry no FFT data to replay
+        return skip ? NO_BINARY_TASK_TAG : NEW_FFT_DATA_TASK_BINARY_TAG;
+    }
+
+    /**
+     * @brief Write the segment and its FFT data. The skip flag depends on the load of the
+     * recording session, so it is not written and replayed tasks are all displayed.
+     */
+    void serializeBinary(TaskBinaryWriter &writer) override
+    {
+        writer.write<uint64_t>(trackIdentifier);
+        writer.write<uint32_t>(totalNoChannels);
+        writer.write<uint32_t>(channelIndex);
+        writer.write<uint32_t>(sampleRate);
+        writer.write<uint32_t>(segmentStartSample);
+        writer.write<uint64_t>(segmentSampleLength);
+        writer.write<uint32_t>(noFFTs);
+        writer.write<uint8_t>(displayResolution ? 1 : 0);
+        writer.writeFloats(fftData.data(), fftData.size());
+    }
+
+    /**
+     * @brief Recreate a task written by serializeBinary.
+     *
+     * @param reader the record payload
+     * @param pools where to acquire the block of the FFT data, from the pool of its output mode
+     * @param sentTimeUnixMsParam the time to use as the plugin send time
+     * @return std::shared_ptr<Task> the new task
+     */
+    static std::shared_ptr<Task> decodeBinary(TaskBinaryReader &reader, FftResultsPools &pools,
+                                              int64_t sentTimeUnixMsParam)
+    {
+        uint64_t trackId = reader.read<uint64_t>();
+        uint32_t noChannels = reader.read<uint32_t>();
+        uint32_t channel = reader.read<uint32_t>();
+        uint32_t rate = reader.read<uint32_t>();
+        uint32_t startSample = reader.read<uint32_t>();
+        uint64_t sampleLength = reader.read<uint64_t>();
+        uint32_t noWindows = reader.read<uint32_t>();
+        bool isDisplayResolution = reader.read<uint8_t>() != 0;
+        size_t noFloats = reader.readFloatsCount();
+        PooledBlock data = pools.getPool(isDisplayResolution).acquire(noFloats);
+        reader.readFloatsInto(data.data(), noFloats);
+        return std::make_shared<NewFftDataTask>(trackId, noChannels, channel, rate, startSample, sampleLength,
+                                                noWindows, std::move(data), sentTimeUnixMsParam, isDisplayResolution);
+    }
+
     uint64_t trackIdentifier;                    /**< Identifier of the track this segment belongs to */
     uint32_t totalNoChannels;                    /**< Total number of channels of this track */
     uint32_t channelIndex;                       /**< Index of this specific channel data */
@@ -58,6 +124,9 @@ class NewFftDataTask : public SilentTask
     uint64_t segmentSampleLength;                /**< Length of the segment in samples */
     int64_t sentTimeUnixMs;                      /**< time at which the plugin sent the payload */
     uint32_t noFFTs;                             /**< Number of FFTs generated for this segment */
-    std::shared_ptr<std::vector<float>> fftData; /**< raw FFT result in dBs (noFFTs FFTs of len FFT_OUTPUT_NO_FREQS) */
-    bool skip;
+    PooledBlock fftData; /**< FFT results in dBs, noFFTs FFTs of DISPLAY_RESOLUTION_NO_ROWS rows, or of
+                            FFT_OUTPUT_NO_FREQS bins if not displayResolution, back to its pool when destroyed */
+    bool displayResolution; /**< if true, each FFT is DISPLAY_RESOLUTION_NO_ROWS rows already mapped on the display
+                               frequency projection instead of linear frequency bins */
+    bool skip; /**< the segment was dropped before its analysis, only its processing time is reported */
 };
\ No newline at end of file
@@ -44,7 +44,9 @@ void ProcessingTimer::recordCompletion(int64_t processingTimerWgIdentifier, int6
         }
         avgValue = float(avgValueInt) * proportion;
         nextProcessingTimes.resize(0);
-        auto task = std::make_shared<ProcessingTimeUpdateTask>(avgValue);
+        // the audio workers also shed load when the drawings pile up
+        float backlog = 1.0f - float(idleWaitgroups.size()) / float(waitgroups.size());
+        auto task = std::make_shared<ProcessingTimeUpdateTask>(avgValue, backlog);
         taskingManager.broadcastTask(task);
     }
 }
@@ -68,9 +70,10 @@ std::shared_ptr<ProcessingTimerWaitgroup> ProcessingTimer::getNewProcessingTimer
 
 /////////////////////////////////////////////:
 
-ProcessingTimeUpdateTask::ProcessingTimeUpdateTask(float msTime)
+ProcessingTimeUpdateTask::ProcessingTimeUpdateTask(float msTime, float backlog)
 {
     averageProcesingTimeMs = msTime;
+    drawingBacklog = backlog;
 }
 
 std::string ProcessingTimeUpdateTask::marshal()
@@ -80,7 +83,18 @@ std::string ProcessingTimeUpdateTask::marshal()
                             {"is_completed", isCompleted()},
                             {"failed", hasFailed()},
                             {"average_processing_time_ms", averageProcesingTimeMs},
+                            {"drawing_backlog", drawingBacklog},
                             {"recordable_in_history", recordableInHistory},
                             {"is_part_of_reversion", isPartOfReversion}};
     return taskj.dump();
+}
+
+TaskTypeId ProcessingTimeUpdateTask::getTaskTypeId()
+{
+    return getTaskTypeIdOf<ProcessingTimeUpdateTask>();
+}
+
+TaskLane ProcessingTimeUpdateTask::getTaskLane()
+{
+    return TASK_LANE_UI;
 }
\ No newline at end of file
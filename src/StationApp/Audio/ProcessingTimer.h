@@ -53,8 +53,11 @@ class ProcessingTimer
 class ProcessingTimeUpdateTask : public SilentTask
 {
   public:
-    ProcessingTimeUpdateTask(float avgTimeMs);
+    ProcessingTimeUpdateTask(float avgTimeMs, float backlog);
     std::string marshal() override;
+    TaskTypeId getTaskTypeId() override;
+    TaskLane getTaskLane() override;
 
-    float averageProcesingTimeMs;
+    float averageProcesingTimeMs; /**< average time between the plugin sending a segment and its drawing */
+    float drawingBacklog;         /**< ratio of the waitgroups in use, 1 when the drawings can't keep up */
 };
\ No newline at end of file
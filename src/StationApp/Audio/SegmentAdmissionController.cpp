@@ -0,0 +1,41 @@
+#include "SegmentAdmissionController.h"
+#include <algorithm>
+
+SegmentAdmissionController::SegmentAdmissionController()
+    : avgProcessingTimeMs(0.0f), drawingBacklog(0.0f), noDecimatedSegments(0), noDroppedSegments(0)
+{
+}
+
+void SegmentAdmissionController::updatePipelineState(float avgTimeMs, float backlog)
+{
+    avgProcessingTimeMs = avgTimeMs;
+    drawingBacklog = backlog;
+}
+
+SegmentAdmission SegmentAdmissionController::admit(int64_t segmentAgeMs)
+{
+    // the average lags behind by AVERAGING_TIMER_SIZE segments, the age of this one does not
+    float latencyMs = std::max(avgProcessingTimeMs.load(), float(segmentAgeMs));
+    float backlog = drawingBacklog;
+    if (latencyMs > MAX_AUDIO_SEGMENT_PROCESSING_DELAY_MS || backlog >= 1.0f)
+    {
+        noDroppedSegments++;
+        return SEGMENT_ADMISSION_DROP;
+    }
+    if (latencyMs > ADMISSION_DECIMATE_DELAY_MS || backlog > ADMISSION_DECIMATE_DRAWING_BACKLOG)
+    {
+        noDecimatedSegments++;
+        return SEGMENT_ADMISSION_DECIMATE;
+    }
+    return SEGMENT_ADMISSION_PROCESS;
+}
+
+uint64_t SegmentAdmissionController::takeNoDecimatedSegments()
+{
+    return noDecimatedSegments.exchange(0);
+}
+
+uint64_t SegmentAdmissionController::takeNoDroppedSegments()
+{
+    return noDroppedSegments.exchange(0);
+}
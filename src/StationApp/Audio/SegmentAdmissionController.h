@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**< Above this pipeline latency, audio segments are dropped before their spectral analysis */
+#define MAX_AUDIO_SEGMENT_PROCESSING_DELAY_MS 500.0f
+
+/**< Above this pipeline latency, only one FFT window out of ADMISSION_DECIMATION_STRIDE is computed */
+#define ADMISSION_DECIMATE_DELAY_MS 200.0f
+
+/**< Above this ratio of the ProcessingTimer waitgroups in use, segments are decimated */
+#define ADMISSION_DECIMATE_DRAWING_BACKLOG 0.5f
+
+/**< A decimated segment computes one FFT window out of this number and repeats it over the skipped ones */
+#define ADMISSION_DECIMATION_STRIDE 2
+
+/**
+ * @brief What the audio data workers do with an audio segment.
+ */
+enum SegmentAdmission
+{
+    SEGMENT_ADMISSION_PROCESS = 0,  /**< compute all the FFT windows */
+    SEGMENT_ADMISSION_DECIMATE = 1, /**< compute one window out of ADMISSION_DECIMATION_STRIDE */
+    SEGMENT_ADMISSION_DROP = 2      /**< don't compute anything, only report the latency */
+};
+
+/**
+ * @brief Decides before the spectral analysis whether an audio segment is processed, decimated
+ * or dropped, so that no CPU is spent on FFTs that would be discarded on overload.
+ * It is fed by the ProcessingTimeUpdateTask of the ProcessingTimer (the average latency between
+ * the plugin sending a segment and its drawing, and how many drawings are pending), and by the age
+ * of each segment when a worker picks it, which reacts before the next average is computed.
+ * It is thread safe and never locks.
+ */
+class SegmentAdmissionController
+{
+  public:
+    SegmentAdmissionController();
+
+    /**
+     * @brief Update the pipeline state from a ProcessingTimeUpdateTask.
+     *
+     * @param avgProcessingTimeMs average time between the plugin sending a segment and its drawing
+     * @param drawingBacklog ratio of the ProcessingTimer waitgroups in use, 1 when none is left
+     */
+    void updatePipelineState(float avgProcessingTimeMs, float drawingBacklog);
+
+    /**
+     * @brief Decide what to do with an audio segment and count the decision.
+     *
+     * @param segmentAgeMs time since the plugin sent the segment
+     * @return SegmentAdmission the decision
+     */
+    SegmentAdmission admit(int64_t segmentAgeMs);
+
+    /**
+     * @brief Number of segments that were decimated since the last call.
+     */
+    uint64_t takeNoDecimatedSegments();
+
+    /**
+     * @brief Number of segments that were dropped since the last call.
+     */
+    uint64_t takeNoDroppedSegments();
+
+  private:
+    std::atomic<float> avgProcessingTimeMs;    /**< last average time between a segment send and its drawing */
+    std::atomic<float> drawingBacklog;         /**< last ratio of the ProcessingTimer waitgroups in use */
+    std::atomic<uint64_t> noDecimatedSegments; /**< segments decimated since the last take */
+    std::atomic<uint64_t> noDroppedSegments;   /**< segments dropped since the last take */
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+// Binary tags of the StationApp tasks recorded in task journals. They are stored in the
+// journal files, so a tag must never be renumbered or reused for another task class.
+
+/**< getBinaryTag of NewFftDataTask */
+#define NEW_FFT_DATA_TASK_BINARY_TAG 1
+
+/**< getBinaryTag of TrackInfoUpdateTask */
+#define TRACK_INFO_UPDATE_TASK_BINARY_TAG 2
+
+/**< getBinaryTag of BpmUpdateTask */
+#define BPM_UPDATE_TASK_BINARY_TAG 3
+
+/**< getBinaryTag of TimeSignatureUpdateTask */
+#define TIME_SIGNATURE_UPDATE_TASK_BINARY_TAG 4
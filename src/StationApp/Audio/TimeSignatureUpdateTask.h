@@ -1,6 +1,8 @@
 #pragma once
 
+#include "StationApp/Audio/TaskBinaryTags.h"
 #include "TaskManagement/Task.h"
+#include "TaskManagement/TaskBinaryStream.h"
 #include <nlohmann/json.hpp>
 
 class TimeSignatureUpdateTask : public SilentTask
@@ -25,5 +27,38 @@ class TimeSignatureUpdateTask : public SilentTask
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<TimeSignatureUpdateTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_UI;
+    }
+
+    uint64_t getCoalescingKey() override
+    {
+        return getTaskTypeIdOf<TimeSignatureUpdateTask>();
+    }
+
+    uint32_t getBinaryTag() override
+    {
+        return TIME_SIGNATURE_UPDATE_TASK_BINARY_TAG;
+    }
+
+    void serializeBinary(TaskBinaryWriter &writer) override
+    {
+        writer.write<int32_t>((int32_t)numerator);
+    }
+
+    /**
+     * @brief Recreate a task written by serializeBinary.
+     */
+    static std::shared_ptr<Task> decodeBinary(TaskBinaryReader &reader)
+    {
+        return std::make_shared<TimeSignatureUpdateTask>((int)reader.read<int32_t>());
+    }
+
     int numerator;
 };
\ No newline at end of file
@@ -33,6 +33,16 @@ class TrackColorUpdateTask : public SilentTask
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<TrackColorUpdateTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_UI;
+    }
+
     uint64_t identifier;
     uint8_t redColorLevel;
     uint8_t greenColorLevel;
@@ -12,6 +12,7 @@
 #include <stdexcept>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 class TrackInfoStore : public TaskListener
 {
@@ -20,9 +21,9 @@ class TrackInfoStore : public TaskListener
     {
     }
 
-    bool taskHandler(std::shared_ptr<Task> task)
+    bool taskHandler(std::shared_ptr<Task> task) override
     {
-        auto trackinfoUpdate = std::dynamic_pointer_cast<TrackInfoUpdateTask>(task);
+        auto trackinfoUpdate = taskCast<TrackInfoUpdateTask>(task);
         if (trackinfoUpdate != nullptr && !trackinfoUpdate->isCompleted() && !trackinfoUpdate->hasFailed())
         {
             {
@@ -68,6 +69,11 @@ class TrackInfoStore : public TaskListener
         return false;
     }
 
+    std::vector<TaskTypeId> getHandledTaskTypes() override
+    {
+        return {getTaskTypeIdOf<TrackInfoUpdateTask>()};
+    }
+
     std::optional<AudioTransport::ColorContainer> getTrackColor(uint64_t trackId)
     {
         if (colorsPerTrack.find(trackId) != colorsPerTrack.end())
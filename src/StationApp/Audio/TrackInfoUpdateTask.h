@@ -2,7 +2,9 @@
 
 #include <nlohmann/json.hpp>
 
+#include "StationApp/Audio/TaskBinaryTags.h"
 #include "TaskManagement/Task.h"
+#include "TaskManagement/TaskBinaryStream.h"
 
 class TrackInfoUpdateTask : public SilentTask
 {
@@ -35,6 +37,43 @@ class TrackInfoUpdateTask : public SilentTask
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<TrackInfoUpdateTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_UI;
+    }
+
+    uint32_t getBinaryTag() override
+    {
+        return TRACK_INFO_UPDATE_TASK_BINARY_TAG;
+    }
+
+    void serializeBinary(TaskBinaryWriter &writer) override
+    {
+        writer.write<uint64_t>(identifier);
+        writer.writeString(name);
+        writer.write<uint8_t>(redColorLevel);
+        writer.write<uint8_t>(greenColorLevel);
+        writer.write<uint8_t>(blueColorLevel);
+    }
+
+    /**
+     * @brief Recreate a task written by serializeBinary.
+     */
+    static std::shared_ptr<Task> decodeBinary(TaskBinaryReader &reader)
+    {
+        uint64_t trackId = reader.read<uint64_t>();
+        std::string trackName = reader.readString();
+        uint8_t red = reader.read<uint8_t>();
+        uint8_t green = reader.read<uint8_t>();
+        uint8_t blue = reader.read<uint8_t>();
+        return std::make_shared<TrackInfoUpdateTask>(trackId, trackName, red, green, blue);
+    }
+
     uint64_t identifier;
     std::string name;
     uint8_t redColorLevel;
@@ -27,5 +27,21 @@ class VolumeSensitivityTask : public SilentTask
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<VolumeSensitivityTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_UI;
+    }
+
+    // moving the slider must feel instant even when the DAW floods the ui lane
+    TaskPriority getTaskPriority() override
+    {
+        return TASK_PRIORITY_HIGH;
+    }
+
     float sensitivity;
 };
\ No newline at end of file
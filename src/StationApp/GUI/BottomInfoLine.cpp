@@ -52,7 +52,7 @@ void BottomInfoLine::paint(juce::Graphics &g)
 
 bool BottomInfoLine::taskHandler(std::shared_ptr<Task> task)
 {
-    auto cursorInfo = std::dynamic_pointer_cast<MouseCursorInfoTask>(task);
+    auto cursorInfo = taskCast<MouseCursorInfoTask>(task);
     if (cursorInfo != nullptr)
     {
         mouseOverSfftView = cursorInfo->cursorOnSfftView;
@@ -73,7 +73,7 @@ bool BottomInfoLine::taskHandler(std::shared_ptr<Task> task)
         }
     }
 
-    auto processingRateTask = std::dynamic_pointer_cast<ProcessingTimeUpdateTask>(task);
+    auto processingRateTask = taskCast<ProcessingTimeUpdateTask>(task);
     if (processingRateTask != nullptr)
     {
         averageSegmentProcessingTimeMs = processingRateTask->averageProcesingTimeMs;
@@ -95,6 +95,11 @@ bool BottomInfoLine::taskHandler(std::shared_ptr<Task> task)
     return false;
 }
 
+std::vector<TaskTypeId> BottomInfoLine::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<MouseCursorInfoTask>(), getTaskTypeIdOf<ProcessingTimeUpdateTask>()};
+}
+
 std::string BottomInfoLine::noteFromFreq(float freq)
 {
     float semiToneShiftFromA4 = 12.0f * std::log2(freq / 440);
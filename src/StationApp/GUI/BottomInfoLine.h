@@ -20,6 +20,11 @@ class BottomInfoLine : public juce::Component, public TaskListener
     void paint(juce::Graphics &g) override;
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
   private:
     std::string noteFromFreq(float freq);
 
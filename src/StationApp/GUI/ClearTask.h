@@ -22,4 +22,16 @@ class ClearTask : public Task
                                 {"is_part_of_reversion", isPartOfReversion}};
         return taskj.dump();
     }
+
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<ClearTask>();
+    }
+
+    TaskPriority getTaskPriority() override
+    {
+        // asked by the user, it does not need the queued control tasks to be handled first, and the
+        // NewFftDataTask it overtakes in the data lane are dropped by the clear epoch of FreqTimeView
+        return TASK_PRIORITY_HIGH;
+    }
 };
\ No newline at end of file
@@ -137,8 +137,9 @@ void CpuImageDrawingBackend::timerCallback()
 }
 
 void CpuImageDrawingBackend::drawFftOnTile(uint64_t trackIdentifier, int64_t secondTileIndex, int64_t begin,
-                                           int64_t end, int fftSize, float *data, int channel, uint32_t,
-                                           TaskingManager *, std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg)
+                                           int64_t end, int fftSize, float *data, bool displayResolution,
+                                           int channel, uint32_t, TaskingManager *,
+                                           std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg)
 {
     std::lock_guard lock(imageAccessMutex);
     // if the tile does not exists, create it
@@ -163,9 +164,12 @@ void CpuImageDrawingBackend::drawFftOnTile(uint64_t trackIdentifier, int64_t sec
         // iterate from center towards borders
         for (size_t verticalPos = 0; verticalPos < (SECOND_TILE_HEIGHT >> 1); verticalPos++)
         {
-            size_t frequencyBinIndex =
-                ((float(fftSize) * freqTransformer.transformInv(float(verticalPos) / float(SECOND_TILE_HEIGHT >> 1))) +
-                 0.5f);
+            size_t frequencyBinIndex = verticalPos;
+            if (!displayResolution)
+            {
+                float verticalRatio = float(verticalPos) / float(SECOND_TILE_HEIGHT >> 1);
+                frequencyBinIndex = ((float(fftSize) * freqTransformer.transformInv(verticalRatio)) + 0.5f);
+            }
             frequencyBinIndex = (size_t)juce::jlimit(0, fftSize - 1, (int)frequencyBinIndex);
             float intensityDb = data[frequencyBinIndex];
             float intensityNormalized = juce::jmap(intensityDb, MIN_DB, 0.0f, 0.0f, 1.0f);
@@ -97,12 +97,13 @@ class CpuImageDrawingBackend : public FftDrawingBackend, public juce::Timer
      * @param end end sample in the tile
      * @param fftSize number of frequency bins in the provided fft
      * @param data pointer to the floats containing fft bins intensities in decibels
+     * @param displayResolution true if data holds DISPLAY_RESOLUTION_NO_ROWS display rows instead of linear bins
      * @param channel 0 for left, 1 for right, 2 for both
      * @param sampleRate sample rate of the signal passed to FFT
      * @param procTimeWg waitgroup to count processing time (add already called on it so just have to reportCOmpletion)
      */
     void drawFftOnTile(uint64_t trackIdentifier, int64_t secondTileIndex, int64_t begin, int64_t end, int fftSize,
-                       float *data, int channel, uint32_t sampleRate, TaskingManager *tm,
+                       float *data, bool displayResolution, int channel, uint32_t sampleRate, TaskingManager *tm,
                        std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg) override;
 
     int64_t viewPosition; /**< Position of the view in samples */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "StationApp/Audio/AudioWorkersMetricsTask.h"
 #include "StationApp/Audio/NewFftDataTask.h"
 #include "StationApp/Audio/ProcessingTimerWaitgroup.h"
 #include "StationApp/Audio/TrackInfoStore.h"
@@ -91,13 +92,13 @@ class FftDrawingBackend : public juce::Component
     void displayNewFftData(std::shared_ptr<NewFftDataTask> fftData,
                            std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg)
     {
-        int fftSize = fftData->fftData->size() / fftData->noFFTs;
+        int fftSize = fftData->fftData.size() / fftData->noFFTs;
         int64_t fftSampleWidth = (int64_t)fftData->segmentSampleLength / (int64_t)fftData->noFFTs;
         // for each fft in the received set
         for (size_t i = 0; i < fftData->noFFTs; i++)
         {
             // pointer to the raw data for this fft
-            float *fftDataPointer = fftData->fftData->data() + ((size_t)fftSize * i);
+            float *fftDataPointer = fftData->fftData.data() + ((size_t)fftSize * i);
             // compute its position and tile index
             int64_t startSample = fftData->segmentStartSample + ((int64_t)i * fftSampleWidth);
             int64_t endSample = startSample + fftSampleWidth;
@@ -150,7 +151,8 @@ class FftDrawingBackend : public juce::Component
                 }
                 procTimeWg->add();
                 drawFftOnTile(fftData->trackIdentifier, j, tileStartSample, tileEndSample, fftSize, fftDataPointer,
-                              channelIndex, fftData->sampleRate, fftData->getTaskingManager(), procTimeWg);
+                              fftData->displayResolution, channelIndex, fftData->sampleRate,
+                              fftData->getTaskingManager(), procTimeWg);
             }
         }
     }
@@ -236,6 +238,15 @@ class FftDrawingBackend : public juce::Component
     {
     }
 
+    /**
+     * @brief Latest state of the audio ingest pipeline, for the backends that show it along their render stats.
+     *
+     * @param metrics the metrics periodically emitted by the audio data workers
+     */
+    virtual void setIngestMetrics(std::shared_ptr<AudioWorkersMetricsTask> metrics)
+    {
+    }
+
   protected:
     /**
      * @brief Draws the provided FFT (there's only one) on the TrackSecondTile;
@@ -246,6 +257,7 @@ class FftDrawingBackend : public juce::Component
      * @param end end sample in the tile
      * @param fftSize number of frequency bins in the provided fft
      * @param data pointer to the floats containing fft bins intensities in decibels
+     * @param displayResolution true if data holds DISPLAY_RESOLUTION_NO_ROWS display rows instead of linear bins
      * @param channel 0 for left, 1 for right, 2 for both
      * @param sampleRate sample rate of signal that was FFT'ed
      * @param tm a reference to the tasking manager so we trylock the message thread for repaint as long as it's not
@@ -253,8 +265,8 @@ class FftDrawingBackend : public juce::Component
      * @param procTimeWg a waitgroup to be used to notify when work is done, no need to call add, parent already did
      */
     virtual void drawFftOnTile(uint64_t trackIdentifier, int64_t secondTileIndex, int64_t begin, int64_t end,
-                               int fftSize, float *data, int channel, uint32_t sampleRate, TaskingManager *tm,
-                               std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg) = 0;
+                               int fftSize, float *data, bool displayResolution, int channel, uint32_t sampleRate,
+                               TaskingManager *tm, std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg) = 0;
 
     TrackInfoStore &trackInfoStore;
     NormalizedUnitTransformer &freqTransformer;
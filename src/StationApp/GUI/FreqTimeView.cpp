@@ -1,6 +1,7 @@
 #include "FreqTimeView.h"
+#include "StationApp/Audio/AudioWorkersMetricsTask.h"
 #include "StationApp/Audio/BpmUpdateTask.h"
-#include "StationApp/Audio/FftResultVectorReuseTask.h"
+#include "StationApp/Audio/DisplayRowsMapper.h"
 #include "StationApp/Audio/NewFftDataTask.h"
 #include "StationApp/Audio/ProcessingTimer.h"
 #include "StationApp/Audio/TimeSignatureUpdateTask.h"
@@ -41,8 +42,7 @@ FreqTimeView::FreqTimeView(TrackInfoStore &tis, TaskingManager &tm)
     // fftDrawBackend = std::make_shared<CpuImageDrawingBackend>(trackInfoStore);
     addAndMakeVisible(fftDrawBackend.get());
 
-    auto freqProjection = std::make_shared<Log10Projection>(0.005);
-    frequencyTransformer.setProjection(freqProjection);
+    frequencyTransformer.setProjection(DisplayRowsMapper::getDisplayFrequencyProjection());
 
     auto intensityProjection = std::make_shared<SigmoidProjection>(6.0f);
     intensityTransformer.setProjection(intensityProjection);
@@ -176,77 +176,81 @@ void FreqTimeView::timerCallback()
     timeScale.repaint();
 }
 
+void FreqTimeView::drawNewFftData(std::shared_ptr<NewFftDataTask> newFftDataTask)
+{
+    // create a segment processing time waitgroup and pass it to fft drawing backend
+    auto processingTimeWaitgroup = processingTimer.getNewProcessingTimerWaitgroup(newFftDataTask->sentTimeUnixMs);
+
+    // Only proceed if we have been able to get a preallocated processing timer.
+    // If not that means we are on overload.
+    if (processingTimeWaitgroup != nullptr)
+    {
+        processingTimeWaitgroup->add();
+
+        // if time since last drawing was too large, clear all past data
+        int64_t currentTime = juce::Time().getCurrentTime().toMilliseconds();
+
+        int64_t lastFftDrawTimeMsCopy = 0;
+        {
+            std::lock_guard lock(lastFftDrawTimeMutex);
+            lastFftDrawTimeMsCopy = lastFftDrawTimeMs;
+        }
+
+        if ((currentTime - lastFftDrawTimeMsCopy) > MAX_IDLE_MS_TIME_BEFORE_CLEAR)
+        {
+            fftDrawBackend->clearDisplayedFFTs();
+            trackList.clear();
+        }
+
+        // send fft data to drawing backend and update play cursor
+        fftDrawBackend->displayNewFftData(newFftDataTask, processingTimeWaitgroup);
+        fftDrawBackend->submitNewPlayCursorPosition((int64_t)newFftDataTask->segmentStartSample +
+                                                        (int64_t)newFftDataTask->segmentSampleLength,
+                                                    newFftDataTask->sampleRate);
+
+        // record which track is playing and where to display labels
+        trackList.recordSfft(newFftDataTask);
+
+        // record last drawing time
+        {
+            std::lock_guard lock(lastFftDrawTimeMutex);
+            lastFftDrawTimeMs = currentTime;
+        }
+
+        // complete first half of segment processing time waitgroup here
+        processingTimeWaitgroup->recordCompletion();
+    }
+    else
+    {
+        spdlog::warn("A FFT drawing was skipped because too much FFTs are pending drawing.");
+    }
+}
+
 bool FreqTimeView::taskHandler(std::shared_ptr<Task> task)
 {
-    auto newFftDataTask = std::dynamic_pointer_cast<NewFftDataTask>(task);
+    auto newFftDataTask = taskCast<NewFftDataTask>(task);
     if (newFftDataTask != nullptr && !newFftDataTask->isCompleted() && !newFftDataTask->hasFailed())
     {
 
-        // call on the drawing backend to add the FFT data to the displayed textures
+        // call on the drawing backend to add the FFT data to the displayed textures, unless a clear
+        // handled on the control lane overtook this segment that was sent before it
+        bool drawn = false;
         if (!newFftDataTask->skip)
         {
-            // create a segment processing time waitgroup and pass it to fft drawing backend
-            auto processingTimeWaitgroup =
-                processingTimer.getNewProcessingTimerWaitgroup(newFftDataTask->sentTimeUnixMs);
-
-            // Only proceed if we have been able to get a preallocated processing timer.
-            // If not that means we are on overload.
-            if (processingTimeWaitgroup != nullptr)
-            {
-                processingTimeWaitgroup->add();
-
-                // if time since last drawing was too large, clear all past data
-                int64_t currentTime = juce::Time().getCurrentTime().toMilliseconds();
-
-                int64_t lastFftDrawTimeMsCopy = 0;
-                {
-                    std::lock_guard lock(lastFftDrawTimeMutex);
-                    lastFftDrawTimeMsCopy = lastFftDrawTimeMs;
-                }
-
-                if ((currentTime - lastFftDrawTimeMsCopy) > MAX_IDLE_MS_TIME_BEFORE_CLEAR)
-                {
-                    fftDrawBackend->clearDisplayedFFTs();
-                    trackList.clear();
-                }
-
-                // send fft data to drawing backend and update play cursor
-                fftDrawBackend->displayNewFftData(newFftDataTask, processingTimeWaitgroup);
-                fftDrawBackend->submitNewPlayCursorPosition((int64_t)newFftDataTask->segmentStartSample +
-                                                                (int64_t)newFftDataTask->segmentSampleLength,
-                                                            newFftDataTask->sampleRate);
-
-                // record which track is playing and where to display labels
-                trackList.recordSfft(newFftDataTask);
-
-                // record last drawing time
-                {
-                    std::lock_guard lock(lastFftDrawTimeMutex);
-                    lastFftDrawTimeMs = currentTime;
-                }
-
-                // complete first half of segment processing time waitgroup here
-                processingTimeWaitgroup->recordCompletion();
-            }
-            else
-            {
-                spdlog::warn("A FFT drawing was skipped because too much FFTs are pending drawing.");
-            }
+            drawn = clearEpoch.runIfCurrent(newFftDataTask->sentTimeUnixMs,
+                                            [this, &newFftDataTask] { drawNewFftData(newFftDataTask); });
         }
-        else
+        if (!drawn)
         {
-            // if we skip displaying this fft, we still report the processing time
+            // if we skip or drop displaying this fft, we still report the processing time
             processingTimer.recordCompletion(-1, juce::Time::currentTimeMillis() - newFftDataTask->sentTimeUnixMs);
         }
 
-        auto reuseResultArrayTask = std::make_shared<FftResultVectorReuseTask>(newFftDataTask->fftData);
-        taskingManager.broadcastNestedTaskNow(reuseResultArrayTask);
-
         newFftDataTask->setCompleted(true);
         return false;
     }
 
-    auto colorUpdateTask = std::dynamic_pointer_cast<TrackColorUpdateTask>(task);
+    auto colorUpdateTask = taskCast<TrackColorUpdateTask>(task);
     if (colorUpdateTask != nullptr)
     {
         juce::Colour col(colorUpdateTask->redColorLevel, colorUpdateTask->greenColorLevel,
@@ -256,7 +260,7 @@ bool FreqTimeView::taskHandler(std::shared_ptr<Task> task)
         return true;
     }
 
-    auto bpmUpdateTask = std::dynamic_pointer_cast<BpmUpdateTask>(task);
+    auto bpmUpdateTask = taskCast<BpmUpdateTask>(task);
     if (bpmUpdateTask != nullptr && !bpmUpdateTask->isCompleted())
     {
         if (std::abs(lastReceivedBpm - bpmUpdateTask->bpm) >= std::numeric_limits<float>::epsilon())
@@ -269,7 +273,7 @@ bool FreqTimeView::taskHandler(std::shared_ptr<Task> task)
         return false;
     }
 
-    auto timeSignatureUpdate = std::dynamic_pointer_cast<TimeSignatureUpdateTask>(task);
+    auto timeSignatureUpdate = taskCast<TimeSignatureUpdateTask>(task);
     if (timeSignatureUpdate != nullptr && !timeSignatureUpdate->isCompleted())
     {
         fftDrawBackend->timeSignatureNumeratorUpdate(timeSignatureUpdate->numerator);
@@ -277,7 +281,7 @@ bool FreqTimeView::taskHandler(std::shared_ptr<Task> task)
         return false;
     }
 
-    auto selectionUpdate = std::dynamic_pointer_cast<TrackSelectionTask>(task);
+    auto selectionUpdate = taskCast<TrackSelectionTask>(task);
     if (selectionUpdate != nullptr && !selectionUpdate->isCompleted())
     {
         fftDrawBackend->setSelectedTrack(selectionUpdate->selectedTrack, selectionUpdate->getTaskingManager());
@@ -285,16 +289,27 @@ bool FreqTimeView::taskHandler(std::shared_ptr<Task> task)
         return false;
     }
 
-    auto clearTask = std::dynamic_pointer_cast<ClearTask>(task);
+    auto clearTask = taskCast<ClearTask>(task);
     if (clearTask != nullptr && !clearTask->isCompleted())
     {
-        fftDrawBackend->clearDisplayedFFTs();
-        trackList.clear();
+        // the segments sent before the clear and still queued in the data lane are dropped
+        clearEpoch.startNewEpoch(juce::Time::currentTimeMillis(), [this] {
+            fftDrawBackend->clearDisplayedFFTs();
+            trackList.clear();
+        });
         clearTask->setCompleted(true);
         return false;
     };
 
-    auto volumeSensitivityUpdateTask = std::dynamic_pointer_cast<VolumeSensitivityTask>(task);
+    auto metricsTask = taskCast<AudioWorkersMetricsTask>(task);
+    if (metricsTask != nullptr && !metricsTask->isCompleted())
+    {
+        fftDrawBackend->setIngestMetrics(metricsTask);
+        metricsTask->setCompleted(true);
+        return false;
+    }
+
+    auto volumeSensitivityUpdateTask = taskCast<VolumeSensitivityTask>(task);
     if (volumeSensitivityUpdateTask != nullptr && !volumeSensitivityUpdateTask->isCompleted())
     {
         auto intensityProjection = std::make_shared<SigmoidProjection>(volumeSensitivityUpdateTask->sensitivity);
@@ -307,6 +322,18 @@ bool FreqTimeView::taskHandler(std::shared_ptr<Task> task)
     return false;
 }
 
+std::vector<TaskTypeId> FreqTimeView::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<NewFftDataTask>(),
+            getTaskTypeIdOf<TrackColorUpdateTask>(),
+            getTaskTypeIdOf<BpmUpdateTask>(),
+            getTaskTypeIdOf<TimeSignatureUpdateTask>(),
+            getTaskTypeIdOf<TrackSelectionTask>(),
+            getTaskTypeIdOf<ClearTask>(),
+            getTaskTypeIdOf<VolumeSensitivityTask>(),
+            getTaskTypeIdOf<AudioWorkersMetricsTask>()};
+}
+
 void FreqTimeView::mouseDown(const juce::MouseEvent &e)
 {
     if (e.mods.isAnyMouseButtonDown())
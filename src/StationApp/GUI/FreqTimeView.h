@@ -7,11 +7,12 @@
 #include "StationApp/GUI/NormalizedUnitTransformer.h"
 #include "StationApp/GUI/TimeScale.h"
 #include "StationApp/GUI/TrackList.h"
+#include "TaskManagement/ClearEpoch.h"
 #include "TaskManagement/TaskListener.h"
 #include "TaskManagement/TaskingManager.h"
 #include "juce_gui_basics/juce_gui_basics.h"
 
-#define MAX_SCALE_SAMPLE_PER_PIXEL 400
+#define MAX_SCALE_SAMPLE_PER_PIXEL 12000
 #define MIN_SCALE_SAMPLE_PER_PIXEL 80
 #define PIXEL_SCALE_SPEED 0.01f
 #define MAX_IDLE_MS_TIME_BEFORE_CLEAR 2000
@@ -55,6 +56,11 @@ class FreqTimeView : public juce::Component, public TaskListener, public juce::T
      */
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
   private:
     /**
      * @brief Compute frequency and time under cursor and pass data to freqtime view and tip bar.
@@ -65,6 +71,14 @@ class FreqTimeView : public juce::Component, public TaskListener, public juce::T
 
     void emitMousePositionInfoTask(bool shouldShow, int x, int y);
 
+    /**
+     * @brief Draw the FFTs of a segment with the drawing backend, and record its track and play position.
+     * Called from the data lane, within the current clear epoch.
+     *
+     * @param newFftDataTask the task holding the FFTs of the segment
+     */
+    void drawNewFftData(std::shared_ptr<NewFftDataTask> newFftDataTask);
+
     TaskingManager &taskingManager;
     ProcessingTimer processingTimer;
 
@@ -75,6 +89,7 @@ class FreqTimeView : public juce::Component, public TaskListener, public juce::T
     int64_t lastMouseDragX, lastMouseDragY; /**< Last position of the mouse cursor at last drag iteration */
     int64_t lastFftDrawTimeMs;              /**< Last millisecond timestamp at when something was drawn */
     std::mutex lastFftDrawTimeMutex;
+    ClearEpoch clearEpoch; /**< Drops the segments sent before the last ClearTask, that the data lane may still hold */
 
     int64_t lastTimerCallMs; /**< time since last timer call */
 
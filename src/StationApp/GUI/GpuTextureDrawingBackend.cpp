@@ -1,5 +1,6 @@
 #include "GpuTextureDrawingBackend.h"
 #include "GUIToolkit/Consts.h"
+#include "StationApp/Audio/DisplayRowsMapper.h"
 #include "StationApp/Audio/ProcessingTimerWaitgroup.h"
 #include "StationApp/GUI/FftDrawingBackend.h"
 
@@ -7,8 +8,12 @@
 #include "StationApp/OpenGL/BeatGridMesh.h"
 #include "StationApp/OpenGL/GLInfoLogger.h"
 #include "TaskManagement/TaskingManager.h"
+#include "TileCacheConfig.h"
 #include "juce_graphics/juce_graphics.h"
 #include "juce_opengl/opengl/juce_gl.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -17,23 +22,45 @@
 #include <stdexcept>
 #include <string>
 
+static_assert(DISPLAY_RESOLUTION_NO_ROWS == (SECOND_TILE_HEIGHT >> 1), "display rows must fill half a tile");
+static_assert(DISPLAY_RESOLUTION_SAMPLE_RATE == VISUAL_SAMPLE_RATE, "display rows must use the visual sample rate");
+static_assert(SECOND_TILE_WIDTH % TILE_LOD_FACTOR == 0, "tiles must merge into whole columns of the next level");
+
 GpuTextureDrawingBackend::GpuTextureDrawingBackend(TrackInfoStore &tis, NormalizedUnitTransformer &ft,
                                                    NormalizedUnitTransformer &it)
-    : FftDrawingBackend(tis, ft, it), tmpFreqTransformer(ft), tmpIntensityTransformer(it), timeSignatureGrid(false),
-      topBeatGrid(true), ignoreNewData(true), viewPosition(0), viewScale(150), convolutionId(GpuConvolutionId::Emboss),
-      bpm(120), needToResetTiles(false)
+    : FftDrawingBackend(tis, ft, it), tmpFreqTransformer(ft), tmpIntensityTransformer(it),
+      tileCacheConfig(TileCacheConfig::load()),
+      tileCacheSize(tileCacheConfig.getNoTiles(SECOND_TILE_WIDTH * SECOND_TILE_HEIGHT * sizeof(TileTexel),
+                                               TILE_LOD_LEVELS * sizeof(int32_t))),
+      trackTilesIndexSize(tileCacheSize), tileTextures(SECOND_TILE_WIDTH, SECOND_TILE_HEIGHT, tileCacheSize),
+      tilesUsage(tileCacheSize), timeSignatureGrid(false), topBeatGrid(true),
+      ignoreNewData(true), viewPosition(0), viewScale(150), viewHeight(0), viewWidth(0),
+      convolutionId(GpuConvolutionId::Emboss), bpm(120), frameUploadedBytes(0), lastFrameUploadedBytes(0)
 {
     timeSignature = 4;
     lastAppliedTimeSignature = 4;
     backgroundColor = KHOLORS_COLOR_BACKGROUND;
     openGLContext.setRenderer(this);
     openGLContext.attachTo(*this);
-    secondTileNextIndex = 0;
     mouseOnComponent = false;
     lastMouseX = 0;
     lastMouseY = 0;
-    lastTrackDrawOrderNonce = 0;
     trackDrawOrderNonce = 1;
+    lastInstancesDrawOrderNonce = 0;
+    lastInstancesLevel = 0;
+    lastFrameStats = {0.0f, -1.0f, 0, 0};
+    updateLookupTextures(true);
+    spdlog::info("Spectrogram tile cache holds {} tiles of all levels of detail", tileCacheSize);
+    // a track slot is only used by tracks having at least a tile, so there are as many as tiles
+    secondTilesRingBuffer.reserve(tileCacheSize);
+    trackTiles.resize(tileCacheSize);
+    trackSlotByIdentifier.reserve(tileCacheSize);
+    trackSlotsInDrawingOrder.reserve(tileCacheSize);
+    freeTrackSlots.reserve(tileCacheSize);
+    for (size_t i = 0; i < tileCacheSize; i++)
+    {
+        freeTrackSlots.push_back(tileCacheSize - 1 - i);
+    }
 }
 
 GpuTextureDrawingBackend::~GpuTextureDrawingBackend()
@@ -78,6 +105,10 @@ void GpuTextureDrawingBackend::paint(juce::Graphics &g)
 void GpuTextureDrawingBackend::paintOverChildren(juce::Graphics &g)
 {
     drawBorders(g);
+    if (tileCacheConfig.showRenderStats)
+    {
+        drawRenderStats(g);
+    }
 }
 
 void GpuTextureDrawingBackend::drawBorders(juce::Graphics &g)
@@ -142,6 +173,39 @@ void GpuTextureDrawingBackend::drawBorders(juce::Graphics &g)
     g.fillRect(middleLine);
 }
 
+void GpuTextureDrawingBackend::drawRenderStats(juce::Graphics &g)
+{
+    RenderStats stats;
+    std::shared_ptr<AudioWorkersMetricsTask> ingest;
+    {
+        std::lock_guard lock(renderStatsMutex);
+        stats = lastFrameStats;
+        ingest = lastIngestMetrics;
+    }
+    juce::String text = "CPU " + juce::String(stats.cpuFrameMs, 2) + " ms   GPU ";
+    text += stats.gpuFrameMs < 0.0f ? juce::String("-") : juce::String(stats.gpuFrameMs, 2) + " ms";
+    text += "   upload " + juce::String((double)stats.uploadedBytes / 1024.0, 1) + " KB   pending " +
+            juce::String((juce::int64)stats.pendingTiles) + " tiles";
+    if (ingest != nullptr)
+    {
+        text += "\naudio " + juce::String((juce::int64)ingest->noActiveWorkers) + " workers   queue " +
+                juce::String((juce::int64)ingest->maxQueueDepth) + "   wait " +
+                juce::String(ingest->avgQueueLatencyMs, 2) + " ms   analysis " +
+                juce::String(ingest->avgAnalysisLatencyMs, 2) + " ms   decimated " +
+                juce::String((juce::int64)ingest->noDecimatedSegments) + "   dropped " +
+                juce::String((juce::int64)ingest->noDroppedSegments);
+    }
+
+    // the text is drawn over its shadow to stay readable over the spectrogram
+    auto area = getLocalBounds().reduced(FREQVIEW_BORDER_WIDTH + FREQVIEW_ROUNDED_CORNERS_WIDTH);
+    g.setFont(juce::Font(KHOLORS_DEFAULT_FONT_SIZE));
+    g.setColour(backgroundColor);
+    g.drawMultiLineText(text, area.getX() + 1, area.getY() + 1 + (int)g.getCurrentFont().getAscent(),
+                        area.getWidth());
+    g.setColour(KHOLORS_COLOR_WHITE);
+    g.drawMultiLineText(text, area.getX(), area.getY() + (int)g.getCurrentFont().getAscent(), area.getWidth());
+}
+
 void GpuTextureDrawingBackend::resized()
 {
     freqLines.setBounds(getLocalBounds());
@@ -212,6 +276,9 @@ void GpuTextureDrawingBackend::newOpenGLContextCreated()
 
         texturedPositionedShader->use();
         texturedPositionedShader->setUniform("sfftTexture", 0);
+        texturedPositionedShader->setUniform("trackColors", TILE_TRACK_COLORS_TEXTURE_UNIT);
+        texturedPositionedShader->setUniform("intensityCurve", TILE_INTENSITY_CURVE_TEXTURE_UNIT);
+        texturedPositionedShader->setUniform("frequencyMap", TILE_FREQUENCY_MAP_TEXTURE_UNIT);
 
         uploadShadersUniforms();
 
@@ -223,13 +290,24 @@ void GpuTextureDrawingBackend::newOpenGLContextCreated()
 
         // load tiles textures
         texturedPositionedShader->use();
+        tileTextures.registerGlObjects();
+        gpuFrameTimer.registerGlObjects();
+        std::lock_guard lock(tilesMutex);
+        if (tileTextures.getNoLayers() < tileCacheSize)
+        {
+            spdlog::warn("Limiting the spectrogram tile cache to the {} texture array layers of the GPU",
+                         tileTextures.getNoLayers());
+            limitTileCacheSize(tileTextures.getNoLayers());
+        }
         for (size_t i = 0; i < secondTilesRingBuffer.size(); i++)
         {
             if (secondTilesRingBuffer[i].tileIndexPosition >= 0)
             {
-                secondTilesRingBuffer[i].mesh->registerGlObjects();
+                secondTilesRingBuffer[i].texture->markAllColumnsChanged();
+                tileTextures.uploadTile(i, *secondTilesRingBuffer[i].texture);
             }
         }
+        tilesToUploadFirst.clear();
 
         spdlog::debug("Tiles textures loaded");
     }
@@ -287,89 +365,47 @@ void GpuTextureDrawingBackend::uploadShadersUniforms()
 
 void GpuTextureDrawingBackend::renderOpenGL()
 {
-    // if necessary, clear all tiles first
-    {
-        std::lock_guard lock(tilesResetMutex);
-        if (needToResetTiles)
-        {
-            {
-                // clear the queues of track ranges to clear as
-                // everything will be cleared in other components anyway
-                // when a full clearing is performed here
-                std::lock_guard lock2(clearedRangesMutex);
-                while (clearedRanges.size() > 0)
-                {
-                    clearedRanges.pop();
-                }
-            }
-
-            for (size_t i = 0; i < secondTilesRingBuffer.size(); i++)
-            {
-                if (secondTilesRingBuffer[i].tileIndexPosition >= 0)
-                {
-                    secondTilesRingBuffer[i].mesh->clearAllData();
-                    secondTilesRingBuffer[i].mesh->refreshGpuTextureIfChanged();
-                }
-            }
-            needToResetTiles = false;
-        }
-    }
+    auto frameStart = std::chrono::steady_clock::now();
+    frameUploadedBytes = 0;
+    gpuFrameTimer.beginFrame();
 
-    // process queue of ffts to draw inside tiles
-    std::vector<std::shared_ptr<FftToDraw>> currentFftsToDraw;
+    // the workers write the ffts in the tiles memory, this thread only uploads what changed
+    size_t pendingTiles;
     {
-        std::lock_guard lock(fftsToDrawMutex);
-        while (fftsToDrawQueue.size() > 0)
+        std::lock_guard lock(tilesMutex);
+
+        // new, recycled or cleared tiles replace the texels of their layer before being drawn
+        for (size_t i = 0; i < tilesToUploadFirst.size(); i++)
         {
-            currentFftsToDraw.push_back(fftsToDrawQueue.front());
-            fftsToDrawQueue.pop();
+            size_t tileIndex = tilesToUploadFirst[i];
+            frameUploadedBytes += tileTextures.uploadTile(tileIndex, *secondTilesRingBuffer[tileIndex].texture);
+            takeDrawnWaitgroups(tileIndex);
         }
-    }
-    for (size_t i = 0; i < currentFftsToDraw.size(); i++)
-    {
-        drawFftOnOpenGlThread(currentFftsToDraw[i]);
+        tilesToUploadFirst.clear();
+
+        // upload the changed columns of the tiles in the order they changed, at least one tile per frame and
+        // then as many as the budget allows, the tiles left being the first ones uploaded with the next frame
+        auto uploadDeadline =
+            std::chrono::steady_clock::now() + std::chrono::microseconds(tileCacheConfig.uploadBudgetUs);
+        size_t uploadedTiles = 0;
+        while (changedTiles.size() > 0 && (uploadedTiles == 0 || std::chrono::steady_clock::now() < uploadDeadline))
         {
-            std::lock_guard lock(idleFftToDrawStructMutex);
-            idleFftToDrawStructs.push(currentFftsToDraw[i]);
+            size_t tileIndex = changedTiles.front();
+            changedTiles.pop();
+            secondTilesRingBuffer[tileIndex].queuedForUpload = false;
+            frameUploadedBytes += tileTextures.uploadTile(tileIndex, *secondTilesRingBuffer[tileIndex].texture);
+            takeDrawnWaitgroups(tileIndex);
+            uploadedTiles++;
         }
-    }
+        pendingTiles = changedTiles.size();
 
-    // upload texture that changed, but only half of the time
-    if (renderOpenGlIter % 5 == 0)
-    {
-        for (size_t i = 0; i < secondTilesRingBuffer.size(); i++)
-        {
-            secondTilesRingBuffer[i].mesh->refreshGpuTextureIfChanged();
-        }
+        tileTextures.uploadTrackColors();
     }
-    renderOpenGlIter++;
+    completeUploadedWaitgroups();
+    lastFrameUploadedBytes = frameUploadedBytes;
 
-    // apply color updates
-    std::vector<std::pair<uint64_t, juce::Colour>> colorUpdates;
-    {
-        std::lock_guard lock(openGlThreadColorsMutex);
-        while (colorUpdatesToApply.size() > 0)
-        {
-            colorUpdates.push_back(colorUpdatesToApply.front());
-            colorUpdatesToApply.pop();
-        }
-    }
-    // for each color update to apply, check if indeed is new and apply to all track tiles
-    for (size_t i = 0; i < colorUpdates.size(); i++)
-    {
-        auto existingTrackColor = knownTrackColors.find(colorUpdates[i].first);
-        if (existingTrackColor == knownTrackColors.end() || existingTrackColor->second != colorUpdates[i].second)
-        {
-            knownTrackColors[colorUpdates[i].first] = colorUpdates[i].second;
-            for (size_t j = 0; j < secondTilesRingBuffer.size(); j++)
-            {
-                if (secondTilesRingBuffer[j].trackIdentifer == colorUpdates[i].first)
-                {
-                    secondTilesRingBuffer[j].mesh->changeColor(colorUpdates[i].second);
-                }
-            }
-        }
-    }
+    // apply the sensitivity and frequency scale to all the tiles at once
+    updateLookupTextures(false);
 
     // update GLSL uniforms if necessary (component height, view position or zoom) updates
     uploadShadersUniforms();
@@ -399,7 +435,7 @@ void GpuTextureDrawingBackend::renderOpenGL()
         lastAppliedTimeSignature = newTimeSignature;
     }
 
-    int viewScaleCopy;
+    int64_t viewScaleCopy;
     {
         std::lock_guard lock(glThreadUniformsMutex);
         viewScaleCopy = viewScale;
@@ -418,320 +454,547 @@ void GpuTextureDrawingBackend::renderOpenGL()
     // draw tiles with FFTs
     texturedPositionedShader->use();
 
-    ensureTrackTilesDrawOrderIsUpToDate();
-
-    for (size_t i = 0; i < trackTilesDrawOrder.size(); i++)
+    // all the tiles of the level of detail matching the zoom are drawn at once as instances, in the track
+    // drawing order, which are only uploaded again when tiles are created or recycled or when the selection
+    // or the level changes
+    size_t level = getLevelOfDetail(viewScaleCopy);
+    std::unique_lock tilesLock(tilesMutex);
+    if (lastInstancesDrawOrderNonce != trackDrawOrderNonce || lastInstancesSelection != selection ||
+        lastInstancesLevel != level)
     {
-        if (secondTilesRingBuffer[trackTilesDrawOrder[i]].tileIndexPosition >= 0 &&
-            (selection == std::nullopt ||
-             selection.value() == secondTilesRingBuffer[trackTilesDrawOrder[i]].trackIdentifer))
+        tileTextures.clearInstances();
+        for (size_t i = 0; i < trackSlotsInDrawingOrder.size(); i++)
         {
-            secondTilesRingBuffer[trackTilesDrawOrder[i]].mesh->drawGlObjects();
+            TrackTiles &track = trackTiles[trackSlotsInDrawingOrder[i]];
+            if (selection != std::nullopt && selection.value() != track.trackIdentifier)
+            {
+                continue;
+            }
+            for (size_t j = 0; j < track.tiles.size(); j++)
+            {
+                TrackSecondTile &tile = secondTilesRingBuffer[track.tiles[j]];
+                if (tile.level != level)
+                {
+                    continue;
+                }
+                tileTextures.addInstance(track.tiles[j], tile.samplePosition, tile.sampleLength, tile.trackIdentifer,
+                                         tile.trackSlot);
+            }
         }
+        lastInstancesDrawOrderNonce = trackDrawOrderNonce;
+        lastInstancesSelection = selection;
+        lastInstancesLevel = level;
     }
+    tilesLock.unlock();
+    tileTextures.drawGlObjects();
+
+    gpuFrameTimer.endFrame();
+
+    std::lock_guard statsLock(renderStatsMutex);
+    lastFrameStats.cpuFrameMs =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+    lastFrameStats.gpuFrameMs = gpuFrameTimer.getLastFrameMs();
+    lastFrameStats.uploadedBytes = frameUploadedBytes;
+    lastFrameStats.pendingTiles = pendingTiles;
 }
 
 void GpuTextureDrawingBackend::setTrackColor(uint64_t trackIdentifier, juce::Colour col)
 {
-    std::pair<uint64_t, juce::Colour> colorToPush(trackIdentifier, col);
-    std::lock_guard lock(openGlThreadColorsMutex);
-    colorUpdatesToApply.push(colorToPush);
+    std::lock_guard lock(tilesMutex);
+    auto existingTrackColor = knownTrackColors.find(trackIdentifier);
+    if (existingTrackColor != knownTrackColors.end() && existingTrackColor->second == col)
+    {
+        return;
+    }
+    knownTrackColors[trackIdentifier] = col;
+    auto trackSlot = trackSlotByIdentifier.find(trackIdentifier);
+    if (trackSlot != trackSlotByIdentifier.end())
+    {
+        tileTextures.setTrackColor(trackSlot->second, col);
+    }
 }
 
 void GpuTextureDrawingBackend::clearDisplayedFFTs()
 {
-    std::lock_guard lock(tilesResetMutex);
-    needToResetTiles = true;
+    std::lock_guard lock(tilesMutex);
+    // the tracks are removed along their tiles, which frees their track slots and indices
+    for (size_t i = 0; i < secondTilesRingBuffer.size(); i++)
+    {
+        if (secondTilesRingBuffer[i].tileIndexPosition >= 0)
+        {
+            recycleTile(i);
+            tilesToUploadFirst.push_back(i);
+        }
+    }
+
+    {
+        // clear the queues of track ranges to clear as
+        // everything will be cleared in other components anyway
+        // when a full clearing is performed here
+        std::lock_guard lock2(clearedRangesMutex);
+        while (clearedRanges.size() > 0)
+        {
+            clearedRanges.pop();
+        }
+    }
 }
 
 void GpuTextureDrawingBackend::openGLContextClosing()
 {
-    for (size_t i = 0; i < secondTilesRingBuffer.size(); i++)
-    {
-        secondTilesRingBuffer[i].mesh->freeGlObjects();
-    }
+    tileTextures.freeGlObjects();
+    gpuFrameTimer.freeGlObjects();
     timeSignatureGrid.freeGlObjects();
     topBeatGrid.freeGlObjects();
     backgroundGridShader->release();
     texturedPositionedShader->release();
-    ignoreNewData = true;
-}
-
-void GpuTextureDrawingBackend::drawFftOnTile(uint64_t trackIdentifier, int64_t secondTileIndex, int64_t begin,
-                                             int64_t end, int fftSize, float *data, int channel, uint32_t sampleRate,
-                                             TaskingManager *, std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg)
-{
-
-    // either allocate or pick idle FftToDraw struct
-    std::shared_ptr<FftToDraw> newFftToDraw;
     {
-        std::lock_guard lock(idleFftToDrawStructMutex);
-        if (idleFftToDrawStructs.size() == 0)
-        {
-            newFftToDraw = std::make_shared<FftToDraw>();
-        }
-        else
+        // no tile is uploaded until a new context is created, so the drawings waiting for it are done
+        std::lock_guard lock(tilesMutex);
+        ignoreNewData = true;
+        for (size_t i = 0; i < secondTilesRingBuffer.size(); i++)
         {
-            newFftToDraw = idleFftToDrawStructs.front();
-            idleFftToDrawStructs.pop();
+            takeDrawnWaitgroups(i);
         }
     }
+    completeUploadedWaitgroups();
+}
 
-    // set the data of the FFT to draw
-    newFftToDraw->repurpose(trackIdentifier, secondTileIndex, begin, end, fftSize, data, channel, sampleRate,
-                            procTimeWg);
+void GpuTextureDrawingBackend::takeDrawnWaitgroups(size_t tileRingBufferIndex)
+{
+    auto &drawnWaitgroups = secondTilesRingBuffer[tileRingBufferIndex].drawnWaitgroups;
+    uploadedWaitgroups.insert(uploadedWaitgroups.end(), drawnWaitgroups.begin(), drawnWaitgroups.end());
+    drawnWaitgroups.clear();
+}
 
-    // push to the queue of FFT to draw for the openGL thread to pick it
+void GpuTextureDrawingBackend::completeUploadedWaitgroups()
+{
+    for (size_t i = 0; i < uploadedWaitgroups.size(); i++)
     {
-        std::lock_guard lock(fftsToDrawMutex);
-        fftsToDrawQueue.push(newFftToDraw);
+        uploadedWaitgroups[i]->recordCompletion();
     }
+    uploadedWaitgroups.clear();
 }
 
-void GpuTextureDrawingBackend::drawFftOnOpenGlThread(std::shared_ptr<FftToDraw> fftData)
+void GpuTextureDrawingBackend::drawFftOnTile(uint64_t trackIdentifier, int64_t secondTileIndex, int64_t begin,
+                                             int64_t end, int fftSize, float *data, bool displayResolution,
+                                             int channel, uint32_t sampleRate, TaskingManager *,
+                                             std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg)
 {
-    // if necessary, update the frequency transformers
-    if (tmpFreqTransformer.getNonce() != freqTransformer.getNonce())
-    {
-        tmpFreqTransformer.copyTransformer(freqTransformer);
-    }
-    if (tmpIntensityTransformer.getNonce() != intensityTransformer.getNonce())
+    if (ignoreNewData)
     {
-        tmpIntensityTransformer.copyTransformer(intensityTransformer);
+        procTimeWg->recordCompletion();
+        return;
     }
 
-    // if the tile does not exists, create it
-    size_t tileToDrawIn;
-    auto existingTrackTile = getTileIndexIfExists(fftData->trackIdentifier, fftData->secondTileIndex);
-    if (existingTrackTile >= 0)
+    float startSecond = (float(begin) / float(VISUAL_SAMPLE_RATE));
+    float endSecond = (float(end) / float(VISUAL_SAMPLE_RATE));
+    size_t startPixel = (size_t)juce::jlimit(0, SECOND_TILE_WIDTH - 1, (int)(startSecond * float(SECOND_TILE_WIDTH)));
+    size_t endPixel = (size_t)juce::jlimit(0, SECOND_TILE_WIDTH - 1, (int)(endSecond * float(SECOND_TILE_WIDTH)));
+
+    // display resolution data already has one value per row, on the frequency axis of the tiles,
+    // and linear bins are mapped to the tile rows the same way the workers map display resolution ones,
+    // which also adjusts the frequency bin fetching to potentially different sample rates
+    std::array<float, DISPLAY_RESOLUTION_NO_ROWS> intensities;
+    if (displayResolution)
     {
-        tileToDrawIn = (size_t)existingTrackTile;
+        std::copy(data, data + DISPLAY_RESOLUTION_NO_ROWS, intensities.begin());
     }
     else
     {
-        tileToDrawIn = createSecondTile(fftData->trackIdentifier, fftData->secondTileIndex);
+        thread_local DisplayRowsMapper rowsMapper;
+        rowsMapper.prepare(*DisplayRowsMapper::getDisplayFrequencyProjection(), sampleRate, (size_t)fftSize);
+        rowsMapper.project(data, intensities.data(), MIN_DB);
     }
-    // we need to correct frequencies if the sample rates differs
-    float sampleRateRatio = 1.0f;
-    if (fftData->sampleRate != VISUAL_SAMPLE_RATE)
+
+    // the tiles keep the decibels, the shader applies the sensitivity
+    for (size_t i = 0; i < intensities.size(); i++)
     {
-        sampleRateRatio = float(fftData->sampleRate) / float(VISUAL_SAMPLE_RATE);
+        intensities[i] = (-MIN_DB + intensities[i]) / (-MIN_DB);
     }
-    // draw the fft inside the tile
-    float startSecond = (float(fftData->begin) / float(VISUAL_SAMPLE_RATE));
-    float endSecond = (float(fftData->end) / float(VISUAL_SAMPLE_RATE));
-    size_t startPixel = (size_t)juce::jlimit(0, SECOND_TILE_WIDTH - 1, (int)(startSecond * float(SECOND_TILE_WIDTH)));
-    size_t endPixel = (size_t)juce::jlimit(0, SECOND_TILE_WIDTH - 1, (int)(endSecond * float(SECOND_TILE_WIDTH)));
-
-    // it is necessary to adjust the frequency bin fetching to potentially different sample rates
-    float rateAdjustedNoFreqBins = float(fftData->fftData.size()) / sampleRateRatio;
-
-    size_t halfTileHeight = (SECOND_TILE_HEIGHT >> 1);
-    float floatHalfTileHeight = float(halfTileHeight);
 
-    float verticalPosStrafe = 1.0f / (floatHalfTileHeight - 1.0f);
-
-    fftIntensitiesBuffer.reserve(halfTileHeight);
-    float *baseIntensitiesPointer = fftIntensitiesBuffer.data();
-    float *nextIntensityToWrite = baseIntensitiesPointer;
-
-    float vposFloat = 0.0f;
-    // iterate from center towards borders
-    for (size_t verticalPos = 0; verticalPos < halfTileHeight; verticalPos++)
     {
-        size_t frequencyBinIndex = rateAdjustedNoFreqBins * tmpFreqTransformer.transformInv(vposFloat);
-        vposFloat += verticalPosStrafe;
-
-        float intensityDb;
-        if (frequencyBinIndex < 0 || frequencyBinIndex >= fftData->fftData.size())
+        std::lock_guard lock(tilesMutex);
+        // the openGL context may have closed while the rows were computed
+        if (ignoreNewData)
         {
-            intensityDb = MIN_DB;
+            procTimeWg->recordCompletion();
         }
         else
         {
-            intensityDb = fftData->fftData[frequencyBinIndex];
+            // if the tile does not exists, create it
+            size_t tileToDrawIn;
+            auto existingTrackTile = getTileIndexIfExists(trackIdentifier, 0, secondTileIndex);
+            if (existingTrackTile >= 0)
+            {
+                tileToDrawIn = (size_t)existingTrackTile;
+            }
+            else
+            {
+                tileToDrawIn = createSecondTile(trackIdentifier, 0, secondTileIndex);
+            }
+            tilesUsage.markUsed(tileToDrawIn);
+            secondTilesRingBuffer[tileToDrawIn].texture->setRepeatedVerticalHalfLine(channel, startPixel, endPixel,
+                                                                                     intensities.data());
+            markTileChanged(tileToDrawIn);
+            updateLevelsOfDetail(tileToDrawIn, startPixel, endPixel);
+
+            // the drawing is only on screen, and its processing time complete, once the tile is uploaded
+            secondTilesRingBuffer[tileToDrawIn].drawnWaitgroups.push_back(procTimeWg);
         }
-
-        float intensityNormalized = (-MIN_DB + intensityDb) / (-MIN_DB);
-        intensityNormalized = tmpIntensityTransformer.transform(intensityNormalized);
-
-        *nextIntensityToWrite = intensityNormalized;
-        nextIntensityToWrite++;
     }
-
-    if (!ignoreNewData)
-    {
-        secondTilesRingBuffer[tileToDrawIn].mesh->setRepeatedVerticalHalfLine(fftData->channel, startPixel, endPixel,
-                                                                              baseIntensitiesPointer);
-    }
-
-    fftData->procTimeWg->recordCompletion();
 }
 
-int64_t GpuTextureDrawingBackend::getTileIndexIfExists(uint64_t trackIdentifier, int64_t secondTileIndex)
+int64_t GpuTextureDrawingBackend::getTileIndexIfExists(uint64_t trackIdentifier, size_t level, int64_t levelTileIndex)
 {
     if (ignoreNewData)
     {
         return -1;
     }
-    auto searchTerms = std::pair<uint64_t, int64_t>(trackIdentifier, secondTileIndex);
-    auto tileSearched = tileIndexByTrackIdAndPosition.find(searchTerms);
-    if (tileSearched != tileIndexByTrackIdAndPosition.end())
+    auto trackSlot = trackSlotByIdentifier.find(trackIdentifier);
+    if (trackSlot == trackSlotByIdentifier.end())
     {
-        return (int64_t)tileSearched->second;
+        return -1;
     }
-    else
+    // the index entry may hold a tile of the track at another position with the same index position
+    int64_t tileIndex =
+        trackTiles[trackSlot->second].tileByPosition[level][getTrackTilesIndexPosition(levelTileIndex)];
+    if (tileIndex >= 0 && secondTilesRingBuffer[(size_t)tileIndex].tileIndexPosition == levelTileIndex)
     {
-        return -1;
+        return tileIndex;
     }
+    return -1;
 }
 
-size_t GpuTextureDrawingBackend::createSecondTile(uint64_t trackIdentifier, int64_t secondTileIndex)
+size_t GpuTextureDrawingBackend::createSecondTile(uint64_t trackIdentifier, size_t level, int64_t levelTileIndex)
 {
     // if we're aborting, it doesn't really matter which id we return as we will ignore writing
     if (ignoreNewData)
     {
         return 0;
     }
+    // a tile of the track that uses the same index entry has to be replaced by the new one
+    int64_t collidingTileIndex = -1;
+    auto trackSlot = trackSlotByIdentifier.find(trackIdentifier);
+    if (trackSlot != trackSlotByIdentifier.end())
+    {
+        collidingTileIndex =
+            trackTiles[trackSlot->second].tileByPosition[level][getTrackTilesIndexPosition(levelTileIndex)];
+    }
     // throw invalid argument error if the tile already exist at that position for this track
-    auto existingTile =
-        tileIndexByTrackIdAndPosition.find(std::pair<uint64_t, int64_t>(trackIdentifier, secondTileIndex));
-    if (existingTile != tileIndexByTrackIdAndPosition.end())
+    if (collidingTileIndex >= 0 &&
+        secondTilesRingBuffer[(size_t)collidingTileIndex].tileIndexPosition == levelTileIndex)
     {
         throw std::invalid_argument("called createSecondTile for an already existing tile");
     }
     size_t newTileIndex;
-    // if the ring buffer is not full, expand it with a new datum, clear it and return it
-    if (secondTilesRingBuffer.size() < IMAGES_RING_BUFFER_SIZE)
+    if (collidingTileIndex >= 0)
+    {
+        newTileIndex = (size_t)collidingTileIndex;
+        recycleTile(newTileIndex);
+    }
+    // if the cache is not full, expand it with a new tile
+    else if (secondTilesRingBuffer.size() < tileCacheSize)
     {
+        newTileIndex = secondTilesRingBuffer.size();
         secondTilesRingBuffer.emplace_back();
-        if (secondTilesRingBuffer.size() - 1 != secondTileNextIndex)
-        {
-            throw std::runtime_error(
-                "expanding secondTilesRingBuffer but secondTileNextIndex does not match vector size");
-        }
-        newTileIndex = secondTileNextIndex;
-        // register the vertice, textures and triangle ids against openGL
-        secondTilesRingBuffer[newTileIndex].mesh->registerGlObjects();
     }
-    // if the ring buffer is full, remove nextItem, clear its index and replace it with cleared one before returning
-    // it
+    // if the cache is full, evict the least recently used tile, preferably one out of view
     else
     {
-        newTileIndex = secondTileNextIndex;
-        // remove the indexing by track id and position for the previous tile
-        tileIndexByTrackIdAndPosition.erase(std::pair<uint64_t, int64_t>(
-            secondTilesRingBuffer[newTileIndex].trackIdentifer, secondTilesRingBuffer[newTileIndex].tileIndexPosition));
-        // notify FreqView that a range was cleared for a track
-        // in order for related components to keep up with what's on screen
+        newTileIndex = getTileToEvict();
+        recycleTile(newTileIndex);
+    }
+    // replace whatever the layer of the texture array holds with the cleared texture before it is drawn
+    tilesToUploadFirst.push_back(newTileIndex);
+
+    // initialize the new tile metadata and tracking in its track tiles
+    int64_t levelTileSeconds = 1;
+    for (size_t i = 0; i < level; i++)
+    {
+        levelTileSeconds *= TILE_LOD_FACTOR;
+    }
+    secondTilesRingBuffer[newTileIndex].level = level;
+    secondTilesRingBuffer[newTileIndex].tileIndexPosition = levelTileIndex;
+    secondTilesRingBuffer[newTileIndex].sampleLength = levelTileSeconds * VISUAL_SAMPLE_RATE;
+    secondTilesRingBuffer[newTileIndex].samplePosition = levelTileIndex * levelTileSeconds * VISUAL_SAMPLE_RATE;
+    secondTilesRingBuffer[newTileIndex].trackIdentifer = trackIdentifier;
+    addTileToTrackTiles(newTileIndex);
+    tilesUsage.markUsed(newTileIndex);
+    return newTileIndex;
+}
+
+void GpuTextureDrawingBackend::recycleTile(size_t tileRingBufferIndex)
+{
+    TrackSecondTile &tile = secondTilesRingBuffer[tileRingBufferIndex];
+    // a tile freed by a clear has no track anymore
+    if (tile.tileIndexPosition < 0)
+    {
+        return;
+    }
+    // notify FreqView that a range was cleared for a track
+    // in order for related components to keep up with what's on screen,
+    // which only follow the one second tiles
+    if (tile.level == 0)
+    {
         ClearTrackInfoRange clearedRange;
-        clearedRange.startSample = VISUAL_SAMPLE_RATE * secondTilesRingBuffer[newTileIndex].tileIndexPosition;
-        clearedRange.length = VISUAL_SAMPLE_RATE;
-        clearedRange.trackIdentifier = secondTilesRingBuffer[newTileIndex].trackIdentifer;
+        clearedRange.startSample = tile.samplePosition;
+        clearedRange.length = tile.sampleLength;
+        clearedRange.trackIdentifier = tile.trackIdentifer;
         {
             std::lock_guard lock(clearedRangesMutex);
             clearedRanges.push(clearedRange);
         }
-        // remove the tile from the drawing order tracking
-        removeTrackTileFromDrawingOrder(secondTilesRingBuffer[newTileIndex].trackIdentifer, newTileIndex);
-        // clear signal from the previous object
-        secondTilesRingBuffer[newTileIndex].mesh->clearAllData();
-        secondTilesRingBuffer[newTileIndex].mesh->refreshGpuTextureIfChanged();
-    }
-    // initialize the new tile metadata and tracking in sets
-    secondTilesRingBuffer[newTileIndex].tileIndexPosition = secondTileIndex;
-    secondTilesRingBuffer[newTileIndex].samplePosition = secondTileIndex * VISUAL_SAMPLE_RATE;
-    secondTilesRingBuffer[newTileIndex].trackIdentifer = trackIdentifier;
-    addTrackTileToDrawingOrder(secondTilesRingBuffer[newTileIndex].trackIdentifer, newTileIndex);
+    }
+
+    // remove the tile from its track tiles by moving the last one in its place
+    TrackTiles &track = trackTiles[tile.trackSlot];
+    track.tileByPosition[tile.level][getTrackTilesIndexPosition(tile.tileIndexPosition)] = -1;
+    size_t lastTileIndex = track.tiles.back();
+    track.tiles[tile.positionInTrackTiles] = lastTileIndex;
+    secondTilesRingBuffer[lastTileIndex].positionInTrackTiles = tile.positionInTrackTiles;
+    track.tiles.pop_back();
+    trackDrawOrderNonce++;
 
-    juce::Colour col = KHOLORS_COLOR_WHITE;
-    auto optionalColor = knownTrackColors.find(trackIdentifier);
-    if (optionalColor != knownTrackColors.end())
+    // free the track slot and its index if it was the last tile of its track
+    if (track.tiles.size() == 0)
     {
-        col = optionalColor->second;
+        trackSlotByIdentifier.erase(track.trackIdentifier);
+        auto slotInDrawingOrder =
+            std::find(trackSlotsInDrawingOrder.begin(), trackSlotsInDrawingOrder.end(), tile.trackSlot);
+        trackSlotsInDrawingOrder.erase(slotInDrawingOrder);
+        freeTrackSlots.push_back(tile.trackSlot);
+        for (auto &levelTiles : track.tileByPosition)
+        {
+            std::vector<int32_t>().swap(levelTiles);
+        }
     }
 
-    secondTilesRingBuffer[newTileIndex].mesh->changeColor(col);
-    secondTilesRingBuffer[newTileIndex].mesh->setPosition(secondTilesRingBuffer[newTileIndex].samplePosition,
-                                                          VISUAL_SAMPLE_RATE, trackIdentifier);
+    // clear signal from the previous object
+    tile.tileIndexPosition = -1;
+    tile.texture->clearAllData();
+}
 
-    auto newIndex = std::pair<uint64_t, int64_t>(trackIdentifier, secondTileIndex);
-    auto newSetEntry = std::pair<std::pair<uint64_t, int64_t>, size_t>(newIndex, newTileIndex);
-    tileIndexByTrackIdAndPosition.insert(newSetEntry);
-    // increment the index of the next to be allocated
-    secondTileNextIndex++;
-    if (secondTileNextIndex == IMAGES_RING_BUFFER_SIZE)
+void GpuTextureDrawingBackend::limitTileCacheSize(size_t noTiles)
+{
+    // a recreated context can have less layers than the tiles and track slots in use,
+    // the tiles beyond them and the tiles of the tracks using the slots beyond them are evicted
+    for (size_t i = 0; i < secondTilesRingBuffer.size(); i++)
+    {
+        if (i >= noTiles || secondTilesRingBuffer[i].trackSlot >= noTiles)
+        {
+            recycleTile(i);
+        }
+    }
+    for (size_t i = noTiles; i < secondTilesRingBuffer.size(); i++)
     {
-        secondTileNextIndex = 0;
+        tilesUsage.remove(i);
     }
-    return newTileIndex;
+    if (secondTilesRingBuffer.size() > noTiles)
+    {
+        secondTilesRingBuffer.erase(secondTilesRingBuffer.begin() + (int64_t)noTiles, secondTilesRingBuffer.end());
+    }
+    freeTrackSlots.erase(std::remove_if(freeTrackSlots.begin(), freeTrackSlots.end(),
+                                        [noTiles](size_t trackSlot) { return trackSlot >= noTiles; }),
+                         freeTrackSlots.end());
+    tilesToUploadFirst.erase(std::remove_if(tilesToUploadFirst.begin(), tilesToUploadFirst.end(),
+                                            [noTiles](size_t tileIndex) { return tileIndex >= noTiles; }),
+                             tilesToUploadFirst.end());
+
+    std::queue<size_t> keptChangedTiles;
+    while (changedTiles.size() > 0)
+    {
+        size_t changedTile = changedTiles.front();
+        changedTiles.pop();
+        if (changedTile < noTiles)
+        {
+            keptChangedTiles.push(changedTile);
+        }
+    }
+    changedTiles.swap(keptChangedTiles);
+    tileCacheSize = noTiles;
 }
 
-void GpuTextureDrawingBackend::addTrackTileToDrawingOrder(uint64_t trackIdentifer, size_t tileRingBufferIndex)
+void GpuTextureDrawingBackend::addTileToTrackTiles(size_t tileRingBufferIndex)
 {
-    trackDrawOrderNonce++;
-
-    for (auto it = trackTilesInDrawingOrder.begin(); it != trackTilesInDrawingOrder.end(); ++it)
+    TrackSecondTile &tile = secondTilesRingBuffer[tileRingBufferIndex];
+    size_t trackSlot;
+    auto existingSlot = trackSlotByIdentifier.find(tile.trackIdentifer);
+    if (existingSlot != trackSlotByIdentifier.end())
+    {
+        trackSlot = existingSlot->second;
+    }
+    else
     {
-        // if current track tiles list is ours, we append our tile index to it
-        if (it->first == trackIdentifer)
+        if (freeTrackSlots.size() == 0)
+        {
+            throw std::runtime_error("no track slot left for a new tile");
+        }
+        trackSlot = freeTrackSlots.back();
+        freeTrackSlots.pop_back();
+        trackSlotByIdentifier[tile.trackIdentifer] = trackSlot;
+        trackTiles[trackSlot].trackIdentifier = tile.trackIdentifer;
+        for (auto &levelTiles : trackTiles[trackSlot].tileByPosition)
+        {
+            if (levelTiles.size() == 0)
+            {
+                levelTiles.resize(trackTilesIndexSize, -1);
+            }
+        }
+
+        // tracks are drawn by increasing identifier
+        auto nextSlot = trackSlotsInDrawingOrder.begin();
+        while (nextSlot != trackSlotsInDrawingOrder.end() &&
+               trackTiles[*nextSlot].trackIdentifier < tile.trackIdentifer)
         {
-            it->second.insert(it->second.begin(), tileRingBufferIndex);
-            return;
+            ++nextSlot;
         }
-        // if the current track tiles list track id is larger than ours, we insert our track tiles list before it
-        if (it->first > trackIdentifer)
+        trackSlotsInDrawingOrder.insert(nextSlot, trackSlot);
+
+        juce::Colour col = KHOLORS_COLOR_WHITE;
+        auto optionalColor = knownTrackColors.find(tile.trackIdentifer);
+        if (optionalColor != knownTrackColors.end())
         {
-            std::pair<uint64_t, std::list<size_t>> newTrackTilesList;
-            newTrackTilesList.first = trackIdentifer;
-            newTrackTilesList.second.insert(newTrackTilesList.second.begin(), tileRingBufferIndex);
-            trackTilesInDrawingOrder.insert(it, newTrackTilesList);
-            return;
+            col = optionalColor->second;
         }
+        tileTextures.setTrackColor(trackSlot, col);
     }
-    // if our track was not already in list and if no track id was larger than ours
-    // we will insert our track tiles list at the end
-    std::pair<uint64_t, std::list<size_t>> newTrackTilesList;
-    newTrackTilesList.first = trackIdentifer;
-    newTrackTilesList.second.insert(newTrackTilesList.second.begin(), tileRingBufferIndex);
-    trackTilesInDrawingOrder.insert(trackTilesInDrawingOrder.end(), newTrackTilesList);
+
+    TrackTiles &track = trackTiles[trackSlot];
+    tile.trackSlot = trackSlot;
+    tile.positionInTrackTiles = track.tiles.size();
+    track.tiles.push_back(tileRingBufferIndex);
+    track.tileByPosition[tile.level][getTrackTilesIndexPosition(tile.tileIndexPosition)] = (int32_t)tileRingBufferIndex;
+    trackDrawOrderNonce++;
 }
 
-void GpuTextureDrawingBackend::removeTrackTileFromDrawingOrder(uint64_t trackIdentifier, size_t tileRingBufferIndex)
+void GpuTextureDrawingBackend::updateLookupTextures(bool force)
 {
-    trackDrawOrderNonce++;
+    std::vector<float> values(TILE_LOOKUP_TEXTURE_SIZE);
+    float lastValueIndex = float(TILE_LOOKUP_TEXTURE_SIZE - 1);
 
-    for (auto it = trackTilesInDrawingOrder.begin(); it != trackTilesInDrawingOrder.end(); ++it)
+    if (force || tmpIntensityTransformer.getNonce() != intensityTransformer.getNonce())
     {
-        if (it->first == trackIdentifier)
+        tmpIntensityTransformer.copyTransformer(intensityTransformer);
+        for (size_t i = 0; i < values.size(); i++)
         {
-            for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
-            {
-                if (*it2 == tileRingBufferIndex)
-                {
-                    it->second.erase(it2);
-                    return;
-                }
-            }
+            values[i] = tmpIntensityTransformer.transform(float(i) / lastValueIndex);
+        }
+        tileTextures.setIntensityCurve(values);
+    }
+
+    // the displayed position of a frequency goes through the linear frequency to its tile row
+    if (force || tmpFreqTransformer.getNonce() != freqTransformer.getNonce())
+    {
+        const NormalizedBijectiveProjection &tileFrequencyProjection =
+            *DisplayRowsMapper::getDisplayFrequencyProjection();
+        tmpFreqTransformer.copyTransformer(freqTransformer);
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = tileFrequencyProjection.projectIn(tmpFreqTransformer.transformInv(float(i) / lastValueIndex));
         }
+        tileTextures.setFrequencyMap(values);
+    }
+}
+
+size_t GpuTextureDrawingBackend::getTrackTilesIndexPosition(int64_t levelTileIndex) const
+{
+    int64_t indexSize = (int64_t)trackTilesIndexSize;
+    return (size_t)(((levelTileIndex % indexSize) + indexSize) % indexSize);
+}
+
+void GpuTextureDrawingBackend::markTileChanged(size_t tileRingBufferIndex)
+{
+    TrackSecondTile &tile = secondTilesRingBuffer[tileRingBufferIndex];
+    if (!tile.queuedForUpload)
+    {
+        changedTiles.push(tileRingBufferIndex);
+        tile.queuedForUpload = true;
     }
-    spdlog::warn("Trying to remove a tile that does not exist from drawing order!");
 }
 
-void GpuTextureDrawingBackend::ensureTrackTilesDrawOrderIsUpToDate()
+void GpuTextureDrawingBackend::updateLevelsOfDetail(size_t tileRingBufferIndex, size_t startX, size_t endX)
 {
-    if (trackDrawOrderNonce != lastTrackDrawOrderNonce)
+    // the tiles of the chain may be out of view while all the other tiles are in view, so they are
+    // all pinned until the last merged tile is created, for its creation not to evict the written tile
+    // or the tiles merged from it
+    std::array<size_t, TILE_LOD_LEVELS> pinnedTiles;
+    pinnedTiles[0] = tileRingBufferIndex;
+    tilesUsage.pin(tileRingBufferIndex);
+
+    size_t sourceTile = tileRingBufferIndex;
+    for (size_t level = 1; level < TILE_LOD_LEVELS; level++)
     {
-        trackTilesDrawOrder.resize(0);
-        for (auto it = trackTilesInDrawingOrder.begin(); it != trackTilesInDrawingOrder.end(); ++it)
+        uint64_t trackIdentifier = secondTilesRingBuffer[sourceTile].trackIdentifer;
+        int64_t sourceIndex = secondTilesRingBuffer[sourceTile].tileIndexPosition;
+
+        // position of the merged tile, rounded towards negative infinity
+        int64_t mergedIndex = sourceIndex >= 0 ? sourceIndex / TILE_LOD_FACTOR
+                                               : -((TILE_LOD_FACTOR - 1 - sourceIndex) / TILE_LOD_FACTOR);
+        size_t sourceOffsetX = (size_t)(sourceIndex - (mergedIndex * TILE_LOD_FACTOR)) * SECOND_TILE_WIDTH;
+
+        int64_t existingMergedTile = getTileIndexIfExists(trackIdentifier, level, mergedIndex);
+        size_t mergedTile;
+        if (existingMergedTile >= 0)
         {
-            for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
-            {
-                trackTilesDrawOrder.push_back(*it2);
-            }
+            mergedTile = (size_t)existingMergedTile;
         }
-        lastTrackDrawOrderNonce = trackDrawOrderNonce;
+        else
+        {
+            mergedTile = createSecondTile(trackIdentifier, level, mergedIndex);
+        }
+        tilesUsage.markUsed(mergedTile);
+        pinnedTiles[level] = mergedTile;
+        tilesUsage.pin(mergedTile);
+
+        // merge whole groups of source columns, so that a partly written group is merged again when completed
+        size_t mergedStartX = (sourceOffsetX + startX) / TILE_LOD_FACTOR;
+        size_t mergedEndX = (sourceOffsetX + endX) / TILE_LOD_FACTOR;
+        secondTilesRingBuffer[mergedTile].texture->mergeColumns(
+            *secondTilesRingBuffer[sourceTile].texture, (mergedStartX * TILE_LOD_FACTOR) - sourceOffsetX,
+            mergedStartX, mergedEndX, TILE_LOD_FACTOR);
+        markTileChanged(mergedTile);
+
+        sourceTile = mergedTile;
+        startX = mergedStartX;
+        endX = mergedEndX;
+    }
+
+    for (size_t level = 0; level < TILE_LOD_LEVELS; level++)
+    {
+        tilesUsage.unpin(pinnedTiles[level]);
+    }
+}
+
+size_t GpuTextureDrawingBackend::getLevelOfDetail(int64_t samplesPerPixel)
+{
+    size_t level = 0;
+    int64_t texelSamples = (VISUAL_SAMPLE_RATE / SECOND_TILE_WIDTH) * TILE_LOD_FACTOR;
+    while (level + 1 < TILE_LOD_LEVELS && texelSamples <= samplesPerPixel)
+    {
+        level++;
+        texelSamples *= TILE_LOD_FACTOR;
+    }
+    return level;
+}
+
+size_t GpuTextureDrawingBackend::getTileToEvict()
+{
+    int64_t viewStart, viewEnd;
+    {
+        std::lock_guard lock(glThreadUniformsMutex);
+        viewStart = viewPosition;
+        viewEnd = viewPosition + (viewWidth * viewScale);
     }
+    auto tileToEvict = tilesUsage.getIndexToEvict([this, viewStart, viewEnd](size_t i) {
+        const TrackSecondTile &tile = secondTilesRingBuffer[i];
+        return tile.tileIndexPosition < 0 || tile.samplePosition + tile.sampleLength <= viewStart ||
+               tile.samplePosition >= viewEnd;
+    });
+    if (!tileToEvict.has_value())
+    {
+        throw std::runtime_error("no tile of the tile cache can be evicted");
+    }
+    return *tileToEvict;
 }
 
 void GpuTextureDrawingBackend::setTilePixelIntensity(size_t tileRingBufferIndex, int x, int y, float intensity)
@@ -740,7 +1003,7 @@ void GpuTextureDrawingBackend::setTilePixelIntensity(size_t tileRingBufferIndex,
     {
         return;
     }
-    secondTilesRingBuffer[tileRingBufferIndex].mesh->setPixelAt(x, y, intensity);
+    secondTilesRingBuffer[tileRingBufferIndex].texture->setPixelAt(x, y, intensity);
 }
 
 std::vector<FftDrawingBackend::ClearTrackInfoRange> GpuTextureDrawingBackend::getClearedTrackRanges()
@@ -763,6 +1026,23 @@ void GpuTextureDrawingBackend::setMouseCursor(bool onComponent, int x, int y)
     lastMouseY = y;
 }
 
+uint64_t GpuTextureDrawingBackend::getLastFrameUploadedBytes()
+{
+    return lastFrameUploadedBytes;
+}
+
+GpuTextureDrawingBackend::RenderStats GpuTextureDrawingBackend::getLastFrameStats()
+{
+    std::lock_guard lock(renderStatsMutex);
+    return lastFrameStats;
+}
+
+void GpuTextureDrawingBackend::setIngestMetrics(std::shared_ptr<AudioWorkersMetricsTask> metrics)
+{
+    std::lock_guard lock(renderStatsMutex);
+    lastIngestMetrics = metrics;
+}
+
 void GpuTextureDrawingBackend::setSelectedTrack(std::optional<uint64_t> selectedTrack, TaskingManager *tm)
 {
     {
@@ -5,16 +5,30 @@
 #include "StationApp/Audio/TrackInfoStore.h"
 #include "StationApp/GUI/FftDrawingBackend.h"
 #include "StationApp/GUI/NormalizedUnitTransformer.h"
+#include "StationApp/GUI/TileCacheConfig.h"
+#include "StationApp/Maths/NormalizedBijectiveProjection.h"
 #include "StationApp/OpenGL/BeatGridMesh.h"
-#include "StationApp/OpenGL/TexturedRectangle.h"
+#include "StationApp/OpenGL/GpuFrameTimer.h"
+#include "StationApp/OpenGL/TileTexture.h"
+#include "StationApp/OpenGL/TileTextureArray.h"
 #include "TaskManagement/TaskingManager.h"
+#include "Utils/LruIndexList.h"
 #include "juce_graphics/juce_graphics.h"
 #include "juce_opengl/juce_opengl.h"
+#include <array>
 #include <cstdint>
 #include <memory>
+#include <queue>
+#include <unordered_map>
 
 #define MAX_TIME_SIGNATURE_GRID_VIEW_SCALE 250
 
+/**< Number of levels of detail of the tiles, the first one being the one second tiles */
+#define TILE_LOD_LEVELS 3
+
+/**< Number of consecutive tiles of a level of detail merged into a tile of the next level */
+#define TILE_LOD_FACTOR 4
+
 class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRenderer
 {
   public:
@@ -25,68 +39,51 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
     {
         TrackSecondTile()
         {
-            mesh = std::make_shared<TexturedRectangle>(SECOND_TILE_WIDTH, SECOND_TILE_HEIGHT, KHOLORS_COLOR_WHITE);
+            texture = std::make_shared<TileTexture>(SECOND_TILE_WIDTH, SECOND_TILE_HEIGHT);
+            trackSlot = 0;
+            positionInTrackTiles = 0;
+            level = 0;
             tileIndexPosition = -1;
+            queuedForUpload = false;
         }
-        std::shared_ptr<TexturedRectangle> mesh;
-        uint64_t trackIdentifer;   /**< Identifier of the track this tile is for */
-        int64_t samplePosition;    /**< Position of the tile in samples */
-        int64_t tileIndexPosition; /**< Position of the tile in second-tile index */
+        std::shared_ptr<TileTexture> texture; /**< Texels of the tile, uploaded to its layer of the texture array */
+        size_t trackSlot;                     /**< Slot of the track this tile is for in trackTiles */
+        size_t positionInTrackTiles;          /**< Position of the tile in the tiles of its track slot */
+        uint64_t trackIdentifer;              /**< Identifier of the track this tile is for */
+        size_t level;                         /**< Level of detail of the tile, 0 for a one second tile */
+        int64_t samplePosition;               /**< Position of the tile in samples */
+        int64_t sampleLength;                 /**< Number of samples the tile spans */
+        int64_t tileIndexPosition;            /**< Position of the tile in the tiles of its level of detail */
+        bool queuedForUpload;                 /**< true if the tile is in the queue of changed tiles to upload */
+        std::vector<std::shared_ptr<ProcessingTimerWaitgroup>>
+            drawnWaitgroups; /**< Waitgroups of the ffts drawn in the tile since its last upload, one per drawing */
     };
 
-    struct FftToDraw
+    /**
+     * @brief The tiles of a track using a track slot, of all the levels of detail. The indices by
+     * position are only allocated while a track uses the slot, as most of the slots are never used.
+     */
+    struct TrackTiles
     {
-        FftToDraw()
-        {
-        }
-
-        FftToDraw(uint64_t _trackIdentifier, int64_t _secondTileIndex, int64_t _begin, int64_t _end, int fftSize,
-                  float *data, int _channel, uint32_t _sampleRate,
-                  std::shared_ptr<ProcessingTimerWaitgroup> _procTimeWg)
-        {
-            fftData.resize((size_t)fftSize);
-            for (size_t i = 0; i < (size_t)fftSize; i++)
-            {
-                fftData[i] = data[i];
-            }
-            channel = _channel;
-            trackIdentifier = _trackIdentifier;
-            secondTileIndex = _secondTileIndex;
-            begin = _begin;
-            end = _end;
-            sampleRate = _sampleRate;
-            procTimeWg = _procTimeWg;
-        }
-
-        void repurpose(uint64_t _trackIdentifier, int64_t _secondTileIndex, int64_t _begin, int64_t _end, int fftSize,
-                       float *data, int _channel, uint32_t _sampleRate,
-                       std::shared_ptr<ProcessingTimerWaitgroup> _procTimeWg)
+        TrackTiles()
         {
-            fftData.resize((size_t)fftSize);
-            float *srcData = data;
-            float *dstData = fftData.data();
-            for (size_t i = 0; i < (size_t)fftSize; ++i)
-            {
-                *dstData = *srcData;
-                dstData++;
-                srcData++;
-            }
-            channel = _channel;
-            trackIdentifier = _trackIdentifier;
-            secondTileIndex = _secondTileIndex;
-            begin = _begin;
-            end = _end;
-            sampleRate = _sampleRate;
-            procTimeWg = _procTimeWg;
+            trackIdentifier = 0;
         }
+        uint64_t trackIdentifier; /**< Identifier of the track using the slot */
+        std::array<std::vector<int32_t>, TILE_LOD_LEVELS>
+            tileByPosition;        /**< Tile index in ring buffer per level and tile position modulo its size or -1 */
+        std::vector<size_t> tiles; /**< Tile indices in ring buffer of the track, in no particular order */
+    };
 
-        std::vector<float> fftData; /**< data to draw inside the tile */
-        uint64_t trackIdentifier;   /**< identifier of the track tied to the track */
-        int64_t secondTileIndex;    /**< index of the tile to draw in */
-        int64_t begin, end;         /**< begin and end horizontal pixel coordinates */
-        int channel;                /**< 0 for left, 1 for right, 2 for both */
-        uint32_t sampleRate;        /**< sample rate of the fft tile */
-        std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg;
+    /**
+     * @brief Costs of a frame rendered by the openGL thread.
+     */
+    struct RenderStats
+    {
+        float cpuFrameMs;       /**< time spent in renderOpenGL */
+        float gpuFrameMs;       /**< GPU time of a recent frame, negative until the GPU reported one */
+        uint64_t uploadedBytes; /**< bytes of tile textures uploaded */
+        size_t pendingTiles;    /**< changed tiles left to upload in the next frames */
     };
 
     /**
@@ -139,7 +136,7 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
 
     /**
      * @brief clears on screen data.
-     * In this openGL version, queue clearing to be done by openGL Thread.
+     * In this openGL version, the tiles are cleared right away and uploaded by the openGL thread.
      */
     void clearDisplayedFFTs() override;
 
@@ -183,6 +180,24 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
      */
     void setSelectedTrack(std::optional<uint64_t> selectedTrack, TaskingManager *tm) override;
 
+    /**
+     * @brief Keep the latest audio ingest metrics to draw them under the render stats.
+     *
+     * @param metrics the metrics periodically emitted by the audio data workers
+     */
+    void setIngestMetrics(std::shared_ptr<AudioWorkersMetricsTask> metrics) override;
+
+    /**
+     * @brief Number of bytes of tile textures uploaded to the GPU during the last rendered frame.
+     * Can be called from any thread, for profiling.
+     */
+    uint64_t getLastFrameUploadedBytes();
+
+    /**
+     * @brief Costs of the last rendered frame. Can be called from any thread, for profiling.
+     */
+    RenderStats getLastFrameStats();
+
   private:
     /**
      * @brief Will draw rounded borders around the view.
@@ -191,32 +206,63 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
      */
     void drawBorders(juce::Graphics &g);
 
+    /**
+     * @brief Will draw the costs of the last rendered frame, and the latest audio ingest metrics
+     * under them, in the top left corner of the view.
+     *
+     * @param g juce graphics context
+     */
+    void drawRenderStats(juce::Graphics &g);
+
     /**
      * @brief Get index of the tile in the tile ring buffer if it exists.
-     * Called only from the OpenGL thread.
+     * Must be called holding tilesMutex.
      *
      * @param trackIdentifier identifier of the track
-     * @param secondTileIndex index in seconds of the tile position
+     * @param level level of detail of the tile
+     * @param levelTileIndex position of the tile in the tiles of its level, in seconds for level 0
      * @return tile index of exists, -1 otherwise
      */
-    int64_t getTileIndexIfExists(uint64_t trackIdentifier, int64_t secondTileIndex);
+    int64_t getTileIndexIfExists(uint64_t trackIdentifier, size_t level, int64_t levelTileIndex);
 
     /**
      * @brief Create a Second Tile object in the secondTilesRingBuffer ring buffer, eventually overwriting/deleting
-     * a previous tile, and clear the tile. Return a pointer to the tile.
-     * Called only from the OpenGL thread.
+     * a previous tile, and clear the tile. Return a pointer to the tile. The tile overwritten is the least recently
+     * used one, unless a tile of the same track and level uses the same entry of the track tiles index.
+     * Must be called holding tilesMutex. The tile is uploaded by the openGL thread before it is drawn.
      *
      * @throws std::invalid_argument when the tile already exist for this track at that position
      *
      * @param trackIdentifier identifier of the track this tile will be for
-     * @param secondTileIndex index of the tile in seconds this tile is positioned at
+     * @param level level of detail of the tile, which spans TILE_LOD_FACTOR^level seconds
+     * @param levelTileIndex position of the tile in the tiles of its level, in seconds for level 0
      * @return index of the new tile in the second-tile ring buffer
      */
-    size_t createSecondTile(uint64_t trackIdentifier, int64_t secondTileIndex);
+    size_t createSecondTile(uint64_t trackIdentifier, size_t level, int64_t levelTileIndex);
+
+    /**
+     * @brief Merge the columns just written in a tile into the tiles of the coarser levels of detail
+     * that cover them, creating these tiles if needed. Each column of a level is the maximum of
+     * TILE_LOD_FACTOR columns of the previous level. The written tile and the merged ones are pinned
+     * until the coarsest level is merged, so that creating a merged tile never evicts one of them.
+     *
+     * @param tileRingBufferIndex index of the one second tile written in the ring buffer of tiles
+     * @param startX first column written
+     * @param endX last column written
+     */
+    void updateLevelsOfDetail(size_t tileRingBufferIndex, size_t startX, size_t endX);
+
+    /**
+     * @brief Pick the coarsest level of detail whose texels are not wider than a pixel.
+     *
+     * @param samplesPerPixel current scale of the view
+     * @return size_t the level of detail of the tiles to draw
+     */
+    static size_t getLevelOfDetail(int64_t samplesPerPixel);
 
     /**
      * @brief Set a pixel inside an already existing tile.
-     * Called only from the OpenGL thread.
+     * Must be called holding tilesMutex.
      *
      * @param tileRingBufferIndex index of the tile in the ring buffer of tiles
      * @param x horizontal position in pixels
@@ -254,9 +300,10 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
 
     /**
      * @brief Draws the provided FFT (there's only one) on the TrackSecondTile.
-     * In this GPU version of the drawing backend, we just push a task on a queue.
-     * This function is not called from the openGL thread.
-     * The queue is then readed by the openGL thread which will call drawFftOnOpenGlThread
+     * Called from the worker threads, which write the texels of the tile in memory: the FFT rows
+     * are computed without lock, and only written in the tiles under tilesMutex. The openGL thread
+     * then uploads the columns that changed, and only then completes procTimeWg, so that the
+     * processing time and drawing backlog include the frames the tile waits for its upload.
      *
      * @param trackIdentifier identifier of the track this fft is for
      * @param secondTileIndex index of the second-tile (in seconds starting at zero)
@@ -264,68 +311,122 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
      * @param end end sample in the tile
      * @param fftSize number of frequency bins in the provided fft
      * @param data pointer to the floats containing fft bins intensities in decibels
+     * @param displayResolution true if data holds DISPLAY_RESOLUTION_NO_ROWS display rows instead of linear bins
      * @param channel 0 for left, 1 for right, 2 for both
      * @param sampleRate sample rate of data that was passed through fft
      * @param tm a tasking manager (used to check for shutdown and preevent deadlock with emssage thread)
      * @param procTimeWg a waitgroup to be used to notify when work is done, no need to call add, parent already did
      */
     void drawFftOnTile(uint64_t trackIdentifier, int64_t secondTileIndex, int64_t begin, int64_t end, int fftSize,
-                       float *data, int channel, uint32_t sampleRate, TaskingManager *tm,
+                       float *data, bool displayResolution, int channel, uint32_t sampleRate, TaskingManager *tm,
                        std::shared_ptr<ProcessingTimerWaitgroup> procTimeWg) override;
 
     /**
-     * @brief Called by the openGL thread to draw an fft isnide a GPU texture tile.
+     * @brief Set the color of a track. It is written in the track colors of its slot if it has tiles,
+     * which the openGL thread uploads with the next frame.
      *
-     * @param fftData Struct with the FFt and position data.
+     * @param trackIdentifier identifier of the track to change color of
+     * @param col color to apply to the track
      */
-    void drawFftOnOpenGlThread(std::shared_ptr<FftToDraw> fftData);
+    void setTrackColor(uint64_t trackIdentifier, juce::Colour col) override;
 
     /**
-     * @brief Set the color of a track. Or rather push a color update to the queue
-     * so that the openGL Renderer thread can pick it.
+     * @brief Remove a tile from the tiles of its track, notify the range it held was cleared,
+     * and clear its texture. A tile that has no track, as it was freed by a clear, is left as is.
      *
-     * @param trackIdentifier identifier of the track to change color of
-     * @param col color to apply to the track
+     * @param tileRingBufferIndex index of the tile in the ring buffer of tiles
      */
-    void setTrackColor(uint64_t trackIdentifier, juce::Colour col) override;
+    void recycleTile(size_t tileRingBufferIndex);
 
     /**
-     * @brief Add this tile to the track drawing order.
+     * @brief Reduce the number of tiles of the cache, and of track slots, evicting the tiles that
+     * do not fit anymore. Must be called holding tilesMutex.
      *
-     * @param trackIdentifier
-     * @param tileIndexInRingBuffer
+     * @param noTiles the new number of tiles, below the current one
      */
-    void addTrackTileToDrawingOrder(uint64_t trackIdentifier, size_t tileIndexInRingBuffer);
+    void limitTileCacheSize(size_t noTiles);
 
     /**
-     * @brief Remove this tile from the track drawing order.
+     * @brief Add a tile to the tiles of its track, allocating a track slot and uploading
+     * the track color if the track had no tile.
      *
-     * @param trackIdentifier
-     * @param tileIndexInRingBuffer
+     * @param tileRingBufferIndex index of the tile in the ring buffer of tiles
+     */
+    void addTileToTrackTiles(size_t tileRingBufferIndex);
+
+    /**
+     * @brief Rebuild the intensity curve and frequency map of the tiles from the transformers
+     * if these changed since they were last built.
+     *
+     * @param force true to rebuild them even if the transformers did not change
      */
-    void removeTrackTileFromDrawingOrder(uint64_t trackIdentifier, size_t tileIndexInRingBuffer);
+    void updateLookupTextures(bool force);
 
     /**
-     * @brief Called before using the trackTilesDrawOrder vector to ensure it's
-     * up to date.
+     * @brief Position of a tile index in the tileByPosition indices of the track tiles.
      */
-    void ensureTrackTilesDrawOrderIsUpToDate();
+    size_t getTrackTilesIndexPosition(int64_t levelTileIndex) const;
+
+    /**
+     * @brief Queue a tile whose texels were written for the openGL thread to upload it,
+     * unless it is already queued. Must be called holding tilesMutex.
+     *
+     * @param tileRingBufferIndex index of the tile in the ring buffer of tiles
+     */
+    void markTileChanged(size_t tileRingBufferIndex);
+
+    /**
+     * @brief Move the waitgroups of the ffts drawn in a tile to the uploaded ones, once the openGL
+     * thread uploaded it. Must be called holding tilesMutex, from the openGL thread.
+     *
+     * @param tileRingBufferIndex index of the tile in the ring buffer of tiles
+     */
+    void takeDrawnWaitgroups(size_t tileRingBufferIndex);
+
+    /**
+     * @brief Record the completion of the uploaded waitgroups, from the openGL thread, without holding tilesMutex.
+     */
+    void completeUploadedWaitgroups();
+
+    /**
+     * @brief Pick the tile to recycle when the cache is full: the least recently used tile
+     * that is free or outside of the view, or the least recently used one if they are all in view.
+     * The pinned tiles, that the tiles being written are merged from, are never picked.
+     * Must be called holding tilesMutex, it locks glThreadUniformsMutex to read the view.
+     *
+     * @return size_t index of the tile in the ring buffer of tiles
+     */
+    size_t getTileToEvict();
 
     juce::Colour backgroundColor;
 
     TmpNormalizedUnitTransformer tmpFreqTransformer, tmpIntensityTransformer;
 
-    std::list<std::pair<uint64_t, std::list<size_t>>>
-        trackTilesInDrawingOrder; /**< list of ordered tracks with their tiles lists used to construct
-                                     trackTilesDrawOrder */
-    uint64_t trackDrawOrderNonce, lastTrackDrawOrderNonce; /**< nonce to know when to regenerate trackTilesDrawOrder */
-    std::vector<size_t> trackTilesDrawOrder;               /**< tile indices in ring buffer to draw in order */
-
-    std::vector<TrackSecondTile> secondTilesRingBuffer; /**< Array of tiles that represent one second of track signal */
-    size_t secondTileNextIndex; /**< Index of the next tile to create in the secondTilesRingBuffer */
-    std::map<std::pair<uint64_t, int64_t>, size_t>
-        tileIndexByTrackIdAndPosition; /**< Index of tiles in secondTilesRingBuffer per track id and second tile index
-                                        std::pair(track_id, tile_index) */
+    uint64_t trackDrawOrderNonce;                   /**< changed when tiles are added or removed from trackTiles */
+    uint64_t lastInstancesDrawOrderNonce;           /**< trackDrawOrderNonce of the tile instances drawn */
+    std::optional<uint64_t> lastInstancesSelection; /**< selected track of the tile instances drawn */
+    size_t lastInstancesLevel;                      /**< level of detail of the tile instances drawn */
+
+    std::vector<TrackTiles> trackTiles; /**< Tiles of each track slot, there are as many slots as tiles */
+    std::unordered_map<uint64_t, size_t> trackSlotByIdentifier; /**< Slot in trackTiles of each track having tiles */
+    std::vector<size_t> freeTrackSlots;                          /**< Track slots not used by any track */
+    std::vector<size_t> trackSlotsInDrawingOrder; /**< Track slots used, by increasing track identifier */
+
+    TileCacheConfig tileCacheConfig; /**< Settings of the tile cache, its uploads and render stats */
+    size_t tileCacheSize;            /**< Number of tiles the cache holds, from the TileCacheConfig memory budget */
+    size_t trackTilesIndexSize;      /**< Size of each tileByPosition index of the track slots */
+    std::vector<TrackSecondTile> secondTilesRingBuffer; /**< Tiles that represent one second of track signal, up to
+                                                           tileCacheSize, recycled by least recent use */
+    TileTextureArray tileTextures; /**< Tiles textures, one layer per secondTilesRingBuffer index, and their mesh */
+    LruIndexList tilesUsage;       /**< Least recently used order of the tiles, with the merge sources pinned */
+    std::vector<size_t> tilesToUploadFirst; /**< Tiles created or cleared, uploaded with the next frame whatever
+                                               the upload budget, as their layer still holds other texels */
+    std::queue<size_t> changedTiles; /**< Tiles with texels to upload, in the order they changed, so that the upload
+                                        budget is shared round-robin between them across frames */
+    std::mutex tilesMutex; /**< Protects the tiles, their track slots and colors between workers and gl thread */
+    std::vector<std::shared_ptr<ProcessingTimerWaitgroup>>
+        uploadedWaitgroups; /**< Waitgroups of the tiles uploaded this frame, completed by the gl thread once
+                               tilesMutex is released so that the processing time covers the upload */
 
     int64_t lastDrawTilesNonce; /**< The last nonce tilesNonce drawn */
 
@@ -346,19 +447,7 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
     int64_t glThreadUniformsNonce;     /**< to know if we need to update position and  */
     int64_t lastUsedGlThreadUnifNonce; /**< the last nonce value when the uniforms got updated*/
 
-    std::queue<std::shared_ptr<FftToDraw>>
-        fftsToDrawQueue;        /**< queue of FFT to be drawn. Depends on the fftsToDrawLock */
-    std::mutex fftsToDrawMutex; /**< protect concurrent acces to the queue of ffts to draw */
-    std::queue<std::shared_ptr<FftToDraw>> idleFftToDrawStructs; /**< already allocated structs waiting to be filled */
-    std::mutex idleFftToDrawStructMutex;
-
-    std::mutex openGlThreadColorsMutex; /**< Locking color updates queues and color map for the openGL thread */
-    std::queue<std::pair<uint64_t, juce::Colour>>
-        colorUpdatesToApply; /**< track colors to be applied by openGL thread, need the lock */
-    std::map<uint64_t, juce::Colour> knownTrackColors; /**< track colors known to the openGL thread */
-
-    bool needToResetTiles;      /**< true when the openGL thread is expected to clear all tiles */
-    std::mutex tilesResetMutex; /**< mutex to protect acces to clearAllTiles */
+    std::map<uint64_t, juce::Colour> knownTrackColors; /**< track colors, applied to the slots of new tracks */
 
     std::mutex clearedRangesMutex;
     std::queue<ClearTrackInfoRange> clearedRanges; /**< A list of ranges on which specific tracks were cleared. Here to
@@ -370,7 +459,11 @@ class GpuTextureDrawingBackend : public FftDrawingBackend, public juce::OpenGLRe
     std::optional<uint64_t> currentlySelectedTrack;
     std::mutex selectedTrackMutex;
 
-    int64_t renderOpenGlIter; /**< a simple counter which is iterated at each render to track even/odd rendering */
-
-    std::vector<float> fftIntensitiesBuffer; /**< a buffer to set FFT intensities and pass to the textured rectangles */
+    uint64_t frameUploadedBytes; /**< bytes of tile textures uploaded so far in the frame, used by openGL thread */
+    std::atomic<uint64_t> lastFrameUploadedBytes; /**< bytes of tile textures uploaded during the last frame */
+    GpuFrameTimer gpuFrameTimer;                  /**< timer queries of the GPU cost of the frames */
+    std::mutex renderStatsMutex;                  /**< protects lastFrameStats and lastIngestMetrics */
+    RenderStats lastFrameStats;                   /**< costs of the last frame rendered by the openGL thread */
+    std::shared_ptr<AudioWorkersMetricsTask>
+        lastIngestMetrics; /**< latest audio ingest metrics, or nullptr until the audio workers emit them */
 };
\ No newline at end of file
@@ -34,6 +34,27 @@ class MouseCursorInfoTask : public SilentTask
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<MouseCursorInfoTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_UI;
+    }
+
+    // the cursor info follows the mouse, it must not wait behind the queued track updates
+    TaskPriority getTaskPriority() override
+    {
+        return TASK_PRIORITY_HIGH;
+    }
+
+    uint64_t getCoalescingKey() override
+    {
+        return getTaskTypeIdOf<MouseCursorInfoTask>();
+    }
+
     float frequencyUnderMouse; /**< Frequency in Hz under the mouse cursor */
     int64_t timeUnderMouse;    /**< position in audio samples under mouse cursor (at VISUAL_FFT_RATE) */
     bool cursorOnSfftView;     /**< is the cursor currently undet the view (and therefore showing info required) */
@@ -0,0 +1,69 @@
+#include "TileCacheConfig.h"
+#include "StationApp/GUI/FftDrawingBackend.h"
+#include "StationApp/StationSettings.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+TileCacheConfig::TileCacheConfig()
+    : budgetMb(DEFAULT_TILE_CACHE_MB), uploadBudgetUs(DEFAULT_TILE_UPLOAD_BUDGET_US), showRenderStats(false)
+{
+}
+
+TileCacheConfig TileCacheConfig::load()
+{
+    TileCacheConfig config;
+
+    const std::vector<std::pair<std::string, std::string>> entries = {
+        {"tile_cache_mb", "KHOLORS_TILE_CACHE_MB"},
+        {"tile_upload_budget_us", "KHOLORS_TILE_UPLOAD_BUDGET_US"},
+        {"render_stats", "KHOLORS_RENDER_STATS"}};
+    for (auto &value : StationSettings::read(entries))
+    {
+        config.setEntry(value.first, value.second);
+    }
+
+    return config;
+}
+
+void TileCacheConfig::setEntry(const std::string &key, const std::string &value)
+{
+    try
+    {
+        if (key == "tile_cache_mb")
+        {
+            int parsedBudget = std::stoi(value);
+            if (parsedBudget <= 0)
+            {
+                throw std::invalid_argument("tile cache budget must be positive");
+            }
+            budgetMb = (uint64_t)parsedBudget;
+        }
+        else if (key == "tile_upload_budget_us")
+        {
+            int parsedBudget = std::stoi(value);
+            if (parsedBudget <= 0)
+            {
+                throw std::invalid_argument("tile upload budget must be positive");
+            }
+            uploadBudgetUs = (uint64_t)parsedBudget;
+        }
+        else if (key == "render_stats")
+        {
+            showRenderStats = std::stoi(value) != 0;
+        }
+    }
+    catch (std::logic_error &e)
+    {
+        spdlog::warn("Ignoring invalid value \"{}\" for setting {}: {}", value, key, e.what());
+    }
+}
+
+size_t TileCacheConfig::getNoTiles(size_t tileBytes, size_t trackIndexBytesPerTile) const
+{
+    // each tile has its texels in RAM to be written and in VRAM to be drawn,
+    // and the index of each track having tiles grows with the number of tiles
+    size_t bytesPerTile = 2 * tileBytes + TILE_CACHE_BUDGETED_TRACKS * trackIndexBytesPerTile;
+    size_t noTiles = (size_t)((budgetMb * 1024 * 1024) / bytesPerTile);
+    return std::max(noTiles, (size_t)IMAGES_RING_BUFFER_SIZE);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**< Default memory budget of the spectrogram tiles, in megabytes */
+#define DEFAULT_TILE_CACHE_MB 128
+
+/**< Default time the openGL thread may spend uploading changed tiles in a frame, in microseconds */
+#define DEFAULT_TILE_UPLOAD_BUDGET_US 1000
+
+/**< Number of tracks whose index of tiles by position is counted in the tile cache budget */
+#define TILE_CACHE_BUDGETED_TRACKS 32
+
+/**
+ * @brief Settings of the cache of spectrogram tiles of the GPU drawing backend and of their rendering.
+ * They are read with StationSettings from the json settings file and then from the environment variables:
+ * - KHOLORS_TILE_CACHE_MB / "tile_cache_mb": megabytes the tiles can use, their texels being
+ *   counted once in RAM and once in VRAM, along with the index of the tiles by position of
+ *   TILE_CACHE_BUDGETED_TRACKS tracks. The one second tiles and the tiles of the coarser levels
+ *   of detail share the cache, so it holds less seconds of signal than tiles.
+ *   Defaults to DEFAULT_TILE_CACHE_MB.
+ * - KHOLORS_TILE_UPLOAD_BUDGET_US / "tile_upload_budget_us": microseconds spent at most uploading
+ *   changed tiles in a frame, at least one being uploaded. Defaults to DEFAULT_TILE_UPLOAD_BUDGET_US.
+ * - KHOLORS_RENDER_STATS / "render_stats": 1 to draw the frame costs over the spectrogram, 0 by default.
+ */
+struct TileCacheConfig
+{
+    TileCacheConfig();
+
+    /**
+     * @brief Read the config from the settings file and the environment variables.
+     * Invalid values are logged and ignored.
+     *
+     * @return TileCacheConfig the config to size the tile cache with
+     */
+    static TileCacheConfig load();
+
+    /**
+     * @brief Number of tiles that fit the budget, and never less than IMAGES_RING_BUFFER_SIZE.
+     *
+     * @param tileBytes bytes of the texels of a tile
+     * @param trackIndexBytesPerTile bytes each tile of the cache adds to the index of the tiles of a track
+     * @return size_t the number of tiles of the cache
+     */
+    size_t getNoTiles(size_t tileBytes, size_t trackIndexBytesPerTile) const;
+
+    uint64_t budgetMb;       /**< megabytes the tiles can use in RAM and VRAM together */
+    uint64_t uploadBudgetUs; /**< microseconds spent at most uploading changed tiles in a frame */
+    bool showRenderStats;    /**< true to draw the render stats overlay */
+
+  private:
+    /**
+     * @brief Set a config entry from its textual value.
+     *
+     * @param key name of the entry in the settings file
+     * @param value value of the entry
+     */
+    void setEntry(const std::string &key, const std::string &value);
+};
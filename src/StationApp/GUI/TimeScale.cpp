@@ -1,6 +1,7 @@
 #include "TimeScale.h"
 #include "GUIToolkit/Consts.h"
 #include "StationApp/GUI/FftDrawingBackend.h"
+#include <algorithm>
 #include <mutex>
 #include <string>
 
@@ -62,8 +63,9 @@ void TimeScale::drawTicks(juce::Graphics &g, int64_t currentViewPosition, int64_
 
     int grid0PixelShift =
         (int(grid0FrameWidth + 0.5f) - (currentViewPosition % int(grid0FrameWidth + 0.5f))) / currentViewScale;
-    int grid1PixelShift = int(grid0PixelShift + 0.5f) % int(grid1PixelWidth + 0.5f);
-    int grid2PixelShift = int(grid1PixelShift + 0.5f) % int(grid2PixelWidth + 0.5f);
+    // when zoomed out, the finer grids get narrower than a pixel
+    int grid1PixelShift = int(grid0PixelShift + 0.5f) % std::max(1, int(grid1PixelWidth + 0.5f));
+    int grid2PixelShift = int(grid1PixelShift + 0.5f) % std::max(1, int(grid2PixelWidth + 0.5f));
 
     int currentBarIndex = int((float(currentViewPosition) / grid0FrameWidth)) + 1;
 
@@ -81,11 +83,18 @@ void TimeScale::drawTickLevel(juce::Graphics &g, int height, int width, juce::Co
     auto textBox = tickShape.translated(0, tickShape.getHeight() + TICK_LABEL_MARGIN);
     textBox.setWidth(TICK_LABEL_WIDTH);
 
+    // label one tick out of a power of two, so that labels are more than 50 pixels apart
+    int labelsStep = 1;
+    while (pixelStepWidth * float(labelsStep) <= 50.0f)
+    {
+        labelsStep *= 2;
+    }
+
     int currentTickPos = pixelStepShift;
     int i = 0;
     while (currentTickPos < getLocalBounds().getWidth())
     {
-        if (firstBarIndex >= 0 && (pixelStepWidth > 50 || ((firstBarIndex + i) % 2) == 0))
+        if (firstBarIndex >= 0 && ((firstBarIndex + i) % labelsStep) == 0)
         {
             int quarterIndex = firstBarIndex + i;
             int barIndex = (quarterIndex / 4) + 1;
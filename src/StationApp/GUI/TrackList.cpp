@@ -24,6 +24,7 @@ TrackList::TrackList(TrackInfoStore &tis, NormalizedUnitTransformer &nut, Taskin
     : taskingManager(tm), viewPosition(0), viewScale(200), freqViewWidth(1000), trackInfoStore(tis),
       frequencyTransformer(nut)
 {
+    lastUsedDisplayResolution = false;
     lastMouseX = 0;
     lastMouseY = 0;
     setOpaque(true);
@@ -385,7 +386,7 @@ void TrackList::setFreqViewWidth(int64_t newFVW)
 
 void TrackList::recordSfft(std::shared_ptr<NewFftDataTask> newSffts)
 {
-    size_t fftNumFreqBins = newSffts->fftData->size() / newSffts->noFFTs;
+    size_t fftNumFreqBins = newSffts->fftData.size() / newSffts->noFFTs;
     int64_t fftSampleWidth = (int64_t)newSffts->segmentSampleLength / (int64_t)newSffts->noFFTs;
 
     // if new, compute width of each FFT bin shown on screen given
@@ -394,12 +395,14 @@ void TrackList::recordSfft(std::shared_ptr<NewFftDataTask> newSffts)
     // and compute the bin position in frequency.
 
     if (lastUsedFftSize != fftNumFreqBins || lastUsedSampleRate != newSffts->sampleRate ||
-        lastUsedTransformerNonce != frequencyTransformer.getNonce())
+        lastUsedTransformerNonce != frequencyTransformer.getNonce() ||
+        lastUsedDisplayResolution != newSffts->displayResolution)
     {
 
         lastUsedFftSize = fftNumFreqBins;
         lastUsedSampleRate = newSffts->sampleRate;
         lastUsedTransformerNonce = frequencyTransformer.getNonce();
+        lastUsedDisplayResolution = newSffts->displayResolution;
 
         freqWeight.resize(fftNumFreqBins);
         binFrequencies.resize(fftNumFreqBins);
@@ -409,6 +412,14 @@ void TrackList::recordSfft(std::shared_ptr<NewFftDataTask> newSffts)
 
         for (size_t j = 0; j < fftNumFreqBins; j++)
         {
+            // display rows all have the same height on screen and are already on the display frequency scale
+            if (newSffts->displayResolution)
+            {
+                freqWeight[j] = linearBinWidth;
+                binFrequencies[j] = float(VISUAL_SAMPLE_RATE >> 1) *
+                                    frequencyTransformer.transformInv(float(j) / float(fftNumFreqBins - 1));
+                continue;
+            }
             float lowerBinBound = frequencyTransformer.transform((float)(j)*linearBinWidth);
             float upperBinBound = frequencyTransformer.transform((float)(j + 1) * linearBinWidth);
             float binWidth = upperBinBound - lowerBinBound;
@@ -419,7 +430,7 @@ void TrackList::recordSfft(std::shared_ptr<NewFftDataTask> newSffts)
         sampleRateRatio = float(VISUAL_SAMPLE_RATE) / float(newSffts->sampleRate);
     }
 
-    float *fftShift = newSffts->fftData->data();
+    float *fftShift = newSffts->fftData.data();
     float *currentFftDataPos;
     float *freqWeightPos;
     float *binFreqsPtr;
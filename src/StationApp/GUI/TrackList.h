@@ -216,6 +216,7 @@ class TrackList : public juce::Component
     size_t lastUsedFftSize;            /**< if these change, we need to recompute freqWeight and binFreqs */
     int64_t lastUsedSampleRate;        /**< if these change, we need to recompute freqWeight and binFreqs */
     uint64_t lastUsedTransformerNonce; /**< if these change, we need to recompute freqWeight and binFreqs */
+    bool lastUsedDisplayResolution;    /**< if these change, we need to recompute freqWeight and binFreqs */
 
     int64_t lastRedrawMs = 0;
 
@@ -35,5 +35,26 @@ class TrackSelectionTask : public SilentTask
         return taskj.dump();
     }
 
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<TrackSelectionTask>();
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_UI;
+    }
+
+    // the selection is a click, it must not wait behind the queued track info updates
+    TaskPriority getTaskPriority() override
+    {
+        return TASK_PRIORITY_HIGH;
+    }
+
+    uint64_t getCoalescingKey() override
+    {
+        return getTaskTypeIdOf<TrackSelectionTask>();
+    }
+
     std::optional<uint64_t> selectedTrack;
 };
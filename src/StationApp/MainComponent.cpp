@@ -2,6 +2,7 @@
 
 #include "GUIToolkit/Consts.h"
 #include "StationApp/Audio/AudioDataWorker.h"
+#include "StationApp/Audio/DataTasksJournal.h"
 #include "StationApp/Audio/TrackInfoStore.h"
 #include "StationApp/CheckUpdates.h"
 #include "StationApp/GUI/BottomInfoLine.h"
@@ -10,11 +11,14 @@
 #include "StationApp/GUI/FreqTimeView.h"
 #include "StationApp/GUI/HelpDialogContent.h"
 #include "StationApp/GUI/SensitivitySlider.h"
+#include "TaskManagement/TaskJournalReplayer.h"
 #include "TaskManagement/TaskingManager.h"
 #include "juce_events/juce_events.h"
 #include "juce_graphics/juce_graphics.h"
 #include "juce_gui_basics/juce_gui_basics.h"
+#include <cstring>
 #include <spdlog/spdlog.h>
+#include <stdexcept>
 
 #define DEFAULT_SERVER_PORT 7849
 
@@ -43,6 +47,8 @@ MainComponent::MainComponent()
     taskManager.registerTaskListener(&infoBar);
     taskManager.startTaskBroadcast();
 
+    startTaskJournalFromEnv();
+
     needsUpdate = checkIfUpdateAvailable();
 
     if (showTipsAtStartup)
@@ -60,6 +66,8 @@ MainComponent::MainComponent()
 MainComponent::~MainComponent()
 {
     audioDataServer.stopServer();
+    journalReplayer.reset();
+    taskManager.stopTaskJournal();
 
     taskManager.shutdownBackgroundThreadAsync();
     while (taskManager.isBackgroundThreadRunning())
@@ -70,6 +78,45 @@ MainComponent::~MainComponent()
     menuBar.setModel(nullptr);
 }
 
+void MainComponent::startTaskJournalFromEnv()
+{
+    // record the data tasks of the session to benchmark the display with them later
+    if (const char *recordPath = std::getenv("KHOLORS_TASK_JOURNAL_RECORD"))
+    {
+        try
+        {
+            taskManager.startTaskJournal(recordPath);
+        }
+        catch (std::runtime_error &err)
+        {
+            spdlog::error("Unable to record the task journal: {}", err.what());
+        }
+    }
+    // replay recorded data tasks, with their original timing unless the max speed is requested
+    if (const char *replayPath = std::getenv("KHOLORS_TASK_JOURNAL_REPLAY"))
+    {
+        bool realTime = true;
+        if (const char *replaySpeed = std::getenv("KHOLORS_TASK_JOURNAL_REPLAY_SPEED"))
+        {
+            if (std::strcmp(replaySpeed, "max") == 0)
+            {
+                realTime = false;
+            }
+        }
+        try
+        {
+            registerDataTasksDecoders(journalDecoders);
+            journalReplayer = std::make_unique<TaskJournalReplayer>(taskManager, journalDecoders, replayPath, realTime);
+            journalReplayer->start();
+            spdlog::info("Replaying the task journal {}", replayPath);
+        }
+        catch (std::runtime_error &err)
+        {
+            spdlog::error("Unable to replay the task journal: {}", err.what());
+        }
+    }
+}
+
 void MainComponent::paint(juce::Graphics &g)
 {
     g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
@@ -185,7 +232,7 @@ void MainComponent::resized()
 
 bool MainComponent::taskHandler(std::shared_ptr<Task> task)
 {
-    auto quitTask = std::dynamic_pointer_cast<QuittingTask>(task);
+    auto quitTask = taskCast<QuittingTask>(task);
     if (quitTask != nullptr)
     {
         juce::JUCEApplicationBase::quit();
@@ -196,6 +243,11 @@ bool MainComponent::taskHandler(std::shared_ptr<Task> task)
     return false;
 }
 
+std::vector<TaskTypeId> MainComponent::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<QuittingTask>()};
+}
+
 juce::Path MainComponent::getShadowPath()
 {
     // coordinates of the freqview top left angle bottom
@@ -9,6 +9,8 @@
 #include "StationApp/GUI/ClearButton.h"
 #include "StationApp/GUI/FreqTimeView.h"
 #include "StationApp/GUI/SensitivitySlider.h"
+#include "TaskManagement/TaskJournal.h"
+#include "TaskManagement/TaskJournalReplayer.h"
 #include "TaskManagement/TaskListener.h"
 #include "TaskManagement/TaskingManager.h"
 #include "juce_core/juce_core.h"
@@ -40,8 +42,20 @@ class MainComponent final : public juce::Component, public TaskListener
     void resized() override;
     bool taskHandler(std::shared_ptr<Task> task) override;
 
+    /**
+     * @brief The types of the tasks taskHandler handles.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
   private:
     juce::Path getShadowPath();
+
+    /**
+     * @brief Record or replay a task journal if the KHOLORS_TASK_JOURNAL_RECORD or KHOLORS_TASK_JOURNAL_REPLAY
+     * envars are set. KHOLORS_TASK_JOURNAL_REPLAY_SPEED=max replays it without the original delays.
+     */
+    void startTaskJournalFromEnv();
+
     TaskingManager taskManager;                           /**< Object that manages task for actions */
     juce::MenuBarComponent menuBar;                       /**< App menu at the top of the app */
     juce::SharedResourcePointer<FontsLoader> sharedFonts; /**< Singleton that loads all fonts */
@@ -54,6 +68,8 @@ class MainComponent final : public juce::Component, public TaskListener
     ClearButton clearButton;
     SensitivitySlider volumeSensitivitySlider;
     bool showTipsAtStartup, needsUpdate;
+    TaskJournalDecoders journalDecoders;                  /**< decoders of the replayed task journal tasks */
+    std::unique_ptr<TaskJournalReplayer> journalReplayer; /**< replays a task journal if requested by envar */
 
     juce::SharedResourcePointer<IconsLoader> sharedSvgs; /**< singleton that loads svg files */
 
@@ -0,0 +1,70 @@
+#include "GpuFrameTimer.h"
+#include "juce_opengl/opengl/juce_gl.h"
+
+using namespace juce::gl;
+
+GpuFrameTimer::GpuFrameTimer() : currentQuery(0), timing(false), registered(false), lastFrameMs(-1.0f)
+{
+    queries.fill(0);
+    pending.fill(false);
+}
+
+void GpuFrameTimer::registerGlObjects()
+{
+    glGenQueries(GPU_FRAME_TIMER_QUERIES, queries.data());
+    pending.fill(false);
+    currentQuery = 0;
+    timing = false;
+    registered = true;
+}
+
+void GpuFrameTimer::freeGlObjects()
+{
+    if (timing)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        timing = false;
+    }
+    glDeleteQueries(GPU_FRAME_TIMER_QUERIES, queries.data());
+    registered = false;
+}
+
+void GpuFrameTimer::beginFrame()
+{
+    if (!registered || timing)
+    {
+        return;
+    }
+    // a result that is still not available is dropped, as reusing the query discards it
+    if (pending[currentQuery])
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(queries[currentQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available != 0)
+        {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(queries[currentQuery], GL_QUERY_RESULT, &elapsedNs);
+            lastFrameMs = (float)elapsedNs / 1000000.0f;
+        }
+        pending[currentQuery] = false;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries[currentQuery]);
+    timing = true;
+}
+
+void GpuFrameTimer::endFrame()
+{
+    if (!timing)
+    {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[currentQuery] = true;
+    currentQuery = (currentQuery + 1) % GPU_FRAME_TIMER_QUERIES;
+    timing = false;
+}
+
+float GpuFrameTimer::getLastFrameMs() const
+{
+    return lastFrameMs;
+}
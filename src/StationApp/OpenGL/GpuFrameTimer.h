@@ -0,0 +1,50 @@
+#pragma once
+
+#include "juce_opengl/opengl/juce_gl.h"
+#include <array>
+#include <cstddef>
+
+/**< Number of frames whose timer queries can be in flight before their result is read */
+#define GPU_FRAME_TIMER_QUERIES 4
+
+/**
+ * @brief Measures the GPU time of the frames with GL_TIME_ELAPSED queries. The result of a frame
+ * is only read when its query is reused, GPU_FRAME_TIMER_QUERIES frames later, and only if the GPU
+ * made it available by then, so that timing the frames never makes the renderer wait for the GPU.
+ * This object should only be used within the OpenGL renderer thread.
+ */
+class GpuFrameTimer
+{
+  public:
+    GpuFrameTimer();
+
+    void registerGlObjects();
+
+    void freeGlObjects();
+
+    /**
+     * @brief Start timing the GPU commands of a frame, after reading the result of the
+     * query about to be reused if it is available.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Stop timing the GPU commands of the frame started with beginFrame.
+     */
+    void endFrame();
+
+    /**
+     * @brief GPU time of the latest frame whose result was read.
+     *
+     * @return float the time in milliseconds, or a negative value if no result was read yet
+     */
+    float getLastFrameMs() const;
+
+  private:
+    std::array<GLuint, GPU_FRAME_TIMER_QUERIES> queries; /**< query object identifiers */
+    std::array<bool, GPU_FRAME_TIMER_QUERIES> pending;   /**< true if the query timed a frame not read yet */
+    size_t currentQuery;                                 /**< query of the frame being timed or to time next */
+    bool timing;                                         /**< true between beginFrame and endFrame */
+    bool registered;                                     /**< true between registerGlObjects and freeGlObjects */
+    float lastFrameMs;                                   /**< latest result read, negative if none */
+};
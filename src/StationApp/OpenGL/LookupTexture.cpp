@@ -0,0 +1,76 @@
+#include "LookupTexture.h"
+#include "StationApp/OpenGL/GLInfoLogger.h"
+#include <stdexcept>
+
+using namespace juce::gl;
+
+LookupTexture::LookupTexture(size_t size, GLuint textureUnit) : unit(textureUnit), registered(false), tbo(0)
+{
+    if (size < 2)
+    {
+        throw std::invalid_argument("a lookup texture needs at least two values");
+    }
+    values.resize(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        values[i] = float(i) / float(size - 1);
+    }
+}
+
+void LookupTexture::registerGlObjects()
+{
+    glGenTextures(1, &tbo);
+    glBindTexture(GL_TEXTURE_1D, tbo);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_R32F, (GLsizei)values.size(), 0, GL_RED, GL_FLOAT, values.data());
+    glBindTexture(GL_TEXTURE_1D, 0);
+    printAllOpenGlError();
+    registered = true;
+}
+
+void LookupTexture::freeGlObjects()
+{
+    glDeleteTextures(1, &tbo);
+    registered = false;
+}
+
+void LookupTexture::setValues(const std::vector<float> &newValues)
+{
+    if (newValues.size() != values.size())
+    {
+        throw std::invalid_argument("lookup texture values must keep the size of the table");
+    }
+    values = newValues;
+    if (registered)
+    {
+        upload();
+    }
+}
+
+size_t LookupTexture::getSize() const
+{
+    return values.size();
+}
+
+void LookupTexture::bind()
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_1D, tbo);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LookupTexture::unbind()
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LookupTexture::upload()
+{
+    glBindTexture(GL_TEXTURE_1D, tbo);
+    glTexSubImage1D(GL_TEXTURE_1D, 0, 0, (GLsizei)values.size(), GL_RED, GL_FLOAT, values.data());
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "juce_opengl/opengl/juce_gl.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief A 1D texture of floats that shaders use as a lookup table of a function of [0, 1],
+ * with linear interpolation between its values. Its first and last texels hold the values
+ * of the function at 0 and 1, so shaders have to read it at (x * (size - 1) + 0.5) / size.
+ * The values are kept on the CPU side so that they survive the OpenGL context being recreated.
+ * This object should only be used within the OpenGL renderer thread.
+ */
+class LookupTexture
+{
+  public:
+    /**
+     * @brief Construct a new Lookup Texture object holding the identity function.
+     *
+     * @param size number of values of the table
+     * @param textureUnit index of the texture unit the table is bound to when drawing
+     */
+    LookupTexture(size_t size, GLuint textureUnit);
+
+    void registerGlObjects();
+
+    void freeGlObjects();
+
+    /**
+     * @brief Set the values of the table, and upload them if the GL objects are registered.
+     *
+     * @param newValues values of the function at i / (size - 1) for each index i, must be of the table size
+     */
+    void setValues(const std::vector<float> &newValues);
+
+    /**
+     * @brief Number of values of the table.
+     */
+    size_t getSize() const;
+
+    /**
+     * @brief Bind the table to its texture unit, leaving the first texture unit active.
+     */
+    void bind();
+
+    /**
+     * @brief Unbind the table from its texture unit, leaving the first texture unit active.
+     */
+    void unbind();
+
+  private:
+    /**
+     * @brief Upload all the values to the registered texture.
+     */
+    void upload();
+
+    std::vector<float> values; /**< values of the table */
+    GLuint unit;               /**< index of the texture unit the table is bound to */
+    bool registered;           /**< true between registerGlObjects and freeGlObjects */
+    GLuint tbo;                /**< texture object identifier */
+};
@@ -5,21 +5,26 @@
 std::string fftVertexShader =
     R"(
 #version 330 core
-layout (location = 0) in vec4 aPos;
-layout (location = 1) in vec4 aColor;
-layout (location = 2) in vec2 aTexCoord;
+layout (location = 0) in vec2 aCorner;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec3 aTilePosition;
+layout (location = 3) in uint aTrackSlot;
+layout (location = 4) in uint aLayer;
 
 out vec4 ourColor;
-out vec2 TexCoord;
+out vec3 TexCoord;
 
 uniform float viewPosition;
 uniform float viewWidth;
+uniform sampler1D trackColors;
 
 void main()
 {
-    gl_Position = vec4( (2.0*((aPos.x-viewPosition)/viewWidth))-1.0, aPos.y, aPos.z, aPos.w);
-    ourColor = aColor;
-    TexCoord = aTexCoord;
+    // aTilePosition holds the tile start and width in samples, and its depth
+    float samplePosition = aTilePosition.x + (aCorner.x * aTilePosition.y);
+    gl_Position = vec4( (2.0*((samplePosition-viewPosition)/viewWidth))-1.0, aCorner.y, aTilePosition.z, 1.0);
+    ourColor = vec4(texelFetch(trackColors, int(aTrackSlot), 0).rgb, 1.0);
+    TexCoord = vec3(aTexCoord, float(aLayer));
 }
 )";
 
@@ -29,9 +34,11 @@ std::string fftFragmentShader =
 out vec4 FragColor;
   
 in vec4 ourColor;
-in vec2 TexCoord;
+in vec3 TexCoord;
 
-uniform sampler2D sfftTexture;
+uniform sampler2DArray sfftTexture;
+uniform sampler1D intensityCurve;
+uniform sampler1D frequencyMap;
 uniform int convolutionId;
 
 // Define kernels
@@ -54,25 +61,55 @@ vec2 kpos(int index)
     )[index] / vec2(64, 512).xy;
 }
 
+// Read a lookup table whose first and last texels hold the values at 0 and 1
+// table : lookup texture
+// x : position between 0 and 1
+// return : the interpolated value at x
+float lookup(sampler1D table, float x)
+{
+    float size = float(textureSize(table, 0));
+    return texture(table, (clamp(x, 0.0, 1.0) * (size - 1.0) + 0.5) / size).r;
+}
+
+// Map displayed coordinates to the tile ones, the tile rows being mirrored around the
+// center for the two channels, from the lowest frequency in the center
+// uv : displayed coordinates, the third one being the layer
+// return : coordinates of the same frequency in the tile
+vec3 tileCoord(vec3 uv)
+{
+    float fromCenter = uv.y - 0.5;
+    float tileFromCenter = 0.5 * lookup(frequencyMap, 2.0 * abs(fromCenter));
+    return vec3(uv.x, 0.5 + (sign(fromCenter) * tileFromCenter), uv.z);
+}
+
+// Intensity of the tile at some coordinates, its texels being normalized decibels
+// sampler : texture array sampler
+// uv : coordinates in the tile, the third one being the layer
+// return : the intensity to draw
+float intensityAt(sampler2DArray sampler, vec3 uv)
+{
+    return lookup(intensityCurve, texture(sampler, uv).r);
+}
+
 // Extract region of dimension 3x3 from sampler centered in uv
-// sampler : texture sampler
-// uv : current coordinates on sampler
+// sampler : texture array sampler
+// uv : current coordinates on sampler, the third one being the layer
 // return : a mat3 with intensities
-mat3 region3x3(sampler2D sampler, vec2 uv)
+mat3 region3x3(sampler2DArray sampler, vec3 uv)
 {
     // Create each pixels for region
-    vec4[9] region;
+    float[9] region;
     
     for (int i = 0; i < 9; i++)
-        region[i] = texture(sampler, uv + kpos(i));
+        region[i] = intensityAt(sampler, vec3(uv.xy + kpos(i), uv.z));
 
     // Create 3x3 region
     mat3 mRegion;
     
     mRegion = mat3(
-        region[0][3], region[1][3], region[2][3],
-        region[3][3], region[4][3], region[5][3],
-        region[6][3], region[7][3], region[8][3]
+        region[0], region[1], region[2],
+        region[3], region[4], region[5],
+        region[6], region[7], region[8]
     );
     
     return mRegion;
@@ -80,9 +117,9 @@ mat3 region3x3(sampler2D sampler, vec2 uv)
 
 // Convolve a texture with kernel
 // kernel : kernel used for convolution
-// sampler : texture sampler
-// uv : current coordinates on sampler
-float convolution(mat3 kernel, sampler2D sampler, vec2 uv)
+// sampler : texture array sampler
+// uv : current coordinates on sampler, the third one being the layer
+float convolution(mat3 kernel, sampler2DArray sampler, vec3 uv)
 {
     float fragment;
     
@@ -102,7 +139,8 @@ void main()
 {
     if (convolutionId == 0)
     {
-        float intensity = texture(sfftTexture, TexCoord).a;
+        // the tile textures only have a red channel
+        float intensity = intensityAt(sfftTexture, tileCoord(TexCoord));
         FragColor = vec4(ourColor.x, ourColor.y, ourColor.z, intensity);
     }
     else
@@ -131,7 +169,7 @@ void main()
               convolutionMat = emboss;
               break;
         }
-        float intensity = convolution(convolutionMat, sfftTexture, TexCoord);
+        float intensity = convolution(convolutionMat, sfftTexture, tileCoord(TexCoord));
         FragColor = vec4(ourColor.x, ourColor.y, ourColor.z, intensity);
     }
 }
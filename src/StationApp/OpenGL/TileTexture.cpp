@@ -0,0 +1,120 @@
+#include "TileTexture.h"
+#include "juce_opengl/opengl/juce_gl.h"
+#include <algorithm>
+
+using namespace juce::gl;
+
+TileTexture::TileTexture(int64_t width, int64_t height)
+    : textureWidth(width), textureHeight(height), dirtyStartX(0), dirtyEndX((size_t)width - 1)
+{
+    halfTextureHeight = (size_t)(textureHeight >> 1);
+
+    texture.resize((size_t)(width * height));
+    std::fill(texture.begin(), texture.end(), 0);
+}
+
+size_t TileTexture::uploadChangedColumns(GLint layer)
+{
+    if (dirtyStartX >= (size_t)textureWidth)
+    {
+        return 0;
+    }
+    // the ffts write full height columns, so we upload the sub rectangle of the written columns
+    // and let the unpack row length skip over the rest of each row of the cpu buffer
+    GLsizei noColumns = (GLsizei)(1 + dirtyEndX - dirtyStartX);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)textureWidth);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, (GLint)dirtyStartX, 0, layer, noColumns, (GLsizei)textureHeight, 1,
+                    TILE_TEXTURE_FORMAT, TILE_TEXTURE_TYPE, texture.data() + dirtyStartX);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    dirtyStartX = (size_t)textureWidth;
+    dirtyEndX = 0;
+    return (size_t)noColumns * (size_t)textureHeight * sizeof(TileTexel);
+}
+
+TileTexel TileTexture::intensityToTexel(float intensity)
+{
+    float icorr = intensity;
+    if (icorr < 0.0f)
+    {
+        icorr = 0.0f;
+    }
+    if (icorr > 1.0f)
+    {
+        icorr = 1.0f;
+    }
+    return (TileTexel)(icorr * TILE_TEXEL_MAX_VALUE + 0.5f);
+}
+
+void TileTexture::setPixelAt(int x, int y, float intensity)
+{
+    size_t openGlTexelIndex = (size_t)((y * textureWidth) + x);
+    texture[openGlTexelIndex] = intensityToTexel(intensity);
+    markColumnsDirty((size_t)x, (size_t)x);
+}
+
+void TileTexture::setRepeatedVerticalHalfLine(int channel, size_t startX, size_t endX, float *intensities)
+{
+    size_t rowWidth = (size_t)textureWidth;
+    size_t noRepeats = 1 + (endX - startX);
+
+    // the left channel is drawn from the top row down to the middle, and the right one mirrored
+    // from the bottom row up to the middle, both starting with the last (highest frequency) intensity
+    TileTexel *topRowStart = texture.data() + startX;
+    TileTexel *bottomRowStart = texture.data() + (((size_t)textureHeight - 1) * rowWidth) + startX;
+
+    for (size_t i = 0; i < halfTextureHeight; i++)
+    {
+        TileTexel texel = intensityToTexel(intensities[halfTextureHeight - 1 - i]);
+
+        if (channel == 0 || channel == 2)
+        {
+            std::fill_n(topRowStart, noRepeats, texel);
+        }
+        if (channel == 1 || channel == 2)
+        {
+            std::fill_n(bottomRowStart, noRepeats, texel);
+        }
+
+        topRowStart += rowWidth;
+        bottomRowStart -= rowWidth;
+    }
+    markColumnsDirty(startX, endX);
+}
+
+void TileTexture::mergeColumns(const TileTexture &source, size_t sourceStartX, size_t startX, size_t endX,
+                               size_t factor)
+{
+    size_t rowWidth = (size_t)textureWidth;
+    size_t sourceRowWidth = (size_t)source.textureWidth;
+    for (size_t y = 0; y < (size_t)textureHeight; y++)
+    {
+        const TileTexel *sourceTexel = source.texture.data() + (y * sourceRowWidth) + sourceStartX;
+        TileTexel *texel = texture.data() + (y * rowWidth) + startX;
+        for (size_t x = startX; x <= endX; x++)
+        {
+            *texel = *std::max_element(sourceTexel, sourceTexel + factor);
+            sourceTexel += factor;
+            texel++;
+        }
+    }
+    markColumnsDirty(startX, endX);
+}
+
+void TileTexture::clearAllData()
+{
+    std::fill(texture.begin(), texture.end(), 0);
+    markAllColumnsChanged();
+}
+
+void TileTexture::markAllColumnsChanged()
+{
+    markColumnsDirty(0, (size_t)textureWidth - 1);
+}
+
+void TileTexture::markColumnsDirty(size_t startX, size_t endX)
+{
+    dirtyStartX = std::min(dirtyStartX, startX);
+    dirtyEndX = std::max(dirtyEndX, endX);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "juce_opengl/opengl/juce_gl.h"
+#include <cstdint>
+#include <vector>
+
+// The tiles only hold a value per pixel, so they are single channel textures of 8 bits texels
+// that the shaders read from the red component. The values are decibels normalized between MIN_DB
+// and 0, which 8 bits store in steps of a quarter of decibel, the sensitivity being applied by the shaders.
+
+/**< OpenGL internal format of the tile textures */
+#define TILE_TEXTURE_INTERNAL_FORMAT GL_R8
+
+/**< OpenGL format of the texels uploaded to the tile textures */
+#define TILE_TEXTURE_FORMAT GL_RED
+
+/**< OpenGL type of the texels uploaded to the tile textures, must match TileTexel */
+#define TILE_TEXTURE_TYPE GL_UNSIGNED_BYTE
+
+/**< Texel value of a normalized value of 1 */
+#define TILE_TEXEL_MAX_VALUE 255.0f
+
+/**< A texel of a tile texture */
+typedef uint8_t TileTexel;
+
+/**
+ * @brief The texels of a tile, written by the FFT drawing code and uploaded to its layer
+ * of a TileTextureArray. It keeps track of the columns that were written since the last upload.
+ * It is not thread safe: the FFT drawing workers write the texels holding the mutex of the tiles,
+ * and the upload, the only method making OpenGL calls, happens on the OpenGL renderer thread
+ * holding that same mutex.
+ */
+class TileTexture
+{
+  public:
+    TileTexture(int64_t width, int64_t height);
+
+    /**
+     * @brief If the texture has been changed since last upload, upload the range of columns
+     * that were written to a layer of the GL_TEXTURE_2D_ARRAY currently bound.
+     *
+     * @param layer layer of the texture array to upload to
+     * @return size_t number of bytes uploaded, 0 if the texture was unchanged
+     */
+    size_t uploadChangedColumns(GLint layer);
+
+    /**
+     * @brief Set a pixel inside the texture.
+     * It just write to a buffer and we bulk upload on uploadChangedColumns.
+     *
+     * @param x horizontal position in the texture
+     * @param y vertical position in the texture
+     * @param intensity intensity of the pixel between 0 and 1
+     */
+    void setPixelAt(int x, int y, float intensity);
+
+    /**
+     * @brief Write all intensities of the provided vector (range [0, 1]) on the
+     * channel (left/right/both) and repeat it between startX and endX.
+     * It's an ultra optimized version of the previous pattern of repeatedly calling setPixelAt.
+     *
+     *
+     * @param channel 0 for left (top), 1 for right (bottom), 2 for both
+     * @param startX first horizontal pixel to copy fft at
+     * @param endX last horizontal pixel to copy fft at
+     * @param intensities intensities of the vertical line, must be sized of half texture height
+     */
+    void setRepeatedVerticalHalfLine(int channel, size_t startX, size_t endX, float *intensities);
+
+    /**
+     * @brief Clears all the texture data. It just clear the buffer
+     * so calling uploadChangedColumns is necessary after.
+     */
+    void clearAllData();
+
+    /**
+     * @brief Set columns to the maximum, row by row, of groups of consecutive columns of another
+     * texture, to merge it into a texture covering a longer time range.
+     *
+     * @param source texture to merge, of the same height
+     * @param sourceStartX first column of source to merge
+     * @param startX first column to set
+     * @param endX last column to set
+     * @param factor number of columns of source merged in each column
+     */
+    void mergeColumns(const TileTexture &source, size_t sourceStartX, size_t startX, size_t endX, size_t factor);
+
+    /**
+     * @brief Make the next uploadChangedColumns upload the whole texture, for when
+     * the layer it is uploaded to was reallocated.
+     */
+    void markAllColumnsChanged();
+
+  private:
+    /**
+     * @brief Convert an intensity between 0 and 1 to a texel, clamping it.
+     */
+    static TileTexel intensityToTexel(float intensity);
+
+    /**
+     * @brief Extend the range of columns to upload on the next uploadChangedColumns.
+     *
+     * @param startX first column written
+     * @param endX last column written
+     */
+    void markColumnsDirty(size_t startX, size_t endX);
+
+    int64_t textureWidth, textureHeight; /**< Dimensions of texture */
+    std::vector<TileTexel> texture;      /**< Intensities to use as texture, row by row */
+    size_t dirtyStartX;                  /**< First column not uploaded to GPU, textureWidth if none */
+    size_t dirtyEndX;                    /**< Last column not uploaded to GPU, valid if dirtyStartX is */
+
+    size_t halfTextureHeight; /**< number of rows of each channel */
+};
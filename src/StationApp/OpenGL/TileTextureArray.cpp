@@ -0,0 +1,255 @@
+#include "TileTextureArray.h"
+#include "StationApp/OpenGL/GLInfoLogger.h"
+#include "juce_opengl/opengl/juce_gl.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace juce::gl;
+
+TileTextureArray::TileTextureArray(int64_t width, int64_t height, size_t layers)
+    : tileWidth(width), tileHeight(height), noLayers(layers), instancesChanged(false),
+      trackColorsDirtyStart(layers), trackColorsDirtyEnd(0), registered(false),
+      intensityCurve(TILE_LOOKUP_TEXTURE_SIZE, TILE_INTENSITY_CURVE_TEXTURE_UNIT),
+      frequencyMap(TILE_LOOKUP_TEXTURE_SIZE, TILE_FREQUENCY_MAP_TEXTURE_UNIT)
+{
+    vertices.reserve(4);
+
+    // upper left corner 0
+    vertices.push_back({{0.0f, -1.0f}, {0.0f, 1.0f}});
+
+    // upper right corner 1
+    vertices.push_back({{1.0f, -1.0f}, {1.0f, 1.0f}});
+
+    // lower right corner 2
+    vertices.push_back({{1.0f, 1.0f}, {1.0f, 0.0f}});
+
+    // lower left corner 3
+    vertices.push_back({{0.0f, 1.0f}, {0.0f, 0.0f}});
+
+    // lower left triangle
+    triangleIds.push_back(0);
+    triangleIds.push_back(2);
+    triangleIds.push_back(3);
+
+    // upper right triangle
+    triangleIds.push_back(0);
+    triangleIds.push_back(1);
+    triangleIds.push_back(2);
+
+    instances.reserve(noLayers);
+
+    trackColors.resize(noLayers * TILE_TRACK_COLOR_LEN);
+    std::fill(trackColors.begin(), trackColors.end(), 255);
+}
+
+void TileTextureArray::registerGlObjects()
+{
+    spdlog::debug("Registering the OpenGL tile texture array");
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (maxLayers <= 0)
+    {
+        throw std::runtime_error("the GPU does not support texture arrays for the tiles");
+    }
+    if ((size_t)maxLayers < noLayers)
+    {
+        spdlog::warn("The GPU only supports {} texture array layers out of the {} requested", maxLayers, noLayers);
+        noLayers = (size_t)maxLayers;
+    }
+
+    // generate objects
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    glGenBuffers(1, &instanceVbo);
+
+    printAllOpenGlError();
+
+    glBindVertexArray(vao);
+
+    // register and upload the quad corners data
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(sizeof(TileQuadVertex) * vertices.size()), vertices.data(),
+                 GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TileQuadVertex),
+                          (void *)(offsetof(TileQuadVertex, position)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TileQuadVertex),
+                          (void *)(offsetof(TileQuadVertex, texturePosition)));
+    glEnableVertexAttribArray(1);
+
+    // register and upload indices of the vertices to form the triangles
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(sizeof(unsigned int) * triangleIds.size()), triangleIds.data(),
+                 GL_STATIC_DRAW);
+
+    // register the per instance attributes, allocated once for as many instances as layers
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(sizeof(TileInstance) * noLayers), nullptr, GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void *)(offsetof(TileInstance, position)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(TileInstance), (void *)(offsetof(TileInstance, trackSlot)));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(TileInstance), (void *)(offsetof(TileInstance, layer)));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+    instancesChanged = true;
+
+    glBindVertexArray(0);
+    printAllOpenGlError();
+
+    // register the texture array, its layers content is uploaded by the tiles
+    glGenTextures(1, &tbo);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tbo);
+    // set the texture wrapping
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // set the filtering parameters
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, TILE_TEXTURE_INTERNAL_FORMAT, (GLsizei)tileWidth, (GLsizei)tileHeight,
+                 (GLsizei)noLayers, 0, TILE_TEXTURE_FORMAT, TILE_TEXTURE_TYPE, nullptr);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // register the track colors, which the vertex shader fetches by track slot
+    glGenTextures(1, &colorsTbo);
+    glBindTexture(GL_TEXTURE_1D, colorsTbo);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA8, (GLsizei)noLayers, 0, GL_RGBA, GL_UNSIGNED_BYTE, trackColors.data());
+    glBindTexture(GL_TEXTURE_1D, 0);
+    trackColorsDirtyStart = noLayers;
+    trackColorsDirtyEnd = 0;
+
+    intensityCurve.registerGlObjects();
+    frequencyMap.registerGlObjects();
+
+    printAllOpenGlError();
+    registered = true;
+}
+
+void TileTextureArray::drawGlObjects()
+{
+    if (instances.size() == 0)
+    {
+        return;
+    }
+
+    if (instancesChanged)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(sizeof(TileInstance) * instances.size()), instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        instancesChanged = false;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + TILE_TRACK_COLORS_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_1D, colorsTbo);
+    glActiveTexture(GL_TEXTURE0);
+    intensityCurve.bind();
+    frequencyMap.bind();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tbo);
+    glBindVertexArray(vao);
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)triangleIds.size(), GL_UNSIGNED_INT, nullptr,
+                            (GLsizei)instances.size());
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    intensityCurve.unbind();
+    frequencyMap.unbind();
+    glActiveTexture(GL_TEXTURE0 + TILE_TRACK_COLORS_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void TileTextureArray::freeGlObjects()
+{
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+    glDeleteBuffers(1, &instanceVbo);
+    glDeleteTextures(1, &tbo);
+    glDeleteTextures(1, &colorsTbo);
+    intensityCurve.freeGlObjects();
+    frequencyMap.freeGlObjects();
+    registered = false;
+}
+
+size_t TileTextureArray::getNoLayers() const
+{
+    return noLayers;
+}
+
+size_t TileTextureArray::uploadTile(size_t layer, TileTexture &tile)
+{
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tbo);
+    size_t uploadedBytes = tile.uploadChangedColumns((GLint)layer);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return uploadedBytes;
+}
+
+void TileTextureArray::setTrackColor(size_t trackSlot, juce::Colour col)
+{
+    uint8_t *color = trackColors.data() + (trackSlot * TILE_TRACK_COLOR_LEN);
+    color[0] = col.getRed();
+    color[1] = col.getGreen();
+    color[2] = col.getBlue();
+    color[3] = 255;
+    trackColorsDirtyStart = std::min(trackColorsDirtyStart, trackSlot);
+    trackColorsDirtyEnd = std::max(trackColorsDirtyEnd, trackSlot);
+}
+
+void TileTextureArray::uploadTrackColors()
+{
+    // the slots beyond the layers the GPU supports are never used
+    size_t dirtyEnd = std::min(trackColorsDirtyEnd, noLayers - 1);
+    if (!registered || trackColorsDirtyStart > dirtyEnd)
+    {
+        return;
+    }
+    // only the range of slots whose color changed is uploaded, a single texel for a color change
+    glBindTexture(GL_TEXTURE_1D, colorsTbo);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage1D(GL_TEXTURE_1D, 0, (GLint)trackColorsDirtyStart, (GLsizei)(1 + dirtyEnd - trackColorsDirtyStart),
+                    GL_RGBA, GL_UNSIGNED_BYTE, trackColors.data() + (trackColorsDirtyStart * TILE_TRACK_COLOR_LEN));
+    glBindTexture(GL_TEXTURE_1D, 0);
+    trackColorsDirtyStart = noLayers;
+    trackColorsDirtyEnd = 0;
+}
+
+void TileTextureArray::setIntensityCurve(const std::vector<float> &curve)
+{
+    intensityCurve.setValues(curve);
+}
+
+void TileTextureArray::setFrequencyMap(const std::vector<float> &map)
+{
+    frequencyMap.setValues(map);
+}
+
+void TileTextureArray::clearInstances()
+{
+    instances.clear();
+    instancesChanged = true;
+}
+
+void TileTextureArray::addInstance(size_t layer, int64_t viewPositionSamples, int64_t width, uint64_t trackIdentifier,
+                                   size_t trackSlot)
+{
+    if (instances.size() == noLayers)
+    {
+        throw std::runtime_error("adding more tile instances than there are layers in the texture array");
+    }
+    TileInstance instance;
+    instance.position[0] = (GLfloat)viewPositionSamples;
+    instance.position[1] = (GLfloat)width;
+    instance.position[2] = (float)trackIdentifier / (float)std::numeric_limits<uint64_t>::max();
+    instance.trackSlot = (GLuint)trackSlot;
+    instance.layer = (GLuint)layer;
+    instances.push_back(instance);
+    instancesChanged = true;
+}
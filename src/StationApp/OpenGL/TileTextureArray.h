@@ -0,0 +1,162 @@
+#pragma once
+
+#include "StationApp/OpenGL/GlMesh.h"
+#include "StationApp/OpenGL/LookupTexture.h"
+#include "TileTexture.h"
+#include "juce_graphics/juce_graphics.h"
+#include "juce_opengl/opengl/juce_gl.h"
+#include <cstdint>
+#include <vector>
+
+/**< Texture unit of the track colors, the tiles texture array being bound to the first one */
+#define TILE_TRACK_COLORS_TEXTURE_UNIT 1
+
+/**< Number of bytes of a track color in the track colors texture (RGBA) */
+#define TILE_TRACK_COLOR_LEN 4
+
+/**< Texture unit of the intensity curve applied to the tile texels */
+#define TILE_INTENSITY_CURVE_TEXTURE_UNIT 2
+
+/**< Texture unit of the map from displayed frequencies to tile rows */
+#define TILE_FREQUENCY_MAP_TEXTURE_UNIT 3
+
+/**< Number of values of the intensity curve and frequency map lookup textures */
+#define TILE_LOOKUP_TEXTURE_SIZE 1024
+
+/**
+ * @brief A corner of the quad shared by all the tile instances.
+ */
+struct TileQuadVertex
+{
+    GLfloat position[2];        /**< horizontal position in the tile between 0 and 1, vertical one in clip space */
+    GLfloat texturePosition[2]; /**< texture coordinates of the corner */
+};
+
+/**
+ * @brief The per instance attributes of a tile drawn by a TileTextureArray.
+ */
+struct TileInstance
+{
+    GLfloat position[3]; /**< start in samples, width in samples, and depth from the track identifier */
+    GLuint trackSlot;    /**< slot of the track the tile belongs to in the track colors */
+    GLuint layer;        /**< layer of the texture array holding the tile texels */
+};
+
+/**
+ * @brief An opengl mesh that draws all the tiles at once. Their textures are the layers of a
+ * single GL_TEXTURE_2D_ARRAY, and each tile to draw is an instance of the same quad, so that
+ * the whole spectrogram is a single instanced draw call and recycling a tile only means
+ * writing another texture in its layer. The instances only reference their track by a slot
+ * in a small texture of track colors, so changing the color of a track does not touch the instances.
+ * The texels hold normalized decibels on a fixed frequency axis, and the fragment shader maps them
+ * to the screen with two lookup textures: the intensity curve (the sensitivity) and the frequency map,
+ * so that changing either applies to all the tiles without rewriting any.
+ * Its methods must be called from the OpenGL renderer thread, except setTrackColor which only
+ * writes the CPU side of the track colors, to be uploaded by uploadTrackColors.
+ */
+class TileTextureArray : public GlMesh
+{
+  public:
+    /**
+     * @brief Construct a new Tile Texture Array object
+     *
+     * @param tileWidth width of the tile textures
+     * @param tileHeight height of the tile textures
+     * @param noLayers number of tile textures it can hold, and of track slots as a track has at least a tile
+     */
+    TileTextureArray(int64_t tileWidth, int64_t tileHeight, size_t noLayers);
+
+    void registerGlObjects() override;
+
+    /**
+     * @brief Draws the instances, uploading them first if they were changed since the last draw.
+     */
+    void drawGlObjects() override;
+
+    void freeGlObjects() override;
+
+    /**
+     * @brief Number of layers of the texture array, which registerGlObjects can lower to the GPU limit.
+     *
+     * @return size_t the number of tiles it can hold
+     */
+    size_t getNoLayers() const;
+
+    /**
+     * @brief Upload the columns of a tile texture that changed since its last upload to a layer.
+     *
+     * @param layer layer of the texture array holding the tile
+     * @param tile the tile texels
+     * @return size_t number of bytes uploaded
+     */
+    size_t uploadTile(size_t layer, TileTexture &tile);
+
+    /**
+     * @brief Set the color of the tiles of a track slot. It is only uploaded by uploadTrackColors,
+     * so that it can be called from any thread, as long as the calls are not concurrent with it.
+     *
+     * @param trackSlot slot of the track
+     * @param col color to apply (alpha channel is ignored)
+     */
+    void setTrackColor(size_t trackSlot, juce::Colour col);
+
+    /**
+     * @brief Upload the range of track colors that changed since the last upload, if any.
+     */
+    void uploadTrackColors();
+
+    /**
+     * @brief Set the curve applied to the normalized decibels of the texels to get the drawn intensities.
+     *
+     * @param curve TILE_LOOKUP_TEXTURE_SIZE intensities for normalized decibels from 0 to 1
+     */
+    void setIntensityCurve(const std::vector<float> &curve);
+
+    /**
+     * @brief Set the map from the displayed frequency axis to the frequency axis of the tile rows.
+     *
+     * @param map TILE_LOOKUP_TEXTURE_SIZE positions in the tile rows for displayed positions from 0 to 1,
+     * 0 being the lowest frequency
+     */
+    void setFrequencyMap(const std::vector<float> &map);
+
+    /**
+     * @brief Remove all the instances to draw, before adding the new ones.
+     * Only needed when the tiles to draw change, as instances are kept between frames.
+     */
+    void clearInstances();
+
+    /**
+     * @brief Add a tile to draw. Tiles are drawn in the order they are added.
+     *
+     * @param layer layer of the texture array holding the tile
+     * @param viewPositionSamples samples the tile starts at
+     * @param width width of the tile in audio samples
+     * @param trackIdentifier identifier of the track of the tile, which sets its depth
+     * @param trackSlot slot of the track of the tile, which sets its color
+     */
+    void addInstance(size_t layer, int64_t viewPositionSamples, int64_t width, uint64_t trackIdentifier,
+                     size_t trackSlot);
+
+  private:
+    int64_t tileWidth, tileHeight; /**< Dimensions of each layer */
+    size_t noLayers;               /**< number of layers of the texture array */
+
+    std::vector<TileQuadVertex> vertices;  /**< corners of the quad shared by all instances */
+    std::vector<unsigned int> triangleIds; /**< List of vertice ids to draw each triangle */
+    std::vector<TileInstance> instances;   /**< tiles to draw, in drawing order */
+    bool instancesChanged;                 /**< true if instances were changed since their last upload */
+    std::vector<uint8_t> trackColors;      /**< RGBA color of each track slot */
+    size_t trackColorsDirtyStart;          /**< First track slot whose color is not uploaded, noLayers if none */
+    size_t trackColorsDirtyEnd;            /**< Last track slot whose color is not uploaded, valid if the first is */
+    bool registered;                       /**< true between registerGlObjects and freeGlObjects */
+    LookupTexture intensityCurve;          /**< curve from normalized decibels to drawn intensities */
+    LookupTexture frequencyMap;            /**< map from displayed frequencies to tile rows */
+
+    GLuint vbo;         /**< vertex buffer object identifier */
+    GLuint ebo;         /**< index buffer object identifier (ids of vertices for triangles to draw) */
+    GLuint instanceVbo; /**< buffer object identifier of the per instance attributes */
+    GLuint vao;         /**< vertex array object identifier to draw with a oneliner */
+    GLuint tbo;         /**< texture array object identifier */
+    GLuint colorsTbo;   /**< track colors texture object identifier */
+};
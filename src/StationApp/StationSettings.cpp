@@ -0,0 +1,69 @@
+#include "StationSettings.h"
+#include <cstdlib>
+#include <fstream>
+#include <juce_core/juce_core.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+std::vector<std::pair<std::string, std::string>> StationSettings::read(
+    const std::vector<std::pair<std::string, std::string>> &entries)
+{
+    std::vector<std::pair<std::string, std::string>> values;
+
+    std::string settingsPath;
+    if (const char *settingsFile = std::getenv("KHOLORS_SETTINGS_FILE"))
+    {
+        settingsPath = settingsFile;
+    }
+    else
+    {
+        settingsPath = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                           .getChildFile("KholorsStation")
+                           .getChildFile(KHOLORS_SETTINGS_FILE_NAME)
+                           .getFullPathName()
+                           .toStdString();
+    }
+
+    std::ifstream settingsStream(settingsPath);
+    if (settingsStream.is_open())
+    {
+        nlohmann::json settings = nlohmann::json::parse(settingsStream, nullptr, false);
+        if (settings.is_discarded() || !settings.is_object())
+        {
+            spdlog::warn("Ignoring settings file {} as it is not a json object", settingsPath);
+        }
+        else
+        {
+            for (auto &entry : entries)
+            {
+                if (!settings.contains(entry.first))
+                {
+                    continue;
+                }
+                auto &value = settings[entry.first];
+                if (value.is_string())
+                {
+                    values.emplace_back(entry.first, value.get<std::string>());
+                }
+                else if (value.is_number_integer())
+                {
+                    values.emplace_back(entry.first, std::to_string(value.get<int>()));
+                }
+                else
+                {
+                    spdlog::warn("Ignoring setting {} as it is not a string or an integer", entry.first);
+                }
+            }
+        }
+    }
+
+    for (auto &entry : entries)
+    {
+        if (const char *envValue = std::getenv(entry.second.c_str()))
+        {
+            values.emplace_back(entry.first, envValue);
+        }
+    }
+
+    return values;
+}
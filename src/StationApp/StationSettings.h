@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**< Name of the settings file, looked for in the KholorsStation folder of the user application data directory */
+#define KHOLORS_SETTINGS_FILE_NAME "settings.json"
+
+/**
+ * @brief Reads the station settings from the json settings file and then from the environment
+ * variables, which take precedence. The settings file is KHOLORS_SETTINGS_FILE if set,
+ * or KHOLORS_SETTINGS_FILE_NAME in the app data folder.
+ */
+struct StationSettings
+{
+    /**
+     * @brief Read the textual values of some settings entries. Entries of the settings file
+     * that are neither strings nor integers are logged and ignored.
+     *
+     * @param entries pairs of a key of the settings file and the environment variable overriding it
+     * @return std::vector<std::pair<std::string, std::string>> pairs of keys and values in the order
+     * they must be applied, the ones from the environment variables coming last
+     */
+    static std::vector<std::pair<std::string, std::string>> read(
+        const std::vector<std::pair<std::string, std::string>> &entries);
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+/**
+ * @brief The lanes of the TaskingManager are not ordered between each other, so a clear handled on
+ * the control lane can overtake the data tasks queued on the data lane before it. A ClearEpoch keeps
+ * the time of the last clear, for the tasks sent before it to be dropped instead of being handled
+ * after the clear. It is thread safe.
+ */
+class ClearEpoch
+{
+  public:
+    ClearEpoch() : epochStartUnixMs(std::numeric_limits<int64_t>::min())
+    {
+    }
+
+    /**
+     * @brief Call clear and start a new epoch, in which the tasks sent before clearTimeUnixMs are dropped.
+     * It waits for the task handled by runIfCurrent to be done, so that no task sent before the clear
+     * is handled after it.
+     *
+     * @param clearTimeUnixMs time of the clear, the epoch never goes back in time
+     * @param clear callable clearing what the tasks of the previous epochs produced
+     */
+    template <typename Clear> void startNewEpoch(int64_t clearTimeUnixMs, Clear clear)
+    {
+        std::lock_guard lock(mutex);
+        if (clearTimeUnixMs > epochStartUnixMs)
+        {
+            epochStartUnixMs = clearTimeUnixMs;
+        }
+        clear();
+    }
+
+    /**
+     * @brief Call handle if the task was sent within the current epoch, without any clear starting meanwhile.
+     *
+     * @param sentTimeUnixMs time at which the task was sent
+     * @param handle callable handling the task
+     * @return true if the task was handled, false if it was sent before the last clear and dropped
+     */
+    template <typename Handle> bool runIfCurrent(int64_t sentTimeUnixMs, Handle handle)
+    {
+        std::lock_guard lock(mutex);
+        if (sentTimeUnixMs < epochStartUnixMs)
+        {
+            return false;
+        }
+        handle();
+        return true;
+    }
+
+  private:
+    std::mutex mutex;         /**< held while clearing and while handling a task, so that they never interleave */
+    int64_t epochStartUnixMs; /**< time of the last clear, the tasks sent before it are dropped */
+};
@@ -1,6 +1,7 @@
 #include "Task.h"
 
-int Task::taskGroupIndexIterator = 0;
+std::atomic<uint32_t> Task::taskGroupIndexIterator(0);
+std::atomic<TaskTypeId> Task::taskTypeIdIterator(UNTYPED_TASK_TYPE_ID + 1);
 
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
@@ -94,6 +95,16 @@ std::vector<std::shared_ptr<Task>> Task::getOppositeTasks()
     return emptyReversionTasks;
 }
 
+bool Task::supportsUndo()
+{
+    return false;
+}
+
+size_t Task::getHistorySizeInBytes()
+{
+    return DEFAULT_TASK_HISTORY_SIZE_BYTES;
+}
+
 int Task::getTaskGroupIndex()
 {
     return taskGroupIndex;
@@ -111,15 +122,9 @@ void Task::setTaskGroupToTarget(Task &targetTask)
 
 int Task::getNewTaskGroupIndex()
 {
-    int taskGroupToReturn = taskGroupIndexIterator;
-
-    taskGroupIndexIterator++;
-    if (taskGroupIndexIterator >= MAX_TASK_INDEX)
-    {
-        taskGroupIndexIterator = 0;
-    }
-
-    return taskGroupToReturn;
+    // tasks are created from several threads, and as MAX_TASK_INDEX is a power of two
+    // the modulo keeps wrapping correctly when the counter itself overflows
+    return (int)(taskGroupIndexIterator++ % MAX_TASK_INDEX);
 }
 
 TaskingManager *Task::getTaskingManager()
@@ -132,6 +137,40 @@ void Task::setTaskingManager(TaskingManager *tm)
     currentTaskingManager = tm;
 }
 
+TaskTypeId Task::getTaskTypeId()
+{
+    return UNTYPED_TASK_TYPE_ID;
+}
+
+TaskTypeId Task::allocateTaskTypeId()
+{
+    return taskTypeIdIterator++;
+}
+
+TaskLane Task::getTaskLane()
+{
+    return TASK_LANE_CONTROL;
+}
+
+TaskPriority Task::getTaskPriority()
+{
+    return TASK_PRIORITY_NORMAL;
+}
+
+uint64_t Task::getCoalescingKey()
+{
+    return NO_COALESCING_KEY;
+}
+
+uint32_t Task::getBinaryTag()
+{
+    return NO_BINARY_TASK_TAG;
+}
+
+void Task::serializeBinary(TaskBinaryWriter &)
+{
+}
+
 // ============================
 
 SilentTask::SilentTask()
@@ -152,6 +191,11 @@ std::string CancelTask::marshal()
     return taskj.dump();
 }
 
+TaskTypeId CancelTask::getTaskTypeId()
+{
+    return getTaskTypeIdOf<CancelTask>();
+}
+
 std::string RestoreTask::marshal()
 {
     json taskj = {{"object", "task"},
@@ -163,6 +207,11 @@ std::string RestoreTask::marshal()
     return taskj.dump();
 }
 
+TaskTypeId RestoreTask::getTaskTypeId()
+{
+    return getTaskTypeIdOf<RestoreTask>();
+}
+
 std::string ClearHistoryTask::marshal()
 {
     json taskj = {{"object", "task"},
@@ -174,6 +223,11 @@ std::string ClearHistoryTask::marshal()
     return taskj.dump();
 }
 
+TaskTypeId ClearHistoryTask::getTaskTypeId()
+{
+    return getTaskTypeIdOf<ClearHistoryTask>();
+}
+
 ///////////////////////////////////////
 
 std::string QuittingTask::marshal()
@@ -185,4 +239,14 @@ std::string QuittingTask::marshal()
                   {"recordable_in_history", recordableInHistory},
                   {"is_part_of_reversion", isPartOfReversion}};
     return taskj.dump();
+}
+
+TaskTypeId QuittingTask::getTaskTypeId()
+{
+    return getTaskTypeIdOf<QuittingTask>();
+}
+
+TaskPriority QuittingTask::getTaskPriority()
+{
+    return TASK_PRIORITY_HIGH;
 }
\ No newline at end of file
@@ -1,12 +1,58 @@
 #pragma once
 
 #include "Marshalable.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #define MAX_TASK_INDEX 1048576
 
+/**< Type id of the tasks that don't declare one, they only reach the TaskListeners that handle all tasks */
+#define UNTYPED_TASK_TYPE_ID 0
+
+typedef uint32_t TaskTypeId;
+
+/**
+ * @brief The TaskingManager runs each lane on its own thread. Tasks of a same lane are
+ * handled in the order they were broadcasted, but there is no ordering between lanes.
+ */
+enum TaskLane
+{
+    TASK_LANE_CONTROL = 0, /**< default lane, the only one recording tasks in history and undoing them */
+    TASK_LANE_DATA = 1,    /**< lane of the high rate tasks carrying audio analysis data */
+    TASK_LANE_UI = 2,      /**< lane of the tasks updating the display state and the widgets */
+};
+
+/**< Number of values in TaskLane */
+#define NO_TASK_LANES 3
+
+/**
+ * @brief Within a lane, the queued high priority tasks are broadcasted before the normal ones,
+ * even if the lane thread is in the middle of a backlog of normal tasks. Tasks of a same
+ * priority are broadcasted in order, but a high priority task can overtake older normal ones.
+ */
+enum TaskPriority
+{
+    TASK_PRIORITY_HIGH = 0,   /**< user interactions, that must be handled within a frame */
+    TASK_PRIORITY_NORMAL = 1, /**< default priority */
+};
+
+/**< Number of values in TaskPriority */
+#define NO_TASK_PRIORITIES 2
+
+/**< Coalescing key of the tasks that must all be delivered */
+#define NO_COALESCING_KEY 0
+
+/**< Memory a task is assumed to retain while it is in the task history, unless it tells otherwise */
+#define DEFAULT_TASK_HISTORY_SIZE_BYTES 256
+
+/**< Binary tag of the tasks that have no binary serialization, and are not written to task journals */
+#define NO_BINARY_TASK_TAG 0
+
 class TaskingManager;
+class TaskBinaryWriter;
 
 /**
   Abstract class for "Tasks", which are actions to perform or that were
@@ -76,6 +122,23 @@ class Task : public Marshalable
      */
     virtual std::vector<std::shared_ptr<Task>> getOppositeTasks();
 
+    /**
+     * @brief Tells if getOppositeTasks can undo this task. Only the tasks that go in task history
+     * and support undo are recorded in it, so the others are not retained by the history.
+     * Tasks overriding getOppositeTasks must override it too.
+     *
+     * @return true if the task can be undone, false by default
+     */
+    virtual bool supportsUndo();
+
+    /**
+     * @brief Memory this task retains while it is recorded in the task history, which is
+     * bounded in bytes. Tasks holding large buffers should override it.
+     *
+     * @return size_t the size in bytes, DEFAULT_TASK_HISTORY_SIZE_BYTES by default
+     */
+    virtual size_t getHistorySizeInBytes();
+
     /**
      Declare this task as part of a reversion (eg obtained with getOppositeTasks).
      */
@@ -141,6 +204,65 @@ class Task : public Marshalable
      */
     TaskingManager *getTaskingManager();
 
+    /**
+     * @brief Identifier of the class of this task. The TaskingManager uses it to only call the
+     * TaskListeners that handle this type of task, and taskCast uses it instead of RTTI.
+     * Tasks declare it by overriding this method to return getTaskTypeIdOf<TheirClass>().
+     *
+     * @return TaskTypeId the type id, or UNTYPED_TASK_TYPE_ID if the task does not declare one
+     */
+    virtual TaskTypeId getTaskTypeId();
+
+    /**
+     * @brief Get a new unique task type id. Use getTaskTypeIdOf instead.
+     *
+     * @return TaskTypeId a type id that was never returned before
+     */
+    static TaskTypeId allocateTaskTypeId();
+
+    /**
+     * @brief The lane whose thread broadcasts this task. Tasks that go in task history are
+     * always broadcasted on the control lane, as it owns the history.
+     *
+     * @return TaskLane the lane, TASK_LANE_CONTROL unless overriden
+     */
+    virtual TaskLane getTaskLane();
+
+    /**
+     * @brief The priority of the task in its lane queue. Only tasks that don't depend on being
+     * broadcasted after the normal tasks queued before them should return TASK_PRIORITY_HIGH.
+     *
+     * @return TaskPriority the priority, TASK_PRIORITY_NORMAL unless overriden
+     */
+    virtual TaskPriority getTaskPriority();
+
+    /**
+     * @brief Tasks that only carry the latest value of some state can return a coalescing key.
+     * When a task is broadcasted while an older task with the same key is still waiting in
+     * the lane queue, the newer one takes its place and the older one is never delivered.
+     * Tasks that go in task history are never coalesced.
+     *
+     * @return uint64_t the key, like the task type id, or NO_COALESCING_KEY (the default)
+     */
+    virtual uint64_t getCoalescingKey();
+
+    /**
+     * @brief Stable identifier of the binary serialization of this task class. Unlike the task
+     * type id, it must not change between runs as it is stored in task journals, where it tells
+     * which decoder reads the payload written by serializeBinary.
+     *
+     * @return uint32_t the tag, or NO_BINARY_TASK_TAG (the default) if the task is not serializable
+     */
+    virtual uint32_t getBinaryTag();
+
+    /**
+     * @brief Write the fields of the task needed to recreate it. Only called if getBinaryTag
+     * is overriden. Does nothing by default.
+     *
+     * @param writer where to append the fields
+     */
+    virtual void serializeBinary(TaskBinaryWriter &writer);
+
   protected:
     bool recordableInHistory; // tell if this task should be saved in history. Inherit SilentTask to have it false.
     bool isPartOfReversion;   // tells if this task was obtained through getOppositeTasks
@@ -152,12 +274,40 @@ class Task : public Marshalable
 
     int taskGroupIndex; // a unique identifier to group tasks together
 
-    static int taskGroupIndexIterator; // a static value that is incremented and assigned to new task, and also wrapped
-                                       // at MAX_TASK_INDEX
+    static std::atomic<uint32_t> taskGroupIndexIterator; // a static value that is incremented and assigned to new
+                                                         // task, and also wrapped at MAX_TASK_INDEX
 
     TaskingManager *currentTaskingManager;
+
+    static std::atomic<TaskTypeId> taskTypeIdIterator; // the next type id allocateTaskTypeId returns
 };
 
+/**
+ * @brief Type id of the tasks of class T, allocated the first time it is asked for.
+ */
+template <typename T> TaskTypeId getTaskTypeIdOf()
+{
+    static const TaskTypeId typeId = Task::allocateTaskTypeId();
+    return typeId;
+}
+
+/**
+ * @brief Cast a task to the class T by comparing its type id, which is way cheaper than
+ * a dynamic_pointer_cast. T must override getTaskTypeId, and a class inheriting T is only
+ * matched if it does not override it.
+ *
+ * @param task the task to cast
+ * @return std::shared_ptr<T> the casted task, or nullptr if the task is not a T
+ */
+template <typename T> std::shared_ptr<T> taskCast(const std::shared_ptr<Task> &task)
+{
+    if (task->getTaskTypeId() != getTaskTypeIdOf<T>())
+    {
+        return nullptr;
+    }
+    return std::static_pointer_cast<T>(task);
+}
+
 /**
  * @brief      This class describes a silent task. This is a task
  *             that defaults to not being recordable in history.
@@ -175,6 +325,8 @@ class CancelTask : public SilentTask
       Convert the task into a string.
      */
     std::string marshal();
+
+    TaskTypeId getTaskTypeId() override;
 };
 
 class RestoreTask : public SilentTask
@@ -184,6 +336,8 @@ class RestoreTask : public SilentTask
       Convert the task into a string.
      */
     std::string marshal();
+
+    TaskTypeId getTaskTypeId() override;
 };
 
 class ClearHistoryTask : public SilentTask
@@ -193,6 +347,8 @@ class ClearHistoryTask : public SilentTask
       Convert the task into a string.
      */
     std::string marshal();
+
+    TaskTypeId getTaskTypeId() override;
 };
 
 /**
@@ -206,4 +362,11 @@ class QuittingTask : public SilentTask
     Dumps the task data to a string as json
     */
     std::string marshal() override;
+
+    TaskTypeId getTaskTypeId() override;
+
+    /**
+     * @brief Quitting is asked by the user and must not wait for the queued tasks.
+     */
+    TaskPriority getTaskPriority() override;
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "TaskBinaryStream.h"
+
+void TaskBinaryWriter::writeString(const std::string &value)
+{
+    write<uint32_t>((uint32_t)value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void TaskBinaryWriter::writeFloats(const float *values, size_t noFloats)
+{
+    write<uint64_t>((uint64_t)noFloats);
+    writeBytes(values, noFloats * sizeof(float));
+}
+
+void TaskBinaryWriter::writeBytes(const void *bytes, size_t noBytes)
+{
+    if (noBytes == 0)
+    {
+        return;
+    }
+    size_t offset = buffer.size();
+    buffer.resize(offset + noBytes);
+    std::memcpy(buffer.data() + offset, bytes, noBytes);
+}
+
+void TaskBinaryWriter::clear()
+{
+    buffer.clear();
+}
+
+const uint8_t *TaskBinaryWriter::data() const
+{
+    return buffer.data();
+}
+
+size_t TaskBinaryWriter::size() const
+{
+    return buffer.size();
+}
+
+TaskBinaryReader::TaskBinaryReader(const uint8_t *_data, size_t _noBytes) : data(_data), noBytes(_noBytes), position(0)
+{
+}
+
+std::string TaskBinaryReader::readString()
+{
+    uint32_t length = read<uint32_t>();
+    const uint8_t *characters = readBytes(length);
+    return std::string((const char *)characters, length);
+}
+
+size_t TaskBinaryReader::readFloatsCount()
+{
+    uint64_t noFloats = read<uint64_t>();
+    // checked before the caller allocates room for the floats, as a corrupted count can be huge
+    if (noFloats > (noBytes - position) / sizeof(float))
+    {
+        throw std::runtime_error("binary task payload is shorter than its number of floats");
+    }
+    return (size_t)noFloats;
+}
+
+void TaskBinaryReader::readFloatsInto(float *destination, size_t noFloats)
+{
+    const uint8_t *floats = readBytes(noFloats * sizeof(float));
+    if (noFloats > 0)
+    {
+        std::memcpy(destination, floats, noFloats * sizeof(float));
+    }
+}
+
+const uint8_t *TaskBinaryReader::readBytes(size_t noBytesToRead)
+{
+    if (noBytesToRead > noBytes - position)
+    {
+        throw std::runtime_error("binary task payload is truncated");
+    }
+    const uint8_t *bytes = data + position;
+    position += noBytesToRead;
+    return bytes;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Encodes task fields into a compact binary buffer, in the native byte order.
+ * It is meant to be reused, clear keeps the capacity so encoding does not allocate once warm.
+ */
+class TaskBinaryWriter
+{
+  public:
+    /**
+     * @brief Append a trivially copyable value.
+     */
+    template <typename T> void write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "TaskBinaryWriter only writes trivially copyable values");
+        writeBytes(&value, sizeof(T));
+    }
+
+    /**
+     * @brief Append the length of the string followed by its characters.
+     */
+    void writeString(const std::string &value);
+
+    /**
+     * @brief Append the number of floats followed by the floats.
+     */
+    void writeFloats(const float *values, size_t noFloats);
+
+    /**
+     * @brief Append raw bytes.
+     */
+    void writeBytes(const void *bytes, size_t noBytes);
+
+    /**
+     * @brief Empty the buffer, keeping its capacity.
+     */
+    void clear();
+
+    /**
+     * @brief The encoded bytes.
+     */
+    const uint8_t *data() const;
+
+    /**
+     * @brief Number of encoded bytes.
+     */
+    size_t size() const;
+
+  private:
+    std::vector<uint8_t> buffer; /**< the encoded bytes */
+};
+
+/**
+ * @brief Decodes task fields written by a TaskBinaryWriter, in the same order.
+ * It throws a std::runtime_error when reading past the end of the buffer.
+ */
+class TaskBinaryReader
+{
+  public:
+    /**
+     * @brief Read from a buffer that must outlive the reader.
+     */
+    TaskBinaryReader(const uint8_t *data, size_t noBytes);
+
+    /**
+     * @brief Read a trivially copyable value.
+     */
+    template <typename T> T read()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "TaskBinaryReader only reads trivially copyable values");
+        T value;
+        std::memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Read a string written by writeString.
+     */
+    std::string readString();
+
+    /**
+     * @brief Read the number of floats written by writeFloats, then call readFloatsInto.
+     * It throws a std::runtime_error if the rest of the buffer is too short for that many floats.
+     */
+    size_t readFloatsCount();
+
+    /**
+     * @brief Copy noFloats floats into destination, after readFloatsCount.
+     */
+    void readFloatsInto(float *destination, size_t noFloats);
+
+    /**
+     * @brief Get a pointer to the next noBytes bytes and skip them.
+     */
+    const uint8_t *readBytes(size_t noBytes);
+
+  private:
+    const uint8_t *data; /**< the buffer being read */
+    size_t noBytes;      /**< size of the buffer */
+    size_t position;     /**< offset of the next byte to read */
+};
@@ -0,0 +1,249 @@
+#include "TaskJournal.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+/**< Size of the buffer of zeros written to reserve the journal growth where posix_fallocate is missing */
+#define TASK_JOURNAL_ZEROS_BYTES (64 * 1024)
+
+/**
+ * @brief Allocate the disk blocks of a range of a file, extending it if needed, so that writing
+ * in this range through a mapping never runs out of disk space. Throws a std::runtime_error otherwise.
+ */
+static void reserveFileRange(int fileDescriptor, size_t start, size_t end)
+{
+#ifndef __APPLE__
+    int result = posix_fallocate(fileDescriptor, (off_t)start, (off_t)(end - start));
+    if (result == 0)
+    {
+        return;
+    }
+    // some file systems can't preallocate, their blocks are then allocated by writing zeros
+    if (result != EOPNOTSUPP && result != EINVAL)
+    {
+        throw std::runtime_error(std::string("unable to grow task journal: ") + std::strerror(result));
+    }
+#endif
+    static const uint8_t zeros[TASK_JOURNAL_ZEROS_BYTES] = {};
+    size_t position = start;
+    while (position < end)
+    {
+        size_t noBytes = std::min(end - position, sizeof(zeros));
+        ssize_t written = pwrite(fileDescriptor, zeros, noBytes, (off_t)position);
+        if (written < 0 && errno != EINTR)
+        {
+            throw std::runtime_error(std::string("unable to grow task journal: ") + std::strerror(errno));
+        }
+        if (written > 0)
+        {
+            position += (size_t)written;
+        }
+    }
+}
+
+TaskJournalWriter::TaskJournalWriter(const std::string &path)
+    : mapping(nullptr), mappedSize(0), writtenSize(0), noRecords(0)
+{
+    fileDescriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0)
+    {
+        throw std::runtime_error("unable to create task journal " + path + ": " + std::strerror(errno));
+    }
+    try
+    {
+        remap(sizeof(TaskJournalFileHeader));
+    }
+    catch (...)
+    {
+        close(fileDescriptor);
+        throw;
+    }
+    TaskJournalFileHeader header;
+    header.magic = TASK_JOURNAL_MAGIC;
+    header.version = TASK_JOURNAL_VERSION;
+    std::memcpy(mapping, &header, sizeof(header));
+    writtenSize = sizeof(header);
+}
+
+TaskJournalWriter::~TaskJournalWriter()
+{
+    if (mapping != nullptr)
+    {
+        munmap(mapping, mappedSize);
+    }
+    // drop the unused end of the last growth step, if it fails the reader stops at its zeros anyway
+    int truncateResult = ftruncate(fileDescriptor, (off_t)writtenSize);
+    (void)truncateResult;
+    close(fileDescriptor);
+}
+
+void TaskJournalWriter::remap(size_t minSize)
+{
+    size_t newSize = mappedSize;
+    while (newSize < minSize)
+    {
+        newSize += TASK_JOURNAL_GROWTH_BYTES;
+    }
+    // a sparse file would only run out of disk space when the mapping is written, which raises a SIGBUS,
+    // so the growth is reserved first, and a full disk throws here with the current mapping still valid
+    reserveFileRange(fileDescriptor, mappedSize, newSize);
+    if (mapping != nullptr)
+    {
+        munmap(mapping, mappedSize);
+        mapping = nullptr;
+    }
+    void *newMapping = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (newMapping == MAP_FAILED)
+    {
+        throw std::runtime_error(std::string("unable to map task journal: ") + std::strerror(errno));
+    }
+    mapping = static_cast<uint8_t *>(newMapping);
+    mappedSize = newSize;
+}
+
+void TaskJournalWriter::append(uint32_t binaryTag, uint64_t timestampNs, const uint8_t *payload, size_t payloadSize)
+{
+    size_t recordSize = sizeof(TaskJournalRecordHeader) + payloadSize;
+    if (writtenSize + recordSize > mappedSize || mapping == nullptr)
+    {
+        remap(writtenSize + recordSize);
+    }
+    TaskJournalRecordHeader header;
+    header.payloadSize = (uint32_t)payloadSize;
+    header.binaryTag = binaryTag;
+    header.timestampNs = timestampNs;
+    std::memcpy(mapping + writtenSize, &header, sizeof(header));
+    if (payloadSize > 0)
+    {
+        std::memcpy(mapping + writtenSize + sizeof(header), payload, payloadSize);
+    }
+    writtenSize += recordSize;
+    noRecords++;
+}
+
+TaskJournalReader::TaskJournalReader(const std::string &path)
+    : mapping(nullptr), mappedSize(0), position(sizeof(TaskJournalFileHeader))
+{
+    fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        throw std::runtime_error("unable to open task journal " + path + ": " + std::strerror(errno));
+    }
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(TaskJournalFileHeader))
+    {
+        close(fileDescriptor);
+        throw std::runtime_error("task journal " + path + " is too short");
+    }
+    mappedSize = (size_t)fileStat.st_size;
+    void *newMapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (newMapping == MAP_FAILED)
+    {
+        close(fileDescriptor);
+        throw std::runtime_error("unable to map task journal " + path + ": " + std::strerror(errno));
+    }
+    mapping = static_cast<const uint8_t *>(newMapping);
+    TaskJournalFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (header.magic != TASK_JOURNAL_MAGIC || header.version != TASK_JOURNAL_VERSION)
+    {
+        munmap(const_cast<uint8_t *>(mapping), mappedSize);
+        close(fileDescriptor);
+        throw std::runtime_error("file " + path + " is not a task journal of a supported version");
+    }
+}
+
+TaskJournalReader::~TaskJournalReader()
+{
+    munmap(const_cast<uint8_t *>(mapping), mappedSize);
+    close(fileDescriptor);
+}
+
+#else
+
+TaskJournalWriter::TaskJournalWriter(const std::string &)
+    : fileDescriptor(-1), mapping(nullptr), mappedSize(0), writtenSize(0), noRecords(0)
+{
+    throw std::runtime_error("task journals are not supported on this platform");
+}
+
+TaskJournalWriter::~TaskJournalWriter()
+{
+}
+
+void TaskJournalWriter::remap(size_t)
+{
+}
+
+void TaskJournalWriter::append(uint32_t, uint64_t, const uint8_t *, size_t)
+{
+}
+
+TaskJournalReader::TaskJournalReader(const std::string &)
+    : fileDescriptor(-1), mapping(nullptr), mappedSize(0), position(0)
+{
+    throw std::runtime_error("task journals are not supported on this platform");
+}
+
+TaskJournalReader::~TaskJournalReader()
+{
+}
+
+#endif
+
+uint64_t TaskJournalWriter::getNoRecords() const
+{
+    return noRecords;
+}
+
+bool TaskJournalReader::next(TaskJournalRecord &record)
+{
+    if (mappedSize - position < sizeof(TaskJournalRecordHeader))
+    {
+        return false;
+    }
+    TaskJournalRecordHeader header;
+    std::memcpy(&header, mapping + position, sizeof(header));
+    // the zeroed end of a journal whose writer did not truncate it has no tag
+    if (header.binaryTag == NO_BINARY_TASK_TAG || mappedSize - position - sizeof(header) < header.payloadSize)
+    {
+        return false;
+    }
+    record.binaryTag = header.binaryTag;
+    record.timestampNs = header.timestampNs;
+    record.payload = mapping + position + sizeof(header);
+    record.payloadSize = header.payloadSize;
+    position += sizeof(header) + header.payloadSize;
+    return true;
+}
+
+void TaskJournalReader::rewind()
+{
+    position = sizeof(TaskJournalFileHeader);
+}
+
+void TaskJournalDecoders::registerDecoder(uint32_t binaryTag, Decoder decoder)
+{
+    decoders[binaryTag] = std::move(decoder);
+}
+
+std::shared_ptr<Task> TaskJournalDecoders::decode(const TaskJournalRecord &record) const
+{
+    auto decoder = decoders.find(record.binaryTag);
+    if (decoder == decoders.end())
+    {
+        return nullptr;
+    }
+    TaskBinaryReader reader(record.payload, record.payloadSize);
+    return decoder->second(reader);
+}
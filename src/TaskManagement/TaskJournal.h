@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Task.h"
+#include "TaskBinaryStream.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**< First bytes of a task journal file ("KHTJ") */
+#define TASK_JOURNAL_MAGIC 0x4a54484b
+
+/**< Version of the task journal format, bumped when a record layout changes */
+#define TASK_JOURNAL_VERSION 1
+
+/**< The journal file is grown and remapped by steps of this number of bytes */
+#define TASK_JOURNAL_GROWTH_BYTES (64 * 1024 * 1024)
+
+/**
+ * @brief Header at the start of a task journal file.
+ */
+struct TaskJournalFileHeader
+{
+    uint32_t magic;   /**< TASK_JOURNAL_MAGIC */
+    uint32_t version; /**< TASK_JOURNAL_VERSION */
+};
+
+/**
+ * @brief Header of each record of a task journal, followed by payloadSize bytes of payload.
+ */
+struct TaskJournalRecordHeader
+{
+    uint32_t payloadSize; /**< number of bytes written by the task serializeBinary */
+    uint32_t binaryTag;   /**< getBinaryTag of the task */
+    uint64_t timestampNs; /**< nanoseconds between the journal start and the task broadcast */
+};
+
+/**
+ * @brief A record read from a task journal. The payload points in the reader mapping.
+ */
+struct TaskJournalRecord
+{
+    uint32_t binaryTag;     /**< getBinaryTag of the task */
+    uint64_t timestampNs;   /**< nanoseconds between the journal start and the task broadcast */
+    const uint8_t *payload; /**< bytes written by the task serializeBinary */
+    size_t payloadSize;     /**< number of bytes of payload */
+};
+
+/**
+ * @brief Appends task records to a memory mapped file. The file is grown by steps of
+ * TASK_JOURNAL_GROWTH_BYTES and truncated to its content when the writer is destroyed,
+ * so appending is a memcpy most of the time. It is not thread safe.
+ * Journals are only supported on POSIX systems, the constructor throws elsewhere.
+ */
+class TaskJournalWriter
+{
+  public:
+    /**
+     * @brief Create or truncate the journal file and write its header.
+     * Throws a std::runtime_error if the file can't be created or mapped.
+     *
+     * @param path path of the journal file
+     */
+    TaskJournalWriter(const std::string &path);
+
+    /**
+     * @brief Unmap the file and truncate it to the records written.
+     */
+    ~TaskJournalWriter();
+
+    /**
+     * @brief Append a record. Throws a std::runtime_error if the file can't be grown.
+     *
+     * @param binaryTag tag of the task
+     * @param timestampNs nanoseconds since the journal start
+     * @param payload the task binary serialization
+     * @param payloadSize number of bytes of payload
+     */
+    void append(uint32_t binaryTag, uint64_t timestampNs, const uint8_t *payload, size_t payloadSize);
+
+    /**
+     * @brief Number of records appended.
+     */
+    uint64_t getNoRecords() const;
+
+  private:
+    /**
+     * @brief Grow the file and map it again so that it has room for at least minSize bytes.
+     * The disk space of the growth is allocated before the file is mapped, it throws a
+     * std::runtime_error if the disk is full.
+     */
+    void remap(size_t minSize);
+
+    int fileDescriptor; /**< the journal file */
+    uint8_t *mapping;   /**< the mapped file, or nullptr */
+    size_t mappedSize;  /**< size of the mapping and the file */
+    size_t writtenSize; /**< number of bytes written at the start of the file */
+    uint64_t noRecords; /**< number of records written */
+};
+
+/**
+ * @brief Reads the records of a task journal from a read only mapping of the file.
+ * Journals are only supported on POSIX systems, the constructor throws elsewhere.
+ */
+class TaskJournalReader
+{
+  public:
+    /**
+     * @brief Map the journal file and check its header.
+     * Throws a std::runtime_error if the file can't be read or is not a task journal.
+     *
+     * @param path path of the journal file
+     */
+    TaskJournalReader(const std::string &path);
+
+    /**
+     * @brief Unmap the file, the payloads of the records read are no longer valid.
+     */
+    ~TaskJournalReader();
+
+    /**
+     * @brief Read the next record.
+     *
+     * @param record filled with the record
+     * @return true if a record was read
+     * @return false the end of the journal was reached, or the next record is truncated or zeroed
+     */
+    bool next(TaskJournalRecord &record);
+
+    /**
+     * @brief Go back to the first record.
+     */
+    void rewind();
+
+  private:
+    int fileDescriptor;     /**< the journal file */
+    const uint8_t *mapping; /**< the mapped file */
+    size_t mappedSize;      /**< size of the file */
+    size_t position;        /**< offset of the next record */
+};
+
+/**
+ * @brief Recreates tasks from journal records, with a decoder per binary tag that
+ * the application registers for each of its serializable task classes.
+ */
+class TaskJournalDecoders
+{
+  public:
+    typedef std::function<std::shared_ptr<Task>(TaskBinaryReader &)> Decoder;
+
+    /**
+     * @brief Register the decoder of the tasks with this binary tag, replacing any previous one.
+     */
+    void registerDecoder(uint32_t binaryTag, Decoder decoder);
+
+    /**
+     * @brief Recreate the task of a record. Throws a std::runtime_error if the payload is truncated.
+     *
+     * @param record the journal record
+     * @return std::shared_ptr<Task> the task, or nullptr if no decoder handles its tag
+     */
+    std::shared_ptr<Task> decode(const TaskJournalRecord &record) const;
+
+  private:
+    std::unordered_map<uint32_t, Decoder> decoders; /**< decoder of each binary tag */
+};
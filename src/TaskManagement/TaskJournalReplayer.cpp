@@ -0,0 +1,92 @@
+#include "TaskJournalReplayer.h"
+#include "TaskingManager.h"
+#include <algorithm>
+#include <chrono>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+TaskJournalReplayer::TaskJournalReplayer(TaskingManager &tm, const TaskJournalDecoders &d, const std::string &path,
+                                         bool rt)
+    : taskingManager(tm), decoders(d), reader(path), realTime(rt), shouldStop(false), running(false),
+      noReplayedTasks(0), noSkippedRecords(0)
+{
+}
+
+TaskJournalReplayer::~TaskJournalReplayer()
+{
+    stop();
+}
+
+void TaskJournalReplayer::start()
+{
+    if (replayThread != nullptr)
+    {
+        throw std::runtime_error("TaskJournalReplayer was already started");
+    }
+    running = true;
+    replayThread = std::make_unique<std::thread>(&TaskJournalReplayer::replayThreadLoop, this);
+}
+
+void TaskJournalReplayer::stop()
+{
+    shouldStop = true;
+    if (replayThread != nullptr && replayThread->joinable())
+    {
+        replayThread->join();
+    }
+}
+
+bool TaskJournalReplayer::isRunning()
+{
+    return running;
+}
+
+uint64_t TaskJournalReplayer::getNoReplayedTasks()
+{
+    return noReplayedTasks;
+}
+
+uint64_t TaskJournalReplayer::getNoSkippedRecords()
+{
+    return noSkippedRecords;
+}
+
+void TaskJournalReplayer::replayThreadLoop()
+{
+    auto replayStart = std::chrono::steady_clock::now();
+    TaskJournalRecord record;
+    while (!shouldStop && reader.next(record))
+    {
+        std::shared_ptr<Task> task;
+        try
+        {
+            task = decoders.decode(record);
+        }
+        catch (std::runtime_error &err)
+        {
+            spdlog::warn("Skipped an invalid task journal record: {}", err.what());
+        }
+        if (task == nullptr)
+        {
+            noSkippedRecords++;
+            continue;
+        }
+        if (realTime)
+        {
+            // sleep by small steps so that stop does not wait for a long pause of the recording
+            auto broadcastTime = replayStart + std::chrono::nanoseconds(record.timestampNs);
+            while (!shouldStop && std::chrono::steady_clock::now() < broadcastTime)
+            {
+                std::this_thread::sleep_until(
+                    std::min(broadcastTime, std::chrono::steady_clock::now() + std::chrono::milliseconds(100)));
+            }
+        }
+        taskingManager.broadcastTask(task);
+        noReplayedTasks++;
+    }
+    auto elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+    spdlog::info("Replayed {} tasks from the task journal in {:.3f}s ({:.0f} tasks/sec), skipped {} records",
+                 noReplayedTasks.load(), elapsedSeconds, double(noReplayedTasks.load()) / elapsedSeconds,
+                 noSkippedRecords.load());
+    running = false;
+}
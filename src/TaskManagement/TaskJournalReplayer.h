@@ -0,0 +1,76 @@
+#pragma once
+
+#include "TaskJournal.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+class TaskingManager;
+
+/**
+ * @brief Broadcasts the tasks of a task journal again, from its own thread, so that the
+ * pipeline that handles them can be benchmarked with the same input without a DAW.
+ * The journal can be replayed with its original timing or as fast as possible.
+ */
+class TaskJournalReplayer
+{
+  public:
+    /**
+     * @brief Prepare the replay of a journal. Throws a std::runtime_error if it can't be read.
+     *
+     * @param taskingManager where to broadcast the tasks
+     * @param decoders recreate the tasks from the records, must outlive the replayer
+     * @param path path of the journal file
+     * @param realTime if true, keep the original delays between the tasks, otherwise don't wait at all
+     */
+    TaskJournalReplayer(TaskingManager &taskingManager, const TaskJournalDecoders &decoders, const std::string &path,
+                        bool realTime);
+
+    /**
+     * @brief Stop and join the replay thread.
+     */
+    ~TaskJournalReplayer();
+
+    /**
+     * @brief Start broadcasting the tasks from the replay thread.
+     */
+    void start();
+
+    /**
+     * @brief Stop broadcasting and join the replay thread.
+     */
+    void stop();
+
+    /**
+     * @brief Tells if the replay thread is still broadcasting tasks.
+     */
+    bool isRunning();
+
+    /**
+     * @brief Number of tasks broadcasted so far.
+     */
+    uint64_t getNoReplayedTasks();
+
+    /**
+     * @brief Number of records that were skipped as no decoder handled them or their payload was invalid.
+     */
+    uint64_t getNoSkippedRecords();
+
+  private:
+    /**
+     * @brief Read, decode and broadcast all the records, then log the replay throughput.
+     */
+    void replayThreadLoop();
+
+    TaskingManager &taskingManager;            /**< where the tasks are broadcasted */
+    const TaskJournalDecoders &decoders;       /**< recreate the tasks from the records */
+    TaskJournalReader reader;                  /**< the journal being replayed */
+    bool realTime;                             /**< keep the original delays between tasks */
+    std::atomic<bool> shouldStop;              /**< tells the replay thread to stop early */
+    std::atomic<bool> running;                 /**< is the replay thread broadcasting */
+    std::atomic<uint64_t> noReplayedTasks;     /**< number of tasks broadcasted */
+    std::atomic<uint64_t> noSkippedRecords;    /**< number of records that could not be decoded */
+    std::unique_ptr<std::thread> replayThread; /**< the replay thread if started */
+};
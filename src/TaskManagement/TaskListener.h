@@ -2,6 +2,7 @@
 
 #include "Task.h"
 #include <memory>
+#include <vector>
 
 /**
 Inherited by classes who wants to be able to receive tasks from the
@@ -16,4 +17,14 @@ class TaskListener
      * Returns true if the task don't need further broadcast.
      */
     virtual bool taskHandler(std::shared_ptr<Task> task) = 0;
+
+    /**
+     * Type ids (from getTaskTypeIdOf) of the tasks this listener handles. The TaskingManager
+     * reads it when the listener is registered and then only calls taskHandler with these tasks.
+     * An empty list, which is the default, means the listener is called with all the tasks.
+     */
+    virtual std::vector<TaskTypeId> getHandledTaskTypes()
+    {
+        return {};
+    }
 };
\ No newline at end of file
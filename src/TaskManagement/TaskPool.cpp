@@ -0,0 +1,59 @@
+#include "TaskPool.h"
+#include <new>
+
+TaskPoolStorage::TaskPoolStorage(size_t _maxCachedBlocks)
+    : maxCachedBlocks(_maxCachedBlocks), blockSize(0), noHeapAllocations(0), noRecycledAllocations(0)
+{
+    freeBlocks.reserve(maxCachedBlocks);
+}
+
+TaskPoolStorage::~TaskPoolStorage()
+{
+    for (size_t i = 0; i < freeBlocks.size(); i++)
+    {
+        ::operator delete(freeBlocks[i]);
+    }
+}
+
+void *TaskPoolStorage::allocate(size_t noBytes)
+{
+    {
+        std::lock_guard lock(mutex);
+        if (blockSize == 0)
+        {
+            blockSize = noBytes;
+        }
+        if (noBytes == blockSize && freeBlocks.size() > 0)
+        {
+            void *block = freeBlocks.back();
+            freeBlocks.pop_back();
+            noRecycledAllocations++;
+            return block;
+        }
+    }
+    noHeapAllocations++;
+    return ::operator new(noBytes);
+}
+
+void TaskPoolStorage::deallocate(void *block, size_t noBytes)
+{
+    {
+        std::lock_guard lock(mutex);
+        if (noBytes == blockSize && freeBlocks.size() < maxCachedBlocks)
+        {
+            freeBlocks.push_back(block);
+            return;
+        }
+    }
+    ::operator delete(block);
+}
+
+uint64_t TaskPoolStorage::getNoHeapAllocations() const
+{
+    return noHeapAllocations;
+}
+
+uint64_t TaskPoolStorage::getNoRecycledAllocations() const
+{
+    return noRecycledAllocations;
+}
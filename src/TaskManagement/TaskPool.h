@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The memory of a TaskPool. It keeps the blocks of the tasks that were destroyed
+ * to give them to the next tasks instead of going through the heap. Blocks are allocated
+ * from the heap the first time they are needed, so it never allocates once it has warmed up.
+ * It is thread safe, as tasks are created and destroyed from different threads.
+ */
+class TaskPoolStorage
+{
+  public:
+    /**
+     * @brief Create a storage keeping up to maxCachedBlocks free blocks.
+     */
+    TaskPoolStorage(size_t maxCachedBlocks);
+
+    /**
+     * @brief Free the cached blocks.
+     */
+    ~TaskPoolStorage();
+
+    /**
+     * @brief Get a block of noBytes bytes, recycled if one is cached.
+     * The storage only recycles blocks of the size of the first allocation.
+     *
+     * @param noBytes size of the block
+     * @return void* the block
+     */
+    void *allocate(size_t noBytes);
+
+    /**
+     * @brief Give a block back, it is cached if the cache is not full or freed otherwise.
+     *
+     * @param block the block from allocate
+     * @param noBytes size it was allocated with
+     */
+    void deallocate(void *block, size_t noBytes);
+
+    /**
+     * @brief Number of blocks that had to be allocated from the heap since the storage was created.
+     */
+    uint64_t getNoHeapAllocations() const;
+
+    /**
+     * @brief Number of blocks that were recycled since the storage was created.
+     */
+    uint64_t getNoRecycledAllocations() const;
+
+  private:
+    std::mutex mutex;                            /**< protects freeBlocks and blockSize */
+    std::vector<void *> freeBlocks;              /**< cached blocks, its capacity is reserved so it never grows */
+    size_t maxCachedBlocks;                      /**< maximum number of cached blocks */
+    size_t blockSize;                            /**< size of the recycled blocks, 0 until the first allocation */
+    std::atomic<uint64_t> noHeapAllocations;     /**< number of blocks allocated from the heap */
+    std::atomic<uint64_t> noRecycledAllocations; /**< number of blocks that came from freeBlocks */
+};
+
+/**
+ * @brief Allocator used by TaskPool with std::allocate_shared. The shared_ptr control block
+ * keeps a copy of it, and so keeps the storage alive until the last task is released.
+ */
+template <typename T> class TaskPoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    TaskPoolAllocator(std::shared_ptr<TaskPoolStorage> s) : storage(std::move(s))
+    {
+    }
+
+    template <typename U> TaskPoolAllocator(const TaskPoolAllocator<U> &other) : storage(other.storage)
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(storage->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        storage->deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U> bool operator==(const TaskPoolAllocator<U> &other) const
+    {
+        return storage == other.storage;
+    }
+
+    template <typename U> bool operator!=(const TaskPoolAllocator<U> &other) const
+    {
+        return storage != other.storage;
+    }
+
+    std::shared_ptr<TaskPoolStorage> storage; /**< where the memory comes from */
+};
+
+/**
+ * @brief Creates tasks of type T in recycled memory, for the task types that are broadcasted
+ * at a high rate. The task and its shared_ptr control block are allocated together in a block
+ * that goes back to the pool when the last reference to the task is released.
+ */
+template <typename T> class TaskPool
+{
+  public:
+    /**
+     * @brief Create a pool.
+     *
+     * @param maxCachedTasks maximum number of freed tasks memory blocks kept for reuse
+     */
+    TaskPool(size_t maxCachedTasks) : storage(std::make_shared<TaskPoolStorage>(maxCachedTasks))
+    {
+    }
+
+    /**
+     * @brief Create a task, just like std::make_shared would.
+     */
+    template <typename... Args> std::shared_ptr<T> make(Args &&...args)
+    {
+        return std::allocate_shared<T>(TaskPoolAllocator<T>(storage), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Number of tasks whose memory had to be allocated from the heap.
+     */
+    uint64_t getNoHeapAllocations() const
+    {
+        return storage->getNoHeapAllocations();
+    }
+
+    /**
+     * @brief Number of tasks whose memory was recycled.
+     */
+    uint64_t getNoRecycledAllocations() const
+    {
+        return storage->getNoRecycledAllocations();
+    }
+
+  private:
+    std::shared_ptr<TaskPoolStorage> storage; /**< the memory of the tasks */
+};
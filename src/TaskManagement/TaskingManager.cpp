@@ -2,16 +2,32 @@
 #include "Task.h"
 #include "TaskListener.h"
 #include "spdlog/spdlog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
 
-TaskingManager::TaskingManager() : lastUsedTaskListenerId(-1)
+thread_local TaskingManager *TaskingManager::laneThreadOwner = nullptr;
+thread_local size_t TaskingManager::laneThreadIndex = 0;
+
+TaskingManager::TaskingManager() : historySizeInBytes(0), lastUsedTaskListenerId(-1)
 {
-    backgroundThreadIsRunning = false;
+    noRunningLanes = 0;
+    noCoalescedTasks = 0;
+    taskJournalEnabled = false;
     taskBroadcastStopped = true;
-    historyNextIndex = 0;
+    for (size_t i = 0; i < NO_TASK_LANES; i++)
+    {
+        lanes[i].highPriorityTasksQueued = false;
+        lanes[i].listenersReadVersion = 0;
+    }
+    // versions start at 1 as 0 tells that a lane is not reading the listeners
+    listenersVersion = 1;
+    listenersSnapshot = new ListenersSnapshot();
     registerTaskListener(this);
 }
 
@@ -19,17 +35,13 @@ TaskingManager::~TaskingManager()
 {
     std::lock_guard<std::mutex> lock(taskingThreadStartMutex);
 
-    if (taskingThread != nullptr)
+    if (lanes[TASK_LANE_CONTROL].taskingThread != nullptr)
     {
-        {
-            std::lock_guard<std::mutex> lock2(taskQueueMutex);
-            taskBroadcastStopped = true;
-        }
-        taskingThreadCV.notify_all();
-        taskingThread->join();
-        taskingThread.reset(nullptr);
-        spdlog::info("TaskingManager tasking thread has been stopped");
+        stopAndJoinLanes();
+        spdlog::info("TaskingManager tasking threads have been stopped");
     }
+    // the retired snapshots are deleted with the vector
+    delete listenersSnapshot.load();
     spdlog::info("TaskingManager destroyed");
 }
 
@@ -37,14 +49,14 @@ void TaskingManager::startTaskBroadcast()
 {
     std::lock_guard<std::mutex> lock(taskingThreadStartMutex);
 
-    if (taskingThread == nullptr)
+    if (lanes[TASK_LANE_CONTROL].taskingThread == nullptr)
     {
+        taskBroadcastStopped = false;
+        for (size_t i = 0; i < NO_TASK_LANES; i++)
         {
-            std::lock_guard<std::mutex> lock2(taskQueueMutex);
-            taskBroadcastStopped = false;
+            lanes[i].taskingThread = std::make_unique<std::thread>(&TaskingManager::taskingThreadLoop, this, i);
         }
-        taskingThread = std::make_unique<std::thread>(&TaskingManager::taskingThreadLoop, this);
-        spdlog::info("TaskingManager tasking thread has been started");
+        spdlog::info("TaskingManager tasking threads have been started");
     }
     else
     {
@@ -57,16 +69,10 @@ void TaskingManager::stopTaskBroadcast()
 {
     std::lock_guard<std::mutex> lock(taskingThreadStartMutex);
 
-    if (taskingThread != nullptr)
+    if (lanes[TASK_LANE_CONTROL].taskingThread != nullptr)
     {
-        {
-            std::lock_guard<std::mutex> lock2(taskQueueMutex);
-            taskBroadcastStopped = true;
-        }
-        taskingThreadCV.notify_all();
-        taskingThread->join();
-        taskingThread.reset(nullptr);
-        spdlog::info("TaskingManager tasking thread has been stopped");
+        stopAndJoinLanes();
+        spdlog::info("TaskingManager tasking threads have been stopped");
     }
     else
     {
@@ -75,125 +81,371 @@ void TaskingManager::stopTaskBroadcast()
     }
 }
 
-void TaskingManager::taskingThreadLoop()
+void TaskingManager::stopAndJoinLanes()
+{
+    shutdownBackgroundThreadAsync();
+    for (size_t i = 0; i < NO_TASK_LANES; i++)
+    {
+        lanes[i].taskingThread->join();
+        lanes[i].taskingThread.reset(nullptr);
+    }
+}
+
+void TaskingManager::takeQueuedTasks(Lane &lane, size_t priority, std::deque<std::shared_ptr<Task>> &destination)
+{
+    TaskQueue &queue = lane.queues[priority];
+    if (destination.size() == 0)
+    {
+        destination.swap(queue.tasks);
+    }
+    else
+    {
+        std::move(queue.tasks.begin(), queue.tasks.end(), std::back_inserter(destination));
+        queue.tasks.clear();
+    }
+    // the indexes were the ones in the queue we just took
+    queue.coalescingKeys.clear();
+    if (priority == TASK_PRIORITY_HIGH)
+    {
+        lane.highPriorityTasksQueued = false;
+    }
+}
+
+void TaskingManager::taskingThreadLoop(size_t laneIndex)
 {
-    backgroundThreadIsRunning = true;
-    size_t lastQueueSize;
+    noRunningLanes++;
+    // lets the thread checks compare thread local variables instead of locking to read the thread ids
+    laneThreadOwner = this;
+    laneThreadIndex = laneIndex;
+    Lane &lane = lanes[laneIndex];
+    // the tasks of each priority taken from the lane queues at once, swapped with the empty lane queues
+    std::array<std::deque<std::shared_ptr<Task>>, NO_TASK_PRIORITIES> pendingTasks;
+    size_t noPendingTasks = 0;
     std::shared_ptr<Task> currentTask;
     // looping on successive wake ups from condition variable (or timeouts thereof)
     while (true)
     {
-        // looping on the tasks that remains in the task queue (with potential exit if asked to stop)
-        while (true)
+        // wait on condition variable with timeout, and take all the queued tasks under the same lock
         {
-            // fetch size of queue
+            std::unique_lock<std::mutex> queueLock(lane.taskQueueMutex);
+            lane.taskingThreadCV.wait_for(queueLock, std::chrono::seconds(1), [this, &lane] {
+                return taskBroadcastStopped || lane.queues[TASK_PRIORITY_HIGH].tasks.size() > 0 ||
+                       lane.queues[TASK_PRIORITY_NORMAL].tasks.size() > 0;
+            });
+            // abort if the thread is currently being stopped
+            if (taskBroadcastStopped)
             {
-                std::lock_guard<std::mutex> lock(taskQueueMutex);
-                lastQueueSize = taskQueue.size();
-                // abort if the thread is currently being stopped
-                if (taskBroadcastStopped)
-                {
-                    backgroundThreadIsRunning = false;
-                    return;
-                }
+                laneThreadOwner = nullptr;
+                noRunningLanes--;
+                return;
             }
-            // if size == 0 or task broadcast was stopped, break
-            if (lastQueueSize <= 0)
+            for (size_t priority = 0; priority < NO_TASK_PRIORITIES; priority++)
             {
-                break;
-            }
-            // if size > 0, pull and process task
-            {
-                std::lock_guard<std::mutex> lock(taskQueueMutex);
-                currentTask = taskQueue.front();
-                taskQueue.pop();
-            }
-            // this should not happen because we are the only thread reading/popin the queue.
-            if (currentTask == nullptr)
-            {
-                spdlog::warn("A queue item was removed since the tasking thread last fetched size. This should not "
-                             "happen.");
-                break;
+                takeQueuedTasks(lane, priority, pendingTasks[priority]);
             }
+            noPendingTasks = pendingTasks[TASK_PRIORITY_HIGH].size() + pendingTasks[TASK_PRIORITY_NORMAL].size();
+        }
 
-            // core tasking code that iterate over listeners
+        // looping on the tasks that were taken (with potential exit if asked to stop)
+        while (noPendingTasks > 0)
+        {
+            if (taskBroadcastStopped)
             {
-                std::lock_guard<std::mutex> lock(taskListenersMutex);
-                for (size_t i = 0; i < taskListeners.size(); i++)
+                // keep the tasks we did not broadcast in case the broadcast is restarted
+                std::lock_guard<std::mutex> lock(lane.taskQueueMutex);
+                for (size_t priority = 0; priority < NO_TASK_PRIORITIES; priority++)
                 {
-                    bool shouldStop = taskListeners[i]->taskHandler(currentTask);
-                    if (shouldStop)
-                    {
-                        break;
-                    }
+                    TaskQueue &queue = lane.queues[priority];
+                    queue.tasks.insert(queue.tasks.begin(), pendingTasks[priority].begin(),
+                                       pendingTasks[priority].end());
+                    // the indexes moved, the tasks queued before the restart just won't be coalesced
+                    queue.coalescingKeys.clear();
+                    pendingTasks[priority].clear();
                 }
+                laneThreadOwner = nullptr;
+                noRunningLanes--;
+                return;
+            }
+
+            // the high priority tasks queued while we go through a backlog jump ahead of it
+            if (lane.highPriorityTasksQueued)
+            {
+                std::lock_guard<std::mutex> lock(lane.taskQueueMutex);
+                size_t noTakenTasks = lane.queues[TASK_PRIORITY_HIGH].tasks.size();
+                takeQueuedTasks(lane, TASK_PRIORITY_HIGH, pendingTasks[TASK_PRIORITY_HIGH]);
+                noPendingTasks += noTakenTasks;
             }
-            if (currentTask->goesInTaskHistory() && currentTask->isCompleted() && !currentTask->hasFailed())
+
+            auto &nextTasks = pendingTasks[TASK_PRIORITY_HIGH].size() > 0 ? pendingTasks[TASK_PRIORITY_HIGH]
+                                                                           : pendingTasks[TASK_PRIORITY_NORMAL];
+            currentTask = std::move(nextTasks.front());
+            nextTasks.pop_front();
+            noPendingTasks--;
+
+            // core tasking code that iterate over listeners, the version tells the purges which
+            // snapshots we may be reading instead of locking them out
+            lane.listenersReadVersion = listenersVersion.load();
+            dispatchTask(currentTask);
+            lane.listenersReadVersion = 0;
+            // only the control lane owns the history, and only the tasks that can be undone are worth keeping
+            if (laneIndex == TASK_LANE_CONTROL && currentTask->goesInTaskHistory() && currentTask->supportsUndo() &&
+                currentTask->isCompleted() && !currentTask->hasFailed())
             {
                 recordTaskInHistory(currentTask);
             }
+            currentTask = nullptr;
         }
-
-        // wait on condition variable with timeout
-        std::unique_lock<std::mutex> queueLock(taskQueueMutex);
-        taskingThreadCV.wait_for(queueLock, std::chrono::seconds(1),
-                                 [this] { return taskBroadcastStopped || taskQueue.size() > 0; });
     }
 }
 
 void TaskingManager::broadcastTask(std::shared_ptr<Task> submittedTask)
 {
     submittedTask->setTaskingManager(this);
+    if (taskJournalEnabled)
+    {
+        recordTaskInJournal(*submittedTask);
+    }
+    // the tasks that go in history are recorded by the control lane
+    size_t laneIndex = submittedTask->goesInTaskHistory() ? TASK_LANE_CONTROL : submittedTask->getTaskLane();
+    Lane &lane = lanes[laneIndex];
+    size_t priority = submittedTask->getTaskPriority();
+    TaskQueue &queue = lane.queues[priority];
+    uint64_t coalescingKey = submittedTask->goesInTaskHistory() ? NO_COALESCING_KEY : submittedTask->getCoalescingKey();
+    bool laneWasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(lane.taskQueueMutex);
+        if (coalescingKey != NO_COALESCING_KEY)
+        {
+            // there are only a few keys, a vector that keeps its capacity is cheaper than a map
+            for (size_t i = 0; i < queue.coalescingKeys.size(); i++)
+            {
+                if (queue.coalescingKeys[i].first == coalescingKey)
+                {
+                    // the older task is never delivered, and the queue was not empty so no need to notify
+                    queue.tasks[queue.coalescingKeys[i].second] = std::move(submittedTask);
+                    noCoalescedTasks++;
+                    return;
+                }
+            }
+            queue.coalescingKeys.emplace_back(coalescingKey, queue.tasks.size());
+        }
+        laneWasEmpty =
+            lane.queues[TASK_PRIORITY_HIGH].tasks.size() == 0 && lane.queues[TASK_PRIORITY_NORMAL].tasks.size() == 0;
+        queue.tasks.push_back(std::move(submittedTask));
+        if (priority == TASK_PRIORITY_HIGH)
+        {
+            lane.highPriorityTasksQueued = true;
+        }
+    }
+    // the lane thread only waits when its queues are empty, and it takes all the queued tasks at once
+    if (laneWasEmpty)
+    {
+        lane.taskingThreadCV.notify_one();
+    }
+}
+
+void TaskingManager::startTaskJournal(const std::string &path)
+{
+    auto newJournal = std::make_unique<TaskJournalWriter>(path);
+    std::lock_guard<std::mutex> lock(taskJournalMutex);
+    taskJournal = std::move(newJournal);
+    taskJournalStart = std::chrono::steady_clock::now();
+    taskJournalEnabled = true;
+    spdlog::info("Recording broadcasted tasks in the task journal {}", path);
+}
+
+void TaskingManager::stopTaskJournal()
+{
+    std::lock_guard<std::mutex> lock(taskJournalMutex);
+    taskJournalEnabled = false;
+    if (taskJournal != nullptr)
+    {
+        spdlog::info("Recorded {} tasks in the task journal", taskJournal->getNoRecords());
+        taskJournal.reset();
+    }
+}
+
+void TaskingManager::recordTaskInJournal(Task &task)
+{
+    uint32_t binaryTag = task.getBinaryTag();
+    if (binaryTag == NO_BINARY_TASK_TAG)
+    {
+        return;
+    }
+    // each broadcasting thread keeps its encoding buffer so it does not allocate once warm
+    thread_local TaskBinaryWriter encoder;
+    encoder.clear();
+    task.serializeBinary(encoder);
+
+    std::lock_guard<std::mutex> lock(taskJournalMutex);
+    if (taskJournal == nullptr)
+    {
+        return;
+    }
+    auto timestamp = std::chrono::steady_clock::now() - taskJournalStart;
+    try
+    {
+        taskJournal->append(binaryTag, (uint64_t)std::chrono::nanoseconds(timestamp).count(), encoder.data(),
+                            encoder.size());
+    }
+    catch (std::runtime_error &err)
     {
-        std::lock_guard<std::mutex> lock(taskQueueMutex);
-        taskQueue.push(submittedTask);
+        // a full disk must not break the app, so the recording stops there
+        spdlog::error("Stopped recording the task journal: {}", err.what());
+        taskJournalEnabled = false;
+        taskJournal.reset();
     }
-    taskingThreadCV.notify_all();
 }
 
 int64_t TaskingManager::registerTaskListener(TaskListener *newListener)
 {
+    // called before locking as it may allocate the type ids
+    std::vector<TaskTypeId> handledTypes = newListener->getHandledTaskTypes();
+
     std::lock_guard<std::mutex> lock(taskListenersMutex);
+    auto newSnapshot = std::make_unique<ListenersSnapshot>(*listenersSnapshot.load());
     int64_t newId = lastUsedTaskListenerId + 1;
     lastUsedTaskListenerId = newId;
-    taskListeners.push_back(newListener);
-    taskListenersIds.push_back(newId);
+    newSnapshot->taskListeners.push_back(newListener);
+    newSnapshot->taskListenersIds.push_back(newId);
+    newSnapshot->taskListenersTypes.push_back(handledTypes);
+    rebuildDispatchTable(*newSnapshot);
+    publishListenersSnapshot(std::move(newSnapshot));
+    // the lanes that still read the previous snapshot will be done with it later
+    reclaimListenersSnapshots();
     return newId;
 }
 
 void TaskingManager::purgeTaskListener(int64_t idToRemove)
 {
     std::lock_guard<std::mutex> lock(taskListenersMutex);
+    const ListenersSnapshot *currentSnapshot = listenersSnapshot.load();
+
+    auto newSnapshot = std::make_unique<ListenersSnapshot>();
+    newSnapshot->taskListeners.reserve(currentSnapshot->taskListeners.size());
+    newSnapshot->taskListenersIds.reserve(currentSnapshot->taskListeners.size());
+    newSnapshot->taskListenersTypes.reserve(currentSnapshot->taskListeners.size());
+
+    for (size_t i = 0; i < currentSnapshot->taskListeners.size(); i++)
+    {
+        if (currentSnapshot->taskListenersIds[i] != idToRemove)
+        {
+            newSnapshot->taskListeners.push_back(currentSnapshot->taskListeners[i]);
+            newSnapshot->taskListenersIds.push_back(currentSnapshot->taskListenersIds[i]);
+            newSnapshot->taskListenersTypes.push_back(currentSnapshot->taskListenersTypes[i]);
+        }
+    }
 
-    std::vector<TaskListener *> newTaskListeners;
-    std::vector<int64_t> newTaskListersIds;
+    rebuildDispatchTable(*newSnapshot);
+    publishListenersSnapshot(std::move(newSnapshot));
+    // the caller may destroy the listener once we return, so no other lane must still be calling it
+    waitForListenersReaders();
+    reclaimListenersSnapshots();
+}
 
-    newTaskListeners.reserve(taskListeners.size());
-    newTaskListersIds.reserve(taskListeners.size());
+void TaskingManager::publishListenersSnapshot(std::unique_ptr<ListenersSnapshot> snapshot)
+{
+    const ListenersSnapshot *previousSnapshot = listenersSnapshot.exchange(snapshot.release());
+    // a lane that reads this version or a later one loaded the new snapshot
+    uint64_t newVersion = ++listenersVersion;
+    retiredListenersSnapshots.emplace_back(previousSnapshot, newVersion);
+}
 
-    for (size_t i = 0; i < taskListeners.size(); i++)
+void TaskingManager::waitForListenersReaders()
+{
+    uint64_t currentVersion = listenersVersion.load();
+    for (size_t i = 0; i < NO_TASK_LANES; i++)
     {
-        if (taskListenersIds[i] != idToRemove)
+        // a lane purging from a taskHandler would wait for itself
+        if (laneThreadOwner == this && laneThreadIndex == i)
         {
-            newTaskListeners.push_back(taskListeners[i]);
-            newTaskListersIds.push_back(taskListenersIds[i]);
+            continue;
+        }
+        while (true)
+        {
+            uint64_t readVersion = lanes[i].listenersReadVersion.load();
+            if (readVersion == 0 || readVersion >= currentVersion)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
         }
     }
+}
 
-    taskListeners.swap(newTaskListeners);
-    taskListenersIds.swap(newTaskListersIds);
+void TaskingManager::reclaimListenersSnapshots()
+{
+    // the oldest version a lane may be reading, the snapshots replaced by then are not read anymore
+    uint64_t oldestReadVersion = UINT64_MAX;
+    for (size_t i = 0; i < NO_TASK_LANES; i++)
+    {
+        uint64_t readVersion = lanes[i].listenersReadVersion.load();
+        if (readVersion != 0)
+        {
+            oldestReadVersion = std::min(oldestReadVersion, readVersion);
+        }
+    }
+    size_t noReclaimable = 0;
+    while (noReclaimable < retiredListenersSnapshots.size() &&
+           retiredListenersSnapshots[noReclaimable].second <= oldestReadVersion)
+    {
+        noReclaimable++;
+    }
+    retiredListenersSnapshots.erase(retiredListenersSnapshots.begin(),
+                                    retiredListenersSnapshots.begin() + (long)noReclaimable);
 }
 
-void TaskingManager::broadcastNestedTaskNow(std::shared_ptr<Task> priorityTask)
+void TaskingManager::rebuildDispatchTable(ListenersSnapshot &snapshot)
 {
-    throwIfCallerIsNotTaskingThread("broadcastNestedTaskNow");
-    priorityTask->setTaskingManager(this);
+    // the table needs an entry up to the highest type a listener handles
+    size_t tableSize = UNTYPED_TASK_TYPE_ID + 1;
+    for (size_t i = 0; i < snapshot.taskListenersTypes.size(); i++)
+    {
+        for (size_t j = 0; j < snapshot.taskListenersTypes[i].size(); j++)
+        {
+            tableSize = std::max(tableSize, (size_t)snapshot.taskListenersTypes[i][j] + 1);
+        }
+    }
 
-    // NOTE: we don't record nested tasks in history
+    snapshot.listenersPerTaskType.assign(tableSize, std::vector<TaskListener *>());
+    for (size_t i = 0; i < snapshot.taskListeners.size(); i++)
+    {
+        if (snapshot.taskListenersTypes[i].size() == 0)
+        {
+            // listeners handling all tasks are in every entry, in registration order
+            for (size_t type = 0; type < tableSize; type++)
+            {
+                snapshot.listenersPerTaskType[type].push_back(snapshot.taskListeners[i]);
+            }
+        }
+        else
+        {
+            for (size_t j = 0; j < snapshot.taskListenersTypes[i].size(); j++)
+            {
+                auto &typeListeners = snapshot.listenersPerTaskType[snapshot.taskListenersTypes[i][j]];
+                // don't call a listener twice if it lists a type twice
+                if (typeListeners.size() == 0 || typeListeners.back() != snapshot.taskListeners[i])
+                {
+                    typeListeners.push_back(snapshot.taskListeners[i]);
+                }
+            }
+        }
+    }
+}
 
-    for (size_t i = 0; i < taskListeners.size(); i++)
+void TaskingManager::dispatchTask(const std::shared_ptr<Task> &task)
+{
+    const ListenersSnapshot *snapshot = listenersSnapshot.load();
+    size_t taskType = task->getTaskTypeId();
+    if (taskType >= snapshot->listenersPerTaskType.size())
+    {
+        // no listener asked for this type, only the listeners of all tasks get it
+        taskType = UNTYPED_TASK_TYPE_ID;
+    }
+    auto &typeListeners = snapshot->listenersPerTaskType[taskType];
+    for (size_t i = 0; i < typeListeners.size(); i++)
     {
-        bool shouldStop = taskListeners[i]->taskHandler(priorityTask);
+        bool shouldStop = typeListeners[i]->taskHandler(task);
         if (shouldStop)
         {
             break;
@@ -201,14 +453,34 @@ void TaskingManager::broadcastNestedTaskNow(std::shared_ptr<Task> priorityTask)
     }
 }
 
+void TaskingManager::broadcastNestedTaskNow(std::shared_ptr<Task> priorityTask)
+{
+    throwIfCallerIsNotTaskingThread("broadcastNestedTaskNow");
+    priorityTask->setTaskingManager(this);
+
+    // NOTE: we don't record nested tasks in history
+
+    dispatchTask(priorityTask);
+}
+
 void TaskingManager::throwIfCallerIsNotTaskingThread(std::string caller)
 {
-    std::lock_guard<std::mutex> lock(taskingThreadStartMutex);
-    if (std::this_thread::get_id() != taskingThread->get_id())
+    if (laneThreadOwner == this)
+    {
+        return;
+    }
+    throw std::runtime_error("Trying to call " + caller +
+                             " from outside the tasking threads. It can only "
+                             "be called from within the TaskListeners's taskHandler code.");
+}
+
+void TaskingManager::throwIfCallerIsNotControlLaneThread(std::string caller)
+{
+    if (laneThreadOwner != this || laneThreadIndex != TASK_LANE_CONTROL)
     {
         throw std::runtime_error("Trying to call " + caller +
-                                 " from outside the tasking thread. It can only "
-                                 "be called from within the TaskListeners's taskHandler code.");
+                                 " from outside the control lane tasking thread. It can only "
+                                 "be called from within the TaskListeners's taskHandler code of control lane tasks.");
     }
 }
 
@@ -219,7 +491,7 @@ bool TaskingManager::taskHandler(std::shared_ptr<Task> task)
     // So this is the only task implementation where we don't need to use broadcastNestedTaskNow
     // to let others now of success.
 
-    auto cancelTask = std::dynamic_pointer_cast<CancelTask>(task);
+    auto cancelTask = taskCast<CancelTask>(task);
     if (cancelTask != nullptr && !cancelTask->isCompleted() && !cancelTask->hasFailed())
     {
         bool success = undoLastActivity();
@@ -237,7 +509,7 @@ bool TaskingManager::taskHandler(std::shared_ptr<Task> task)
         }
     }
 
-    auto restoreTask = std::dynamic_pointer_cast<RestoreTask>(task);
+    auto restoreTask = taskCast<RestoreTask>(task);
     if (restoreTask != nullptr && !restoreTask->isCompleted() && !restoreTask->hasFailed())
     {
         bool success = redoLastActivity();
@@ -255,7 +527,7 @@ bool TaskingManager::taskHandler(std::shared_ptr<Task> task)
         }
     }
 
-    auto clearHistoryTask = std::dynamic_pointer_cast<ClearHistoryTask>(task);
+    auto clearHistoryTask = taskCast<ClearHistoryTask>(task);
     if (clearHistoryTask != nullptr && !clearHistoryTask->isCompleted() && !clearHistoryTask->hasFailed())
     {
         clearTaskHistory();
@@ -267,9 +539,14 @@ bool TaskingManager::taskHandler(std::shared_ptr<Task> task)
     return false;
 }
 
+std::vector<TaskTypeId> TaskingManager::getHandledTaskTypes()
+{
+    return {getTaskTypeIdOf<CancelTask>(), getTaskTypeIdOf<RestoreTask>(), getTaskTypeIdOf<ClearHistoryTask>()};
+}
+
 void TaskingManager::recordTaskInHistory(std::shared_ptr<Task> taskToRecord)
 {
-    throwIfCallerIsNotTaskingThread("recordTaskInHistory");
+    throwIfCallerIsNotControlLaneThread("recordTaskInHistory");
 
     // we always empty the canceled task stack
     // after a new task is performed to
@@ -281,35 +558,44 @@ void TaskingManager::recordTaskInHistory(std::shared_ptr<Task> taskToRecord)
         canceledTasks.pop();
     }
 
-    history[historyNextIndex] = taskToRecord;
-    historyNextIndex = (historyNextIndex + 1) % ACTIVITY_HISTORY_RING_BUFFER_SIZE;
+    pushInHistory(std::move(taskToRecord));
+}
+
+void TaskingManager::pushInHistory(std::shared_ptr<Task> taskToRecord)
+{
+    size_t sizeInBytes = taskToRecord->getHistorySizeInBytes();
+    history.push_back(HistoryEntry{std::move(taskToRecord), sizeInBytes});
+    historySizeInBytes += sizeInBytes;
+
+    // the most recent task is kept even if it is alone above the limit
+    while (historySizeInBytes > ACTIVITY_HISTORY_MAX_BYTES && history.size() > 1)
+    {
+        historySizeInBytes -= history.front().sizeInBytes;
+        history.pop_front();
+    }
 }
 
 bool TaskingManager::undoLastActivity()
 {
-    throwIfCallerIsNotTaskingThread("undoLastActivity");
+    throwIfCallerIsNotControlLaneThread("undoLastActivity");
 
     bool cancelingNextTask = true;
 
     while (cancelingNextTask)
     {
-        int lastActivityIndex = (historyNextIndex - 1) % ACTIVITY_HISTORY_RING_BUFFER_SIZE;
-        if (lastActivityIndex < 0)
-        {
-            lastActivityIndex += ACTIVITY_HISTORY_RING_BUFFER_SIZE;
-        }
-
-        if (history[lastActivityIndex] == nullptr)
+        if (history.empty())
         {
             spdlog::info("Trying to cancel last task but there is no activity in history");
             return false;
         }
 
+        std::shared_ptr<Task> lastActivity = history.back().task;
+
         // we are saving the group index so that we can decide on canceling next
         // task if it's from the same task group
-        int taskGroupIndex = history[lastActivityIndex]->getTaskGroupIndex();
+        int taskGroupIndex = lastActivity->getTaskGroupIndex();
 
-        auto tasksToCancel = history[lastActivityIndex]->getOppositeTasks();
+        auto tasksToCancel = lastActivity->getOppositeTasks();
         if (tasksToCancel.size() == 0)
         {
             spdlog::info("This task cannot be canceled (no opposite task set)");
@@ -319,35 +605,16 @@ bool TaskingManager::undoLastActivity()
         for (size_t i = 0; i < tasksToCancel.size(); i++)
         {
             tasksToCancel[i]->declareSelfAsPartOfReversion();
-            for (size_t j = 0; j < taskListeners.size(); j++)
-            {
-                bool shouldStop = taskListeners[j]->taskHandler(tasksToCancel[i]);
-                if (shouldStop)
-                {
-                    break;
-                }
-            }
+            dispatchTask(tasksToCancel[i]);
         }
 
-        canceledTasks.push(history[lastActivityIndex]);
+        canceledTasks.push(lastActivity);
 
-        history[lastActivityIndex] = nullptr;
-        historyNextIndex = lastActivityIndex;
+        historySizeInBytes -= history.back().sizeInBytes;
+        history.pop_back();
 
-        // if the next task exists and has same task group id, we cancel it as well by calling us again
-        lastActivityIndex = (historyNextIndex - 1) % ACTIVITY_HISTORY_RING_BUFFER_SIZE;
-        if (lastActivityIndex < 0)
-        {
-            lastActivityIndex += ACTIVITY_HISTORY_RING_BUFFER_SIZE;
-        }
-        if (history[lastActivityIndex] != nullptr && history[lastActivityIndex]->getTaskGroupIndex() == taskGroupIndex)
-        {
-            cancelingNextTask = true;
-        }
-        else
-        {
-            cancelingNextTask = false;
-        }
+        // if the next task exists and has same task group id, we cancel it as well
+        cancelingNextTask = !history.empty() && history.back().task->getTaskGroupIndex() == taskGroupIndex;
     }
 
     return true;
@@ -355,7 +622,7 @@ bool TaskingManager::undoLastActivity()
 
 bool TaskingManager::redoLastActivity()
 {
-    throwIfCallerIsNotTaskingThread("redoLastActivity");
+    throwIfCallerIsNotControlLaneThread("redoLastActivity");
 
     bool restoringNextTask = true;
 
@@ -377,17 +644,9 @@ bool TaskingManager::redoLastActivity()
         taskToRestore->preventFromGoingToTaskHistory();
         taskToRestore->declareSelfAsPartOfReversion();
 
-        for (size_t j = 0; j < taskListeners.size(); j++)
-        {
-            bool shouldStop = taskListeners[j]->taskHandler(taskToRestore);
-            if (shouldStop)
-            {
-                break;
-            }
-        }
+        dispatchTask(taskToRestore);
 
-        history[historyNextIndex] = taskToRestore;
-        historyNextIndex = (historyNextIndex + 1) % ACTIVITY_HISTORY_RING_BUFFER_SIZE;
+        pushInHistory(taskToRestore);
 
         // if the next canceled task exists and has same task group id, we restore it as well
         if (!canceledTasks.empty() && canceledTasks.top()->getTaskGroupIndex() == taskGroupIndex)
@@ -405,39 +664,42 @@ bool TaskingManager::redoLastActivity()
 
 void TaskingManager::clearTaskHistory()
 {
-    throwIfCallerIsNotTaskingThread("clearTaskHistory");
+    throwIfCallerIsNotControlLaneThread("clearTaskHistory");
 
     std::stack<std::shared_ptr<Task>> emptyTaskStack;
     canceledTasks.swap(emptyTaskStack);
 
     // this will free a lot of stuff since we dereference smart pointers
-    for (int i = 0; i < ACTIVITY_HISTORY_RING_BUFFER_SIZE; i++)
-    {
-        history[i] = nullptr;
-    }
-
-    // this is quite useless but I like it like this
-    historyNextIndex = 0;
+    history.clear();
+    historySizeInBytes = 0;
 
     spdlog::debug("Cleared task history");
 }
 
 void TaskingManager::shutdownBackgroundThreadAsync()
 {
+    taskBroadcastStopped = true;
+    for (size_t i = 0; i < NO_TASK_LANES; i++)
     {
-        std::lock_guard<std::mutex> lock2(taskQueueMutex);
-        taskBroadcastStopped = true;
+        // taking the lock ensures the lane thread is not between its predicate check and its wait
+        {
+            std::lock_guard<std::mutex> lock(lanes[i].taskQueueMutex);
+        }
+        lanes[i].taskingThreadCV.notify_all();
     }
-    taskingThreadCV.notify_all();
+}
+
+uint64_t TaskingManager::getNoCoalescedTasks()
+{
+    return noCoalescedTasks;
 }
 
 bool TaskingManager::isBackgroundThreadRunning()
 {
-    return backgroundThreadIsRunning;
+    return noRunningLanes > 0;
 }
 
 bool TaskingManager::shutdownWasCalled()
 {
-    std::lock_guard<std::mutex> lock2(taskQueueMutex);
     return taskBroadcastStopped;
-}
+}
\ No newline at end of file
@@ -1,16 +1,24 @@
 #pragma once
 
 #include "Task.h"
+#include "TaskBinaryStream.h"
+#include "TaskJournal.h"
 #include "TaskListener.h"
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <stack>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
-#define ACTIVITY_HISTORY_RING_BUFFER_SIZE 4096
+/**< Maximum memory retained by the task history, the oldest tasks are dropped beyond it */
+#define ACTIVITY_HISTORY_MAX_BYTES (16 * 1024 * 1024)
 
 /**
 Class responsible for app activity, for example tasks and history.
@@ -31,18 +39,25 @@ class TaskingManager : public TaskListener
     /**
      Add the TaskListener class to a list of objects which gets
      their callback called with the tasks when they are broadcasted.
+     Only the tasks whose type is in the listener getHandledTaskTypes are passed to it,
+     or all of them if it is empty.
      Returns an id that must be used later if using purgeTaskListener.
+     It never waits for the tasks being broadcasted, the lanes see the new listener
+     from their next task.
      */
     int64_t registerTaskListener(TaskListener *);
 
     /**
      * Tries to find the task listener and delete it from the list.
+     * It only waits for the tasks the lanes are broadcasting at the time of the call, so that the
+     * listener is no longer called once it returns and can be destroyed. If called from a taskHandler,
+     * the task being broadcasted by the caller lane can still reach the listener.
      */
     void purgeTaskListener(int64_t taskListenerId);
 
     /**
-     * Starts the task broadcasting thread. If not called
-     * the task are never broadcast and just wait in the queue.
+     * Starts the task broadcasting threads, one per TaskLane. If not called
+     * the task are never broadcast and just wait in the queues.
      */
     void startTaskBroadcast();
 
@@ -53,14 +68,35 @@ class TaskingManager : public TaskListener
     void stopTaskBroadcast();
 
     /**
-     Push a task in the queue for it to be picked and broadcasted by the
-     tasking thread if it's started.
+     Push a task in the queue of its lane and priority for it to be picked and broadcasted by the
+     lane tasking thread if it's started. If a task with the same coalescing key is
+     already waiting in the queue, this one replaces it.
      */
     void broadcastTask(std::shared_ptr<Task>);
 
+    /**
+     * @brief Number of tasks that were replaced by a newer one with the same coalescing key
+     * before being broadcasted.
+     */
+    uint64_t getNoCoalescedTasks();
+
+    /**
+     * @brief Start recording the tasks with a binary tag passed to broadcastTask in a task journal,
+     * along with the time they were broadcasted at, so that a TaskJournalReplayer can broadcast them again.
+     * Replaces the journal being recorded if any. Throws a std::runtime_error if the file can't be created.
+     *
+     * @param path path of the journal file
+     */
+    void startTaskJournal(const std::string &path);
+
+    /**
+     * @brief Stop recording the task journal and close its file, if one is being recorded.
+     */
+    void stopTaskJournal();
+
     /**
      This should only be called from an already running taskHandler.
-     Will call another taskHandler and jump the queue of tasks.
+     Will call another taskHandler and jump the queue of tasks, on the lane of the caller.
      */
     void broadcastNestedTaskNow(std::shared_ptr<Task>);
 
@@ -75,15 +111,20 @@ class TaskingManager : public TaskListener
     bool taskHandler(std::shared_ptr<Task> task) override;
 
     /**
-     * @brief Tells the background thread to stop without joining.
+     * @brief The TaskingManager only handles CancelTask, RestoreTask and ClearHistoryTask.
+     */
+    std::vector<TaskTypeId> getHandledTaskTypes() override;
+
+    /**
+     * @brief Tells the background threads to stop without joining.
      */
     void shutdownBackgroundThreadAsync();
 
     /**
-     * @brief Tells if the background thread is still running.
+     * @brief Tells if one of the background threads is still running.
      *
-     * @return true background thread is running
-     * @return false background thread is not running
+     * @return true a background thread is running
+     * @return false no background thread is running
      */
     bool isBackgroundThreadRunning();
 
@@ -97,24 +138,131 @@ class TaskingManager : public TaskListener
 
   private:
     /**
-     * The function that runs the thread
+     * @brief The tasks of a TaskPriority waiting in a lane.
+     */
+    struct TaskQueue
+    {
+        std::deque<std::shared_ptr<Task>> tasks;                 /**< the tasks to be broadcasted, in order */
+        std::vector<std::pair<uint64_t, size_t>> coalescingKeys; /**< keys of the queued tasks and their index */
+    };
+
+    /**
+     * @brief The queues and thread of a TaskLane.
+     */
+    struct Lane
+    {
+        std::array<TaskQueue, NO_TASK_PRIORITIES> queues; /**< the queue of each TaskPriority */
+        std::atomic<bool> highPriorityTasksQueued;        /**< tells the lane thread to take them between two tasks */
+        std::mutex taskQueueMutex;                        /**< synchronizes the queues access across threads */
+        std::condition_variable taskingThreadCV;          /**< Used to wake up the lane thread */
+        std::unique_ptr<std::thread> taskingThread;       /**< Reference to the eventually running lane thread */
+        std::atomic<uint64_t> listenersReadVersion;       /**< listenersVersion when the task being broadcasted
+                                                               was picked, or 0 if the lane is not broadcasting */
+    };
+
+    /**
+     * @brief An immutable version of the registered listeners. The lanes read the published one
+     * without locking, and a new one replaces it each time a listener is registered or purged.
+     */
+    struct ListenersSnapshot
+    {
+        std::vector<TaskListener *> taskListeners;                     /**< the objects we broadcast tasks to */
+        std::vector<int64_t> taskListenersIds;                         /**< identifier of each taskListeners */
+        std::vector<std::vector<TaskTypeId>> taskListenersTypes;       /**< types handled by each, or empty */
+        std::vector<std::vector<TaskListener *>> listenersPerTaskType; /**< ordered listeners to call per type id */
+    };
+
+    /**
+     * The function that runs the thread of a lane
      * that depile and run tasks.
+     *
+     * @param laneIndex the TaskLane this thread broadcasts the tasks of
+     */
+    void taskingThreadLoop(size_t laneIndex);
+
+    /**
+     * @brief Stop and join the lanes threads, the caller must hold taskingThreadStartMutex.
+     */
+    void stopAndJoinLanes();
+
+    /**
+     * @brief Move the tasks of a lane queue at the end of destination, and forget their coalescing keys
+     * as the tasks are no longer in the queue. The caller must hold the lane taskQueueMutex.
+     *
+     * @param lane the lane
+     * @param priority the TaskPriority of the queue
+     * @param destination where the tasks are appended
+     */
+    void takeQueuedTasks(Lane &lane, size_t priority, std::deque<std::shared_ptr<Task>> &destination);
+
+    /**
+     * @brief Call the listeners handling this task type in their registration order,
+     * until one returns true. The caller must be running on a lane thread that has set
+     * its listenersReadVersion.
+     *
+     * @param task the task to pass to the listeners
+     */
+    void dispatchTask(const std::shared_ptr<Task> &task);
+
+    /**
+     * @brief Rebuild the listenersPerTaskType of a snapshot from its listeners.
+     *
+     * @param snapshot the snapshot being prepared, not published yet
+     */
+    static void rebuildDispatchTable(ListenersSnapshot &snapshot);
+
+    /**
+     * @brief Replace the snapshot the lanes read, and keep the previous one until no lane
+     * can be reading it. The caller must hold taskListenersMutex.
+     *
+     * @param snapshot the new snapshot
      */
-    void taskingThreadLoop();
+    void publishListenersSnapshot(std::unique_ptr<ListenersSnapshot> snapshot);
 
     /**
-     Append this task to history ring buffer.
+     * @brief Wait until the lanes (except the calling one) are done with the snapshots published
+     * before the current one.
+     */
+    void waitForListenersReaders();
+
+    /**
+     * @brief Delete the retired snapshots no lane can be reading anymore, without waiting.
+     * The caller must hold taskListenersMutex.
+     */
+    void reclaimListenersSnapshots();
+
+    /**
+     Append this task to history, clearing the canceled tasks.
      */
     void recordTaskInHistory(std::shared_ptr<Task>);
 
+    /**
+     * @brief Append this task to history, dropping the oldest tasks if it then retains more
+     * than ACTIVITY_HISTORY_MAX_BYTES.
+     */
+    void pushInHistory(std::shared_ptr<Task>);
+
+    /**
+     * @brief Append the task to the task journal if it has a binary tag.
+     */
+    void recordTaskInJournal(Task &task);
+
     /**
      * @brief This can be used to throw a std::runtime_error when the caller is not
-     * the tasking thread.
+     * one of the lanes threads. It only reads thread local variables, so it is cheap.
      *
      * @param caller name of the function that is calling, to be displayed in error string.
      */
     void throwIfCallerIsNotTaskingThread(std::string caller);
 
+    /**
+     * @brief This can be used to throw a std::runtime_error when the caller is not
+     * the control lane thread, which is the only one allowed to touch the history.
+     *
+     * @param caller name of the function that is calling, to be displayed in error string.
+     */
+    void throwIfCallerIsNotControlLaneThread(std::string caller);
+
     /**
      Undo the last activity.
      Returns a bool to tell if it succeeded or not.
@@ -140,20 +288,36 @@ class TaskingManager : public TaskListener
      */
     void clearTaskHistory();
 
-    std::shared_ptr<Task> history[ACTIVITY_HISTORY_RING_BUFFER_SIZE]; /**< ring buffer with the last executed tasks */
-    int historyNextIndex;                            /**<  the index of the next recorded history entry */
+    /**
+     * @brief A task recorded in history, with the size it was accounted for.
+     */
+    struct HistoryEntry
+    {
+        std::shared_ptr<Task> task; /**< the undoable task */
+        size_t sizeInBytes;         /**< getHistorySizeInBytes of the task when it was recorded */
+    };
+
+    std::deque<HistoryEntry> history;                /**< the last executed undoable tasks, most recent at the back */
+    size_t historySizeInBytes;                       /**< sum of the sizeInBytes of the history entries */
     std::stack<std::shared_ptr<Task>> canceledTasks; //**<  stack of canceled tasks */
-    std::vector<TaskListener *> taskListeners;       /**<  a list of object we broadcast tasks to */
-    std::vector<int64_t> taskListenersIds;           /**<  a list of identifier for ecah taskListeners */
-    std::mutex taskListenersMutex;               /**< Mutex to prevent race condition on the vector of taskListeners */
-    std::queue<std::shared_ptr<Task>> taskQueue; /**<  the queue of tasks to be broadcasted */
-    bool taskBroadcastStopped;                   /**<  boolean to tell if the broadcasting processing is enabled */
-    std::unique_ptr<std::thread> taskingThread;  /**< Reference to the eventually running task broadcasting thread */
-    std::mutex taskQueueMutex;                   /**< mutex to synchronize queue access across different threads */
-    std::mutex taskingThreadStartMutex; /**< Used to secure start and stop being called concurrently, and reading of
-                                           thread ids and nullity in other functions */
-    std::condition_variable taskingThreadCV; /**< Used to wake up the background thread */
-    int64_t lastUsedTaskListenerId;          /**< used to incrementally generate task listeners ids */
-
-    std::atomic<bool> backgroundThreadIsRunning;
+    std::atomic<const ListenersSnapshot *> listenersSnapshot; /**< the listeners the lanes broadcast tasks to */
+    std::atomic<uint64_t> listenersVersion;                   /**< incremented each time a snapshot is published */
+    std::vector<std::pair<std::unique_ptr<const ListenersSnapshot>, uint64_t>>
+        retiredListenersSnapshots;          /**< replaced snapshots and the listenersVersion that replaced them */
+    std::mutex taskListenersMutex;          /**< serializes the registrations and purges of listeners */
+    std::array<Lane, NO_TASK_LANES> lanes;  /**< queue and thread of each TaskLane */
+    std::atomic<bool> taskBroadcastStopped; /**<  boolean to tell if the broadcasting processing is enabled */
+    std::mutex taskingThreadStartMutex;     /**< Used to secure start and stop being called concurrently */
+    int64_t lastUsedTaskListenerId;         /**< used to incrementally generate task listeners ids */
+
+    std::atomic<int> noRunningLanes;        /**< number of lanes threads that are still running */
+    std::atomic<uint64_t> noCoalescedTasks; /**< number of tasks replaced before being broadcasted */
+
+    static thread_local TaskingManager *laneThreadOwner; /**< manager whose lane runs on this thread, or nullptr */
+    static thread_local size_t laneThreadIndex;          /**< lane running on this thread, if laneThreadOwner is set */
+
+    std::atomic<bool> taskJournalEnabled;                   /**< is a task journal being recorded */
+    std::mutex taskJournalMutex;                            /**< protects taskJournal */
+    std::unique_ptr<TaskJournalWriter> taskJournal;         /**< the task journal being recorded, or nullptr */
+    std::chrono::steady_clock::time_point taskJournalStart; /**< time the journal timestamps are relative to */
 };
\ No newline at end of file
@@ -1,6 +1,16 @@
 #include "TaskingManager.h"
+#include "ClearEpoch.h"
 #include "Task.h"
+#include "TaskBinaryStream.h"
+#include "TaskJournal.h"
+#include "TaskJournalReplayer.h"
 #include "TaskListener.h"
+#include "TaskPool.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <nlohmann/json.hpp>
@@ -10,6 +20,24 @@
 #include <thread>
 #include <vector>
 
+#define THROUGHPUT_TEST_NO_TASKS 200000
+#define THROUGHPUT_TEST_MAX_PRODUCERS 8
+#define THROUGHPUT_TEST_TIMEOUT_SEC 60
+#define TASK_POOL_TEST_NO_CACHED 4
+#define TASK_POOL_TEST_NO_TASKS 10000
+#define JOURNAL_TEST_NO_TASKS 1000
+#define JOURNAL_TEST_BINARY_TAG 1
+/**< Number of floats written in the corrupted journal records, far more than they hold */
+#define JOURNAL_TEST_CORRUPT_NO_FLOATS (uint64_t(1) << 60)
+#define HISTORY_TEST_NO_FITTING_TASKS 8
+#define PRIORITY_TEST_NO_TASKS 2000
+#define PRIORITY_TEST_PREEMPTED_INDEX 100
+#define PRIORITY_TEST_TASK_WORK_US 20
+#define REGISTRY_TEST_NO_REGISTRATIONS 200
+#define CLEAR_TEST_NO_TASKS 2000
+#define CLEAR_TEST_CLEARING_INDEX 100
+#define CLEAR_TEST_NO_TASKS_AFTER 10
+
 /**
  * @brief This class describe a Task that has an identifer.
  */
@@ -59,6 +87,11 @@ class TestTaskReverse : public Task
         return reversed;
     }
 
+    bool supportsUndo()
+    {
+        return true;
+    }
+
     std::string marshal()
     {
         nlohmann::json taskj = {{"object", "task"},
@@ -74,6 +107,53 @@ class TestTaskReverse : public Task
     std::string identifier;
 };
 
+/**
+ * @brief An undoable task retaining enough memory that only HISTORY_TEST_NO_FITTING_TASKS fit in history.
+ */
+class TestHeavyTask : public TestTaskReverse
+{
+  public:
+    TestHeavyTask(std::string id) : TestTaskReverse(id)
+    {
+    }
+
+    size_t getHistorySizeInBytes()
+    {
+        return ACTIVITY_HISTORY_MAX_BYTES / HISTORY_TEST_NO_FITTING_TASKS;
+    }
+};
+
+/**
+ * @brief This class describe a Task that declares its type id.
+ */
+class TestTypedTask : public SilentTask
+{
+  public:
+    TestTypedTask(std::string id)
+    {
+        identifier = id;
+    }
+
+    TaskTypeId getTaskTypeId() override
+    {
+        return getTaskTypeIdOf<TestTypedTask>();
+    }
+
+    std::string marshal() override
+    {
+        nlohmann::json taskj = {{"object", "task"},
+                                {"task", "test_typed_task"},
+                                {"identifier", identifier},
+                                {"is_completed", isCompleted()},
+                                {"failed", hasFailed()},
+                                {"recordable_in_history", recordableInHistory},
+                                {"is_part_of_reversion", isPartOfReversion}};
+        return taskj.dump();
+    }
+
+    std::string identifier;
+};
+
 /**
  * @brief This class defines a TaskListener that
  * records whathever it receives and can return
@@ -112,6 +192,329 @@ class TestTaskListener : public TaskListener
     std::mutex mutex;
 };
 
+/**
+ * @brief A task that only carries the latest value of a state, so older ones can be dropped.
+ */
+class TestCoalescedTask : public TestTypedTask
+{
+  public:
+    TestCoalescedTask(std::string id) : TestTypedTask(id)
+    {
+    }
+
+    uint64_t getCoalescingKey() override
+    {
+        return getTaskTypeIdOf<TestCoalescedTask>();
+    }
+};
+
+/**
+ * @brief A task with a binary serialization, that is recorded in task journals.
+ */
+class TestJournaledTask : public TestTypedTask
+{
+  public:
+    TestJournaledTask(std::string id, uint64_t v, std::vector<float> s) : TestTypedTask(id), value(v), samples(s)
+    {
+    }
+
+    uint32_t getBinaryTag() override
+    {
+        return JOURNAL_TEST_BINARY_TAG;
+    }
+
+    void serializeBinary(TaskBinaryWriter &writer) override
+    {
+        writer.writeString(identifier);
+        writer.write<uint64_t>(value);
+        writer.writeFloats(samples.data(), samples.size());
+    }
+
+    static std::shared_ptr<Task> decodeBinary(TaskBinaryReader &reader)
+    {
+        std::string id = reader.readString();
+        uint64_t v = reader.read<uint64_t>();
+        std::vector<float> s(reader.readFloatsCount());
+        reader.readFloatsInto(s.data(), s.size());
+        return std::make_shared<TestJournaledTask>(id, v, s);
+    }
+
+    uint64_t value;
+    std::vector<float> samples;
+};
+
+/**
+ * @brief A task recorded like TestJournaledTask, but with a number of floats that does not fit in its record.
+ */
+class TestCorruptJournaledTask : public TestJournaledTask
+{
+  public:
+    TestCorruptJournaledTask(std::string id) : TestJournaledTask(id, 0, {1.0f, 2.0f})
+    {
+    }
+
+    void serializeBinary(TaskBinaryWriter &writer) override
+    {
+        writer.writeString(identifier);
+        writer.write<uint64_t>(value);
+        writer.write<uint64_t>(JOURNAL_TEST_CORRUPT_NO_FLOATS);
+        writer.writeBytes(samples.data(), samples.size() * sizeof(float));
+    }
+};
+
+/**
+ * @brief A task broadcasted on the data lane.
+ */
+class TestDataLaneTask : public SilentTask
+{
+  public:
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_DATA;
+    }
+};
+
+/**
+ * @brief A task with an index and a priority, in the data lane unless told otherwise.
+ */
+class TestPriorityTask : public SilentTask
+{
+  public:
+    TestPriorityTask(int i, TaskPriority p, TaskLane l = TASK_LANE_DATA) : index(i), priority(p), lane(l)
+    {
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return lane;
+    }
+
+    TaskPriority getTaskPriority() override
+    {
+        return priority;
+    }
+
+    int index;
+    TaskPriority priority;
+    TaskLane lane;
+};
+
+/**
+ * @brief A TaskListener that spends some time on each normal priority TestPriorityTask, records their order,
+ * and broadcasts a high priority task in the middle of the backlog. The high priority tasks are recorded
+ * with the index -1.
+ */
+class PriorityTaskListener : public TaskListener
+{
+  public:
+    PriorityTaskListener(std::function<std::shared_ptr<Task>()> makeHighPriorityTaskParam)
+        : noReceivedTasks(0), makeHighPriorityTask(makeHighPriorityTaskParam)
+    {
+    }
+
+    bool taskHandler(std::shared_ptr<Task> task)
+    {
+        auto priorityTask = std::dynamic_pointer_cast<TestPriorityTask>(task);
+        if (task->getTaskPriority() == TASK_PRIORITY_HIGH)
+        {
+            receivedIndexes.push_back(-1);
+            noReceivedTasks++;
+            latency = std::chrono::steady_clock::now() - highPriorityBroadcastTime;
+            return true;
+        }
+        if (priorityTask == nullptr)
+        {
+            return false;
+        }
+        receivedIndexes.push_back(priorityTask->index);
+        noReceivedTasks++;
+        // emulates the processing of audio data
+        auto workEnd = std::chrono::steady_clock::now() + std::chrono::microseconds(PRIORITY_TEST_TASK_WORK_US);
+        while (std::chrono::steady_clock::now() < workEnd)
+        {
+        }
+        if (priorityTask->index == PRIORITY_TEST_PREEMPTED_INDEX)
+        {
+            highPriorityBroadcastTime = std::chrono::steady_clock::now();
+            task->getTaskingManager()->broadcastTask(makeHighPriorityTask());
+        }
+        return true;
+    }
+
+    std::vector<int> receivedIndexes;
+    std::atomic<size_t> noReceivedTasks;
+    std::function<std::shared_ptr<Task>()> makeHighPriorityTask;
+    std::chrono::steady_clock::time_point highPriorityBroadcastTime;
+    std::chrono::steady_clock::duration latency;
+};
+
+/**
+ * @brief A data lane task carrying the time it was sent at, like the audio analysis segments.
+ */
+class TestSentDataTask : public SilentTask
+{
+  public:
+    TestSentDataTask(int64_t sentTime) : sentTimeUnixMs(sentTime)
+    {
+    }
+
+    TaskLane getTaskLane() override
+    {
+        return TASK_LANE_DATA;
+    }
+
+    int64_t sentTimeUnixMs;
+};
+
+/**
+ * @brief A high priority control lane task clearing what the TestSentDataTask sent before it produced.
+ */
+class TestClearTask : public SilentTask
+{
+  public:
+    TestClearTask(int64_t clearTime) : clearTimeUnixMs(clearTime)
+    {
+    }
+
+    TaskPriority getTaskPriority() override
+    {
+        return TASK_PRIORITY_HIGH;
+    }
+
+    int64_t clearTimeUnixMs;
+};
+
+/**
+ * @brief A TaskListener that draws the TestSentDataTask in a backend, spending some time on each one,
+ * and broadcasts a TestClearTask followed by more data tasks in the middle of the data backlog.
+ * The backend is cleared by the TestClearTask, within a ClearEpoch.
+ */
+class ClearingTaskListener : public TaskListener
+{
+  public:
+    ClearingTaskListener() : noReceivedTasks(0), noDroppedTasks(0)
+    {
+    }
+
+    bool taskHandler(std::shared_ptr<Task> task)
+    {
+        auto clearTask = std::dynamic_pointer_cast<TestClearTask>(task);
+        if (clearTask != nullptr)
+        {
+            clearEpoch.startNewEpoch(clearTask->clearTimeUnixMs, [this] { backend.clear(); });
+            noReceivedTasks++;
+            return true;
+        }
+        auto dataTask = std::dynamic_pointer_cast<TestSentDataTask>(task);
+        if (dataTask == nullptr)
+        {
+            return false;
+        }
+        bool drawn = clearEpoch.runIfCurrent(dataTask->sentTimeUnixMs, [this, &dataTask] {
+            backend.push_back(dataTask->sentTimeUnixMs);
+            // emulates the drawing of audio data
+            auto workEnd = std::chrono::steady_clock::now() + std::chrono::microseconds(PRIORITY_TEST_TASK_WORK_US);
+            while (std::chrono::steady_clock::now() < workEnd)
+            {
+            }
+        });
+        if (!drawn)
+        {
+            noDroppedTasks++;
+        }
+        if (dataTask->sentTimeUnixMs == CLEAR_TEST_CLEARING_INDEX)
+        {
+            // the clear happens after all the queued data tasks were sent, and before the next ones
+            task->getTaskingManager()->broadcastTask(std::make_shared<TestClearTask>(CLEAR_TEST_NO_TASKS));
+            for (int64_t i = 0; i < CLEAR_TEST_NO_TASKS_AFTER; i++)
+            {
+                task->getTaskingManager()->broadcastTask(std::make_shared<TestSentDataTask>(CLEAR_TEST_NO_TASKS + i));
+            }
+        }
+        noReceivedTasks++;
+        return true;
+    }
+
+    ClearEpoch clearEpoch;
+    std::vector<int64_t> backend; /**< sent times of the data tasks drawn and not cleared */
+    std::atomic<size_t> noReceivedTasks;
+    std::atomic<size_t> noDroppedTasks;
+};
+
+/**
+ * @brief A TaskListener that blocks the data lane on TestDataLaneTask until it is released.
+ */
+class BlockingTaskListener : public TaskListener
+{
+  public:
+    BlockingTaskListener() : released(false)
+    {
+    }
+
+    bool taskHandler(std::shared_ptr<Task> task)
+    {
+        if (std::dynamic_pointer_cast<TestDataLaneTask>(task) != nullptr)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            releasedCV.wait_for(lock, std::chrono::seconds(5), [this] { return released; });
+        }
+        return false;
+    }
+
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            released = true;
+        }
+        releasedCV.notify_all();
+    }
+
+    bool released;
+    std::mutex mutex;
+    std::condition_variable releasedCV;
+};
+
+/**
+ * @brief A TaskListener that counts the TestTypedTask it receives.
+ */
+class CountingTaskListener : public TaskListener
+{
+  public:
+    CountingTaskListener() : noReceivedTasks(0)
+    {
+    }
+
+    bool taskHandler(std::shared_ptr<Task>)
+    {
+        noReceivedTasks++;
+        return false;
+    }
+
+    std::vector<TaskTypeId> getHandledTaskTypes() override
+    {
+        return {getTaskTypeIdOf<TestTypedTask>()};
+    }
+
+    std::atomic<size_t> noReceivedTasks;
+};
+
+/**
+ * @brief A TestTaskListener that only subscribes to TestTypedTask.
+ */
+class TestTypedTaskListener : public TestTaskListener
+{
+  public:
+    TestTypedTaskListener(bool shouldStop) : TestTaskListener(shouldStop)
+    {
+    }
+
+    std::vector<TaskTypeId> getHandledTaskTypes() override
+    {
+        return {getTaskTypeIdOf<TestTypedTask>()};
+    }
+};
+
 /**
  * @brief This class describe the test suite.
  */
@@ -443,7 +846,643 @@ class TestSuite
         taskingManager.reset(nullptr);
     }
 
+    // testing that only undoable tasks are recorded, and that the history is bounded in bytes
+    void RunTestHistoryBounds01()
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+        TestTaskListener recordingListener(false);
+        taskingManager->registerTaskListener(&recordingListener);
+        taskingManager->startTaskBroadcast();
+
+        // the thread checks reject the callers that are not lane threads
+        bool nestedCallThrew = false;
+        try
+        {
+            taskingManager->broadcastNestedTaskNow(std::make_shared<TestTaskReverse>("outside"));
+        }
+        catch (std::runtime_error &)
+        {
+            nestedCallThrew = true;
+        }
+        if (!nestedCallThrew)
+        {
+            throw std::runtime_error("broadcastNestedTaskNow was allowed from outside the lanes threads");
+        }
+
+        // the task that can't be undone is not recorded, so it does not prevent undoing the previous one
+        taskingManager->broadcastTask(std::make_shared<TestTaskReverse>("undoable"));
+        taskingManager->broadcastTask(std::make_shared<TestTask1>("not undoable"));
+        taskingManager->broadcastTask(std::make_shared<CancelTask>());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // the listener history is read under its lock, after the TaskingManager handled the cancel task
+        if (countSuccessfulUndo(recordingListener.getHistory()) != 1)
+        {
+            throw std::runtime_error("undo was blocked by a task that does not support it");
+        }
+
+        // only the most recent tasks that fit in the history size can be undone
+        taskingManager->broadcastTask(std::make_shared<ClearHistoryTask>());
+        for (size_t i = 0; i < HISTORY_TEST_NO_FITTING_TASKS * 3; i++)
+        {
+            taskingManager->broadcastTask(std::make_shared<TestHeavyTask>("heavy" + std::to_string(i)));
+        }
+        for (size_t i = 0; i < HISTORY_TEST_NO_FITTING_TASKS + 2; i++)
+        {
+            taskingManager->broadcastTask(std::make_shared<CancelTask>());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        size_t noSuccessfulUndo = countSuccessfulUndo(recordingListener.getHistory()) - 1;
+        if (noSuccessfulUndo != HISTORY_TEST_NO_FITTING_TASKS)
+        {
+            throw std::runtime_error("unexpected number of undone tasks: " + std::to_string(noSuccessfulUndo));
+        }
+
+        taskingManager.reset(nullptr);
+    }
+
+    // testing that typed tasks only reach the listeners that handle them
+    void RunTestTypedDispatch01()
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+
+        TestTaskListener allTasksListener(false);
+        TestTypedTaskListener typedListener(false);
+        TestTaskListener lastListener(false);
+
+        taskingManager->registerTaskListener(&allTasksListener);
+        int64_t typedListenerId = taskingManager->registerTaskListener(&typedListener);
+        taskingManager->registerTaskListener(&lastListener);
+
+        auto untypedTask = std::make_shared<TestTask1>("untyped");
+        auto typedTask = std::make_shared<TestTypedTask>("typed");
+
+        if (taskCast<TestTypedTask>(untypedTask) != nullptr || taskCast<TestTypedTask>(typedTask) == nullptr)
+        {
+            throw std::runtime_error("taskCast did not match the task types");
+        }
+        if (untypedTask->getTaskTypeId() != UNTYPED_TASK_TYPE_ID ||
+            typedTask->getTaskTypeId() == std::make_shared<CancelTask>()->getTaskTypeId())
+        {
+            throw std::runtime_error("unexpected task type ids");
+        }
+
+        taskingManager->broadcastTask(untypedTask);
+        taskingManager->broadcastTask(typedTask);
+        taskingManager->startTaskBroadcast();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        if (allTasksListener.getHistory().size() != 2 || lastListener.getHistory().size() != 2)
+        {
+            throw std::runtime_error("listeners of all tasks did not receive the 2 expected tasks");
+        }
+        auto typedHistory = typedListener.getHistory();
+        if (typedHistory.size() != 1 || taskCast<TestTypedTask>(typedHistory[0]) == nullptr)
+        {
+            throw std::runtime_error("typed listener should only have received the typed task, it received " +
+                                     std::to_string(typedHistory.size()) + " tasks");
+        }
+
+        // the dispatch table must be rebuilt when the typed listener goes away
+        taskingManager->purgeTaskListener(typedListenerId);
+        taskingManager->broadcastTask(std::make_shared<TestTypedTask>("typed2"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        if (typedListener.getHistory().size() != 1)
+        {
+            throw std::runtime_error("purged typed listener still received tasks");
+        }
+        if (allTasksListener.getHistory().size() != 3 || lastListener.getHistory().size() != 3)
+        {
+            throw std::runtime_error("listeners of all tasks did not receive the typed task after the purge");
+        }
+
+        taskingManager.reset(nullptr);
+    }
+
+    // testing that the listeners registrations don't wait for the lanes, and purges only for the tasks in flight
+    void RunTestListenerRegistry01()
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+        BlockingTaskListener blockingListener;
+        taskingManager->registerTaskListener(&blockingListener);
+        taskingManager->startTaskBroadcast();
+
+        // the data lane stays in the blocking listener handler until released
+        taskingManager->broadcastTask(std::make_shared<TestDataLaneTask>());
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        auto registrationStart = std::chrono::steady_clock::now();
+        TestTaskListener recordingListener(false);
+        int64_t recordingListenerId = taskingManager->registerTaskListener(&recordingListener);
+        if (std::chrono::steady_clock::now() - registrationStart > std::chrono::milliseconds(500))
+        {
+            throw std::runtime_error("registering a listener waited for the blocked lane");
+        }
+        taskingManager->broadcastTask(std::make_shared<TestTask1>("registered"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (recordingListener.getHistory().size() != 1)
+        {
+            throw std::runtime_error("the new listener did not receive the next task");
+        }
+
+        // the purge waits for the data lane, which may be calling the purged listener
+        std::atomic<bool> purged(false);
+        std::thread purgingThread([this, &purged, recordingListenerId] {
+            taskingManager->purgeTaskListener(recordingListenerId);
+            purged = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (purged)
+        {
+            throw std::runtime_error("the purge did not wait for the task being broadcasted");
+        }
+        blockingListener.release();
+        purgingThread.join();
+        taskingManager->broadcastTask(std::make_shared<TestTask1>("purged"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (recordingListener.getHistory().size() != 1)
+        {
+            throw std::runtime_error("the purged listener received a task");
+        }
+
+        // listeners coming and going while the lanes are busy
+        CountingTaskListener stableListener;
+        taskingManager->registerTaskListener(&stableListener);
+        std::atomic<bool> producing(true);
+        std::thread producer([this, &producing] {
+            auto task = std::make_shared<TestTypedTask>("registry");
+            while (producing)
+            {
+                taskingManager->broadcastTask(task);
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+            }
+        });
+        for (int i = 0; i < REGISTRY_TEST_NO_REGISTRATIONS; i++)
+        {
+            CountingTaskListener transientListener;
+            int64_t transientListenerId = taskingManager->registerTaskListener(&transientListener);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            taskingManager->purgeTaskListener(transientListenerId);
+        }
+        producing = false;
+        producer.join();
+        if (stableListener.noReceivedTasks == 0)
+        {
+            throw std::runtime_error("no task was broadcasted while listeners were registered and purged");
+        }
+
+        taskingManager.reset(nullptr);
+    }
+
+    // testing that a blocked data lane does not delay the control lane tasks
+    void RunTestLanes01()
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+
+        BlockingTaskListener blockingListener;
+        TestTaskListener recordingListener(false);
+        taskingManager->registerTaskListener(&blockingListener);
+        taskingManager->registerTaskListener(&recordingListener);
+        taskingManager->startTaskBroadcast();
+
+        taskingManager->broadcastTask(std::make_shared<TestDataLaneTask>());
+        taskingManager->broadcastTask(std::make_shared<TestTask1>("control"));
+
+        bool controlTaskReceived = false;
+        for (int i = 0; i < 100 && !controlTaskReceived; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            auto recordedTasks = recordingListener.getHistory();
+            controlTaskReceived = recordedTasks.size() == 1 &&
+                                  std::dynamic_pointer_cast<TestTask1>(recordedTasks[0]) != nullptr;
+        }
+        if (!controlTaskReceived)
+        {
+            throw std::runtime_error("control lane task was not broadcasted while the data lane was blocked");
+        }
+
+        blockingListener.release();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto recordedTasks = recordingListener.getHistory();
+        if (recordedTasks.size() != 2 || std::dynamic_pointer_cast<TestDataLaneTask>(recordedTasks[1]) == nullptr)
+        {
+            throw std::runtime_error("data lane task was not broadcasted after being released");
+        }
+
+        taskingManager.reset(nullptr);
+    }
+
+    // testing that a high priority task is broadcasted before the backlog of its lane
+    void RunTestPriority01()
+    {
+        runPriorityTest(TASK_LANE_DATA, [] { return std::make_shared<TestPriorityTask>(-1, TASK_PRIORITY_HIGH); });
+    }
+
+    // testing that a user facing control task overtakes the backlog of the control lane
+    void RunTestPriority02()
+    {
+        runPriorityTest(TASK_LANE_CONTROL, [] { return std::make_shared<QuittingTask>(); });
+    }
+
+    // measuring how many tasks per second are broadcasted with several threads posting them
+    void RunTestThroughput01()
+    {
+        for (size_t noProducers = 1; noProducers <= THROUGHPUT_TEST_MAX_PRODUCERS; noProducers *= 2)
+        {
+            taskingManager = std::make_unique<TaskingManager>();
+            CountingTaskListener countingListener;
+            taskingManager->registerTaskListener(&countingListener);
+            taskingManager->startTaskBroadcast();
+
+            size_t tasksPerProducer = THROUGHPUT_TEST_NO_TASKS / noProducers;
+            size_t noTasks = tasksPerProducer * noProducers;
+            auto start = std::chrono::steady_clock::now();
+
+            std::vector<std::thread> producers;
+            for (size_t i = 0; i < noProducers; i++)
+            {
+                producers.emplace_back([this, tasksPerProducer] {
+                    // the same task is posted again and again to measure the queue and not the allocator
+                    auto task = std::make_shared<TestTypedTask>("throughput");
+                    for (size_t j = 0; j < tasksPerProducer; j++)
+                    {
+                        taskingManager->broadcastTask(task);
+                    }
+                });
+            }
+            for (size_t i = 0; i < noProducers; i++)
+            {
+                producers[i].join();
+            }
+
+            auto deadline = start + std::chrono::seconds(THROUGHPUT_TEST_TIMEOUT_SEC);
+            while (countingListener.noReceivedTasks < noTasks && std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (countingListener.noReceivedTasks != noTasks)
+            {
+                throw std::runtime_error("only " + std::to_string(countingListener.noReceivedTasks) + " of the " +
+                                         std::to_string(noTasks) + " tasks were broadcasted");
+            }
+            spdlog::info("Broadcasted {} tasks from {} producer threads in {:.3f}s: {:.0f} tasks/sec", noTasks,
+                         noProducers, elapsed, double(noTasks) / elapsed);
+
+            taskingManager.reset(nullptr);
+        }
+    }
+
+    // testing that only the newest pending task of a coalescing key is delivered
+    void RunTestCoalescing01()
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+        TestTaskListener recordingListener(false);
+        taskingManager->registerTaskListener(&recordingListener);
+
+        // the tasks pile up in the queue as the broadcast is not started yet
+        taskingManager->broadcastTask(std::make_shared<TestCoalescedTask>("coalesced1"));
+        taskingManager->broadcastTask(std::make_shared<TestTypedTask>("other"));
+        taskingManager->broadcastTask(std::make_shared<TestCoalescedTask>("coalesced2"));
+        taskingManager->broadcastTask(std::make_shared<TestCoalescedTask>("coalesced3"));
+        taskingManager->startTaskBroadcast();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto recordedTasks = recordingListener.getHistory();
+        if (recordedTasks.size() != 2 || taskingManager->getNoCoalescedTasks() != 2)
+        {
+            throw std::runtime_error("expected 2 delivered and 2 coalesced tasks, got " +
+                                     std::to_string(recordedTasks.size()) + " delivered and " +
+                                     std::to_string(taskingManager->getNoCoalescedTasks()) + " coalesced");
+        }
+        // the newest task takes the place of the oldest in the queue
+        auto first = std::dynamic_pointer_cast<TestTypedTask>(recordedTasks[0]);
+        auto second = std::dynamic_pointer_cast<TestTypedTask>(recordedTasks[1]);
+        if (first == nullptr || first->identifier != "coalesced3" || second == nullptr ||
+            second->identifier != "other")
+        {
+            throw std::runtime_error("coalesced tasks were not delivered in the expected order");
+        }
+
+        // once delivered, a task with the same key is queued again
+        taskingManager->broadcastTask(std::make_shared<TestCoalescedTask>("coalesced4"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (recordingListener.getHistory().size() != 3)
+        {
+            throw std::runtime_error("coalesced task was not delivered after the queue was emptied");
+        }
+
+        taskingManager.reset(nullptr);
+    }
+
+    // testing that pooled tasks stop allocating once the pool has warmed up
+    void RunTestTaskPool01()
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+        CountingTaskListener countingListener;
+        taskingManager->registerTaskListener(&countingListener);
+        taskingManager->startTaskBroadcast();
+
+        TaskPool<TestTypedTask> pool(TASK_POOL_TEST_NO_CACHED);
+
+        // warm up the pool with as many tasks in flight as the cache can hold
+        {
+            std::vector<std::shared_ptr<TestTypedTask>> warmupTasks;
+            for (size_t i = 0; i < TASK_POOL_TEST_NO_CACHED; i++)
+            {
+                warmupTasks.push_back(pool.make("warmup"));
+            }
+        }
+        if (pool.getNoHeapAllocations() != TASK_POOL_TEST_NO_CACHED)
+        {
+            throw std::runtime_error("unexpected number of heap allocations during warmup: " +
+                                     std::to_string(pool.getNoHeapAllocations()));
+        }
+
+        // the tasks are released by the tasking thread, one at a time
+        for (size_t i = 0; i < TASK_POOL_TEST_NO_TASKS; i++)
+        {
+            while (countingListener.noReceivedTasks + 1 < i)
+            {
+                std::this_thread::yield();
+            }
+            taskingManager->broadcastTask(pool.make("pooled"));
+        }
+        while (countingListener.noReceivedTasks < TASK_POOL_TEST_NO_TASKS)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        if (pool.getNoHeapAllocations() != TASK_POOL_TEST_NO_CACHED ||
+            pool.getNoRecycledAllocations() != TASK_POOL_TEST_NO_TASKS)
+        {
+            throw std::runtime_error("pooled tasks were allocated in steady state: " +
+                                     std::to_string(pool.getNoHeapAllocations()) + " heap allocations and " +
+                                     std::to_string(pool.getNoRecycledAllocations()) + " recycled ones");
+        }
+
+        taskingManager.reset(nullptr);
+
+        // tasks outliving their pool keep its memory alive
+        std::shared_ptr<TestTypedTask> survivingTask;
+        {
+            TaskPool<TestTypedTask> shortLivedPool(1);
+            survivingTask = shortLivedPool.make("survivor");
+        }
+        if (survivingTask->identifier != "survivor")
+        {
+            throw std::runtime_error("task did not survive its pool");
+        }
+    }
+
+    // testing that a recorded task journal is replayed with the same tasks in the same order
+    void RunTestTaskJournal01()
+    {
+        std::string journalPath = (std::filesystem::temp_directory_path() / "kholors_task_journal_test.bin").string();
+
+        // record the journaled tasks, the other ones are not written
+        taskingManager = std::make_unique<TaskingManager>();
+        taskingManager->startTaskJournal(journalPath);
+        for (size_t i = 0; i < JOURNAL_TEST_NO_TASKS; i++)
+        {
+            std::vector<float> samples(i % 16, float(i));
+            auto journaledTask = std::make_shared<TestJournaledTask>("journaled" + std::to_string(i), i, samples);
+            taskingManager->broadcastTask(journaledTask);
+            taskingManager->broadcastTask(std::make_shared<TestTypedTask>("not journaled"));
+        }
+        taskingManager->stopTaskJournal();
+        taskingManager.reset(nullptr);
+
+        {
+            TaskJournalReader reader(journalPath);
+            TaskJournalRecord record;
+            size_t noRecords = 0;
+            while (reader.next(record))
+            {
+                noRecords++;
+            }
+            if (noRecords != JOURNAL_TEST_NO_TASKS)
+            {
+                throw std::runtime_error("unexpected number of journal records: " + std::to_string(noRecords));
+            }
+        }
+
+        // replay it as fast as possible
+        taskingManager = std::make_unique<TaskingManager>();
+        TestTaskListener recordingListener(false);
+        taskingManager->registerTaskListener(&recordingListener);
+        taskingManager->startTaskBroadcast();
+        TaskJournalDecoders decoders;
+        decoders.registerDecoder(JOURNAL_TEST_BINARY_TAG, TestJournaledTask::decodeBinary);
+        {
+            TaskJournalReplayer replayer(*taskingManager, decoders, journalPath, false);
+            replayer.start();
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (recordingListener.getHistory().size() < JOURNAL_TEST_NO_TASKS &&
+                   std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            if (replayer.getNoReplayedTasks() != JOURNAL_TEST_NO_TASKS || replayer.getNoSkippedRecords() != 0)
+            {
+                throw std::runtime_error("unexpected number of replayed tasks: " +
+                                         std::to_string(replayer.getNoReplayedTasks()));
+            }
+        }
+
+        auto replayedTasks = recordingListener.getHistory();
+        if (replayedTasks.size() != JOURNAL_TEST_NO_TASKS)
+        {
+            throw std::runtime_error("unexpected number of delivered replayed tasks: " +
+                                     std::to_string(replayedTasks.size()));
+        }
+        for (size_t i = 0; i < JOURNAL_TEST_NO_TASKS; i++)
+        {
+            auto task = std::dynamic_pointer_cast<TestJournaledTask>(replayedTasks[i]);
+            if (task == nullptr || task->identifier != "journaled" + std::to_string(i) || task->value != i ||
+                task->samples != std::vector<float>(i % 16, float(i)))
+            {
+                throw std::runtime_error("replayed task " + std::to_string(i) + " differs from the recorded one");
+            }
+        }
+
+        taskingManager.reset(nullptr);
+        std::filesystem::remove(journalPath);
+    }
+
+    void RunTestTaskJournal02()
+    {
+        std::string journalPath =
+            (std::filesystem::temp_directory_path() / "kholors_task_journal_corrupt_test.bin").string();
+
+        // a record whose number of floats exceeds its payload, between two valid ones
+        taskingManager = std::make_unique<TaskingManager>();
+        taskingManager->startTaskJournal(journalPath);
+        taskingManager->broadcastTask(std::make_shared<TestJournaledTask>("before", 1, std::vector<float>(4, 1.0f)));
+        taskingManager->broadcastTask(std::make_shared<TestCorruptJournaledTask>("corrupt"));
+        taskingManager->broadcastTask(std::make_shared<TestJournaledTask>("after", 2, std::vector<float>(4, 2.0f)));
+        taskingManager->stopTaskJournal();
+        taskingManager.reset(nullptr);
+
+        // the corrupted record must be skipped before anything is allocated for its floats
+        taskingManager = std::make_unique<TaskingManager>();
+        TestTaskListener recordingListener(false);
+        taskingManager->registerTaskListener(&recordingListener);
+        taskingManager->startTaskBroadcast();
+        TaskJournalDecoders decoders;
+        decoders.registerDecoder(JOURNAL_TEST_BINARY_TAG, TestJournaledTask::decodeBinary);
+        {
+            TaskJournalReplayer replayer(*taskingManager, decoders, journalPath, false);
+            replayer.start();
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (recordingListener.getHistory().size() < 2 &&
+                   std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            if (replayer.getNoReplayedTasks() != 2 || replayer.getNoSkippedRecords() != 1)
+            {
+                throw std::runtime_error("expected 2 replayed tasks and 1 skipped record, got " +
+                                         std::to_string(replayer.getNoReplayedTasks()) + " and " +
+                                         std::to_string(replayer.getNoSkippedRecords()));
+            }
+        }
+        taskingManager.reset(nullptr);
+
+        auto replayedTasks = recordingListener.getHistory();
+        auto firstTask = replayedTasks.size() == 2 ? std::dynamic_pointer_cast<TestJournaledTask>(replayedTasks[0])
+                                                   : nullptr;
+        auto secondTask = replayedTasks.size() == 2 ? std::dynamic_pointer_cast<TestJournaledTask>(replayedTasks[1])
+                                                    : nullptr;
+        if (firstTask == nullptr || firstTask->identifier != "before" || secondTask == nullptr ||
+            secondTask->identifier != "after")
+        {
+            throw std::runtime_error("the valid records around the corrupted one were not replayed");
+        }
+        std::filesystem::remove(journalPath);
+    }
+
+    // testing that a clear handled on the control lane before the data lane backlog drops that backlog
+    void RunTestClearEpoch01()
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+        ClearingTaskListener clearingListener;
+        taskingManager->registerTaskListener(&clearingListener);
+
+        // the data lane is flooded before the broadcast starts, the clear is broadcasted in the middle of it
+        for (int64_t i = 0; i < CLEAR_TEST_NO_TASKS; i++)
+        {
+            taskingManager->broadcastTask(std::make_shared<TestSentDataTask>(i));
+        }
+        taskingManager->startTaskBroadcast();
+        size_t noExpectedTasks = CLEAR_TEST_NO_TASKS + 1 + CLEAR_TEST_NO_TASKS_AFTER;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (clearingListener.noReceivedTasks < noExpectedTasks && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        // joining the lanes makes the listener members safe to read
+        taskingManager->stopTaskBroadcast();
+
+        if (clearingListener.noReceivedTasks != noExpectedTasks)
+        {
+            throw std::runtime_error("expected " + std::to_string(noExpectedTasks) + " tasks, got " +
+                                     std::to_string(clearingListener.noReceivedTasks));
+        }
+        // only the data tasks sent after the clear are left in the backend, whenever the clear was handled
+        auto &backend = clearingListener.backend;
+        if (backend.size() != CLEAR_TEST_NO_TASKS_AFTER)
+        {
+            throw std::runtime_error(std::to_string(backend.size()) +
+                                     " data tasks were left after the clear instead of " +
+                                     std::to_string(CLEAR_TEST_NO_TASKS_AFTER));
+        }
+        for (size_t i = 0; i < backend.size(); i++)
+        {
+            if (backend[i] < CLEAR_TEST_NO_TASKS)
+            {
+                throw std::runtime_error("data task sent at " + std::to_string(backend[i]) +
+                                         " before the clear reached the backend after it");
+            }
+        }
+        spdlog::info("The clear overtook and dropped {} queued data tasks", clearingListener.noDroppedTasks.load());
+
+        taskingManager.reset(nullptr);
+    }
+
   private:
+    /**
+     * @brief Queue a backlog of normal priority tasks in a lane, and check that the high priority task
+     * broadcasted while the lane works through it is broadcasted before the rest of the backlog.
+     *
+     * @param lane the lane of the backlog, and of the high priority task
+     * @param makeHighPriorityTask creates the high priority task
+     */
+    void runPriorityTest(TaskLane lane, std::function<std::shared_ptr<Task>()> makeHighPriorityTask)
+    {
+        taskingManager = std::make_unique<TaskingManager>();
+        PriorityTaskListener priorityListener(makeHighPriorityTask);
+        taskingManager->registerTaskListener(&priorityListener);
+
+        // the backlog piles up as the broadcast is not started yet, and is taken at once by the lane
+        for (int i = 0; i < PRIORITY_TEST_NO_TASKS; i++)
+        {
+            taskingManager->broadcastTask(std::make_shared<TestPriorityTask>(i, TASK_PRIORITY_NORMAL, lane));
+        }
+        taskingManager->startTaskBroadcast();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (priorityListener.noReceivedTasks < PRIORITY_TEST_NO_TASKS + 1 &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        // joining the lanes makes the listener members safe to read
+        taskingManager->stopTaskBroadcast();
+
+        auto &indexes = priorityListener.receivedIndexes;
+        if (indexes.size() != PRIORITY_TEST_NO_TASKS + 1)
+        {
+            throw std::runtime_error("expected " + std::to_string(PRIORITY_TEST_NO_TASKS + 1) + " tasks, got " +
+                                     std::to_string(indexes.size()));
+        }
+        // the high priority task comes right after the one that broadcasted it, before the queued ones,
+        // and the others keep their order
+        for (size_t i = 0; i < indexes.size(); i++)
+        {
+            int expectedIndex = i <= PRIORITY_TEST_PREEMPTED_INDEX       ? int(i)
+                                : i == PRIORITY_TEST_PREEMPTED_INDEX + 1 ? -1
+                                                                         : int(i) - 1;
+            if (indexes[i] != expectedIndex)
+            {
+                throw std::runtime_error("task " + std::to_string(indexes[i]) + " was broadcasted at position " +
+                                         std::to_string(i));
+            }
+        }
+        auto latencyMs = std::chrono::duration<double, std::milli>(priorityListener.latency).count();
+        spdlog::info("High priority task broadcasted {:.3f}ms after being posted behind {} queued tasks", latencyMs,
+                     PRIORITY_TEST_NO_TASKS - PRIORITY_TEST_PREEMPTED_INDEX - 1);
+
+        taskingManager.reset(nullptr);
+    }
+
+    /**
+     * @brief Count the completed and not failed CancelTask in a listener history.
+     */
+    size_t countSuccessfulUndo(const std::vector<std::shared_ptr<Task>> &receivedTasks)
+    {
+        size_t noSuccessfulUndo = 0;
+        for (size_t i = 0; i < receivedTasks.size(); i++)
+        {
+            auto cancelTask = taskCast<CancelTask>(receivedTasks[i]);
+            if (cancelTask != nullptr && cancelTask->isCompleted() && !cancelTask->hasFailed())
+            {
+                noSuccessfulUndo++;
+            }
+        }
+        return noSuccessfulUndo;
+    }
+
     std::unique_ptr<TaskingManager> taskingManager;
 };
 
@@ -453,4 +1492,17 @@ int main(int argc, char *argv[])
     TestSuite t;
     t.RunTestPostTasks01();
     t.RunTestCancelRestore01();
+    t.RunTestHistoryBounds01();
+    t.RunTestTypedDispatch01();
+    t.RunTestLanes01();
+    t.RunTestListenerRegistry01();
+    t.RunTestTaskPool01();
+    t.RunTestCoalescing01();
+    t.RunTestTaskJournal01();
+    t.RunTestTaskJournal02();
+    spdlog::set_level(spdlog::level::info);
+    t.RunTestPriority01();
+    t.RunTestPriority02();
+    t.RunTestClearEpoch01();
+    t.RunTestThroughput01();
 }
\ No newline at end of file
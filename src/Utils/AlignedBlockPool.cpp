@@ -0,0 +1,134 @@
+#include "AlignedBlockPool.h"
+#include <new>
+
+PooledBlock::PooledBlock() : pool(nullptr), blockIndex(0), blockData(nullptr), blockSize(0)
+{
+}
+
+PooledBlock::PooledBlock(PooledBlock &&other) noexcept
+    : pool(std::move(other.pool)), blockIndex(other.blockIndex), blockData(other.blockData),
+      blockSize(other.blockSize), heapData(std::move(other.heapData))
+{
+    other.pool = nullptr;
+    other.blockData = nullptr;
+    other.blockSize = 0;
+}
+
+PooledBlock &PooledBlock::operator=(PooledBlock &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        pool = std::move(other.pool);
+        blockIndex = other.blockIndex;
+        blockData = other.blockData;
+        blockSize = other.blockSize;
+        heapData = std::move(other.heapData);
+        other.pool = nullptr;
+        other.blockData = nullptr;
+        other.blockSize = 0;
+    }
+    return *this;
+}
+
+PooledBlock::~PooledBlock()
+{
+    release();
+}
+
+float *PooledBlock::data()
+{
+    return blockData;
+}
+
+const float *PooledBlock::data() const
+{
+    return blockData;
+}
+
+size_t PooledBlock::size() const
+{
+    return blockSize;
+}
+
+bool PooledBlock::isPooled() const
+{
+    return pool != nullptr;
+}
+
+void PooledBlock::release()
+{
+    if (pool != nullptr)
+    {
+        pool->releaseBlock(blockIndex);
+        pool = nullptr;
+    }
+    std::vector<float>().swap(heapData);
+    blockData = nullptr;
+    blockSize = 0;
+}
+
+std::shared_ptr<AlignedBlockPool> AlignedBlockPool::create(size_t blockSize, size_t noBlocks)
+{
+    // the constructor is private, so make_shared can't be used
+    return std::shared_ptr<AlignedBlockPool>(new AlignedBlockPool(blockSize, noBlocks));
+}
+
+AlignedBlockPool::AlignedBlockPool(size_t _blockSize, size_t _noBlocks)
+    : blockSize(_blockSize), noBlocks(_noBlocks), freeBlocks(_noBlocks), noHeapFallbacks(0)
+{
+    size_t floatsPerAlignment = ALIGNED_BLOCK_POOL_ALIGNMENT / sizeof(float);
+    blockStride = ((blockSize + floatsPerAlignment - 1) / floatsPerAlignment) * floatsPerAlignment;
+    slab = static_cast<float *>(
+        ::operator new(sizeof(float) * blockStride * noBlocks, std::align_val_t(ALIGNED_BLOCK_POOL_ALIGNMENT)));
+    for (size_t i = 0; i < noBlocks; i++)
+    {
+        freeBlocks.queue(i);
+    }
+}
+
+AlignedBlockPool::~AlignedBlockPool()
+{
+    ::operator delete(slab, std::align_val_t(ALIGNED_BLOCK_POOL_ALIGNMENT));
+}
+
+PooledBlock AlignedBlockPool::acquire(size_t noFloats)
+{
+    PooledBlock block;
+    block.blockSize = noFloats;
+    if (noFloats <= blockSize)
+    {
+        auto blockIndex = freeBlocks.dequeue();
+        if (blockIndex.has_value())
+        {
+            block.pool = shared_from_this();
+            block.blockIndex = *blockIndex;
+            block.blockData = slab + (*blockIndex * blockStride);
+            return block;
+        }
+    }
+    noHeapFallbacks++;
+    block.heapData.resize(noFloats);
+    block.blockData = block.heapData.data();
+    return block;
+}
+
+size_t AlignedBlockPool::getBlockSize() const
+{
+    return blockSize;
+}
+
+size_t AlignedBlockPool::getNoFreeBlocks()
+{
+    return freeBlocks.getSize();
+}
+
+uint64_t AlignedBlockPool::getNoHeapFallbacks() const
+{
+    return noHeapFallbacks;
+}
+
+void AlignedBlockPool::releaseBlock(size_t blockIndex)
+{
+    freeBlocks.queue(blockIndex);
+}
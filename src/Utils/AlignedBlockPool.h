@@ -0,0 +1,137 @@
+#pragma once
+
+#include "NoAllocIndexQueue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**< Alignment in bytes of the blocks of an AlignedBlockPool (a cache line, and enough for AVX-512 loads) */
+#define ALIGNED_BLOCK_POOL_ALIGNMENT 64
+
+class AlignedBlockPool;
+
+/**
+ * @brief A block of floats acquired from an AlignedBlockPool. It gives the block back to
+ * the pool when it is destroyed (or released), so it can only be moved around.
+ * If the pool had no block available, or the requested size did not fit in a block,
+ * it owns a heap allocated array instead.
+ */
+class PooledBlock
+{
+  public:
+    /**
+     * @brief Construct an empty block.
+     */
+    PooledBlock();
+
+    PooledBlock(PooledBlock &&other) noexcept;
+    PooledBlock &operator=(PooledBlock &&other) noexcept;
+    PooledBlock(const PooledBlock &) = delete;
+    PooledBlock &operator=(const PooledBlock &) = delete;
+
+    /**
+     * @brief Give the block back to its pool.
+     */
+    ~PooledBlock();
+
+    /**
+     * @brief Pointer to the first float of the block.
+     */
+    float *data();
+
+    /**
+     * @brief Pointer to the first float of the block.
+     */
+    const float *data() const;
+
+    /**
+     * @brief Number of floats that were requested for this block.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Tells if the floats live in the pool, or false if they are heap allocated or the block is empty.
+     */
+    bool isPooled() const;
+
+    /**
+     * @brief Give the block back to its pool now, leaving this block empty.
+     */
+    void release();
+
+  private:
+    friend class AlignedBlockPool;
+
+    std::shared_ptr<AlignedBlockPool> pool; /**< pool the block comes from, keeps the slab alive */
+    size_t blockIndex;                      /**< index of the block in the pool */
+    float *blockData;                       /**< first float of the block */
+    size_t blockSize;                       /**< number of floats requested */
+    std::vector<float> heapData;            /**< floats of the block if it could not come from the pool */
+};
+
+/**
+ * @brief A fixed size slab of aligned blocks of floats, allocated once at creation.
+ * Acquiring and releasing a block does not allocate (except when falling back to the heap
+ * because no block is left, which is counted). It is thread safe.
+ * It is always held by a shared_ptr, as the blocks keep it alive until they are all released.
+ */
+class AlignedBlockPool : public std::enable_shared_from_this<AlignedBlockPool>
+{
+  public:
+    /**
+     * @brief Create a pool.
+     *
+     * @param blockSize number of floats in each block
+     * @param noBlocks number of blocks in the slab
+     * @return std::shared_ptr<AlignedBlockPool> the new pool
+     */
+    static std::shared_ptr<AlignedBlockPool> create(size_t blockSize, size_t noBlocks);
+
+    /**
+     * @brief Free the slab.
+     */
+    ~AlignedBlockPool();
+
+    /**
+     * @brief Acquire a block of noFloats floats. Its content is undefined.
+     *
+     * @param noFloats number of floats needed, if it is more than the block size, the block is heap allocated
+     * @return PooledBlock the block that goes back to the pool when destroyed
+     */
+    PooledBlock acquire(size_t noFloats);
+
+    /**
+     * @brief Number of floats in each block.
+     */
+    size_t getBlockSize() const;
+
+    /**
+     * @brief Number of blocks in the pool that are not used.
+     */
+    size_t getNoFreeBlocks();
+
+    /**
+     * @brief Number of blocks that were heap allocated since the pool was created,
+     * because the pool was exhausted or the block size too small.
+     */
+    uint64_t getNoHeapFallbacks() const;
+
+  private:
+    friend class PooledBlock;
+
+    AlignedBlockPool(size_t blockSize, size_t noBlocks);
+
+    /**
+     * @brief Put a block back in the free blocks.
+     */
+    void releaseBlock(size_t blockIndex);
+
+    size_t blockSize;                      /**< number of floats in each block */
+    size_t blockStride;                    /**< number of floats between two blocks starts, to keep them aligned */
+    size_t noBlocks;                       /**< number of blocks in the slab */
+    float *slab;                           /**< the aligned memory of all blocks */
+    NoAllocIndexQueue freeBlocks;          /**< indexes of the blocks that can be acquired */
+    std::atomic<uint64_t> noHeapFallbacks; /**< number of blocks that had to be heap allocated */
+};
@@ -0,0 +1,87 @@
+#include "LruIndexList.h"
+#include <stdexcept>
+
+LruIndexList::LruIndexList(size_t capacity)
+    : newer(capacity, -1), older(capacity, -1), inList(capacity, false), pinCounts(capacity, 0), newest(-1),
+      oldest(-1), size(0)
+{
+}
+
+void LruIndexList::markUsed(size_t index)
+{
+    if (index >= newer.size())
+    {
+        throw std::out_of_range("index is beyond the capacity of the LruIndexList");
+    }
+    if (newest == (int64_t)index)
+    {
+        return;
+    }
+    // unlink the index if it is already in the list, and link it back as the newest one
+    remove(index);
+    newer[index] = -1;
+    older[index] = newest;
+    if (newest >= 0)
+    {
+        newer[(size_t)newest] = (int64_t)index;
+    }
+    else
+    {
+        oldest = (int64_t)index;
+    }
+    newest = (int64_t)index;
+    inList[index] = true;
+    size++;
+}
+
+void LruIndexList::remove(size_t index)
+{
+    if (index >= inList.size() || !inList[index])
+    {
+        return;
+    }
+    if (newer[index] >= 0)
+    {
+        older[(size_t)newer[index]] = older[index];
+    }
+    else
+    {
+        newest = older[index];
+    }
+    if (older[index] >= 0)
+    {
+        newer[(size_t)older[index]] = newer[index];
+    }
+    else
+    {
+        oldest = newer[index];
+    }
+    newer[index] = -1;
+    older[index] = -1;
+    inList[index] = false;
+    size--;
+}
+
+void LruIndexList::pin(size_t index)
+{
+    pinCounts.at(index)++;
+}
+
+void LruIndexList::unpin(size_t index)
+{
+    if (pinCounts.at(index) == 0)
+    {
+        throw std::logic_error("unpinning an index of the LruIndexList that is not pinned");
+    }
+    pinCounts[index]--;
+}
+
+bool LruIndexList::isPinned(size_t index) const
+{
+    return pinCounts.at(index) > 0;
+}
+
+size_t LruIndexList::getSize() const
+{
+    return size;
+}
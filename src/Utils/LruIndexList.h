@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Least recently used order of the indexes of a preallocated array, as a doubly linked list
+ * stored in vectors, so that marking an index as used never allocates. Indexes can be pinned while
+ * they are being written, so that they are never picked for eviction.
+ * It is not thread safe.
+ */
+class LruIndexList
+{
+  public:
+    /**
+     * @brief Construct an empty list.
+     *
+     * @param capacity the indexes of the list must be below it
+     */
+    LruIndexList(size_t capacity);
+
+    /**
+     * @brief Make an index the most recently used one, adding it to the list if it is not in it.
+     *
+     * @param index the index, it throws a std::out_of_range if it is not below the capacity
+     */
+    void markUsed(size_t index);
+
+    /**
+     * @brief Remove an index from the list, if it is in it. Its pins are kept.
+     *
+     * @param index the index
+     */
+    void remove(size_t index);
+
+    /**
+     * @brief Prevent an index from being picked by getIndexToEvict until it is unpinned as many times.
+     *
+     * @param index the index
+     */
+    void pin(size_t index);
+
+    /**
+     * @brief Undo a call to pin.
+     *
+     * @param index the index
+     */
+    void unpin(size_t index);
+
+    /**
+     * @brief Tells if an index is pinned.
+     */
+    bool isPinned(size_t index) const;
+
+    /**
+     * @brief Pick the least recently used index that is not pinned and that isPreferred accepts,
+     * or the least recently used index that is not pinned if isPreferred accepts none of them.
+     *
+     * @param isPreferred callable taking an index and returning true if it should be evicted first
+     * @return std::optional<size_t> the index, or nothing if the list only has pinned indexes
+     */
+    template <typename Preferred> std::optional<size_t> getIndexToEvict(Preferred isPreferred) const
+    {
+        std::optional<size_t> leastRecentlyUsed;
+        for (int64_t i = oldest; i >= 0; i = newer[(size_t)i])
+        {
+            if (pinCounts[(size_t)i] > 0)
+            {
+                continue;
+            }
+            if (isPreferred((size_t)i))
+            {
+                return (size_t)i;
+            }
+            if (!leastRecentlyUsed.has_value())
+            {
+                leastRecentlyUsed = (size_t)i;
+            }
+        }
+        return leastRecentlyUsed;
+    }
+
+    /**
+     * @brief Number of indexes in the list.
+     */
+    size_t getSize() const;
+
+  private:
+    std::vector<int64_t> newer;      /**< next more recently used index of each index, or -1 */
+    std::vector<int64_t> older;      /**< next less recently used index of each index, or -1 */
+    std::vector<bool> inList;        /**< true for the indexes in the list */
+    std::vector<uint32_t> pinCounts; /**< number of pins of each index */
+    int64_t newest;                  /**< most recently used index or -1 */
+    int64_t oldest;                  /**< least recently used index or -1 */
+    size_t size;                     /**< number of indexes in the list */
+};
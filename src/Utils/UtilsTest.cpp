@@ -1,4 +1,8 @@
+#include "AlignedBlockPool.h"
+#include "LruIndexList.h"
 #include "NoAllocIndexQueue.h"
+#include <cstdint>
+#include <vector>
 #include <stdexcept>
 
 int main(int, char **)
@@ -73,4 +77,148 @@ int main(int, char **)
     {
         throw std::runtime_error("queue didn't throw exception when full");
     }
+
+    auto pool = AlignedBlockPool::create(100, 4);
+
+    // blocks should be aligned and come from the pool until it's exhausted
+    {
+        std::vector<PooledBlock> blocks;
+        for (size_t i = 0; i < 4; i++)
+        {
+            blocks.push_back(pool->acquire(100));
+            if (!blocks.back().isPooled() || blocks.back().size() != 100)
+            {
+                throw std::runtime_error("block did not come from the pool");
+            }
+            if (((uintptr_t)blocks.back().data()) % ALIGNED_BLOCK_POOL_ALIGNMENT != 0)
+            {
+                throw std::runtime_error("block is not aligned");
+            }
+            blocks.back().data()[99] = float(i);
+        }
+        if (pool->getNoFreeBlocks() != 0)
+        {
+            throw std::runtime_error("wrong number of free blocks");
+        }
+        // blocks must not overlap
+        for (size_t i = 0; i < 4; i++)
+        {
+            if (blocks[i].data()[99] != float(i))
+            {
+                throw std::runtime_error("blocks are overlapping");
+            }
+        }
+
+        auto exhaustedBlock = pool->acquire(100);
+        if (exhaustedBlock.isPooled() || exhaustedBlock.data() == nullptr || pool->getNoHeapFallbacks() != 1)
+        {
+            throw std::runtime_error("exhausted pool did not fall back to the heap");
+        }
+    }
+
+    // blocks should have been given back on destruction
+    if (pool->getNoFreeBlocks() != 4)
+    {
+        throw std::runtime_error("blocks were not given back to the pool");
+    }
+
+    // too large blocks should fall back to the heap
+    auto largeBlock = pool->acquire(101);
+    if (largeBlock.isPooled() || largeBlock.size() != 101 || pool->getNoHeapFallbacks() != 2)
+    {
+        throw std::runtime_error("too large block did not fall back to the heap");
+    }
+
+    // moving a block should not give it back, releasing it should
+    auto movedFrom = pool->acquire(10);
+    float *movedData = movedFrom.data();
+    PooledBlock movedTo = std::move(movedFrom);
+    if (movedTo.data() != movedData || movedFrom.data() != nullptr || pool->getNoFreeBlocks() != 3)
+    {
+        throw std::runtime_error("moving a block did not transfer it");
+    }
+    movedTo.release();
+    if (movedTo.data() != nullptr || pool->getNoFreeBlocks() != 4)
+    {
+        throw std::runtime_error("releasing a block did not give it back");
+    }
+
+    // blocks should keep the pool alive
+    auto outlivingBlock = pool->acquire(10);
+    pool = nullptr;
+    outlivingBlock.data()[9] = 1.0f;
+    outlivingBlock.release();
+
+    // the least recently used index should be evicted first, preferably one the caller prefers
+    LruIndexList lru(8);
+    for (size_t i = 0; i < 8; i++)
+    {
+        lru.markUsed(i);
+    }
+    lru.markUsed(0);
+    if (lru.getSize() != 8 || lru.getIndexToEvict([](size_t) { return false; }) != 1)
+    {
+        throw std::runtime_error("the least recently used index was not evicted first");
+    }
+    if (lru.getIndexToEvict([](size_t index) { return index == 0 || index == 5; }) != 5)
+    {
+        throw std::runtime_error("the least recently used preferred index was not evicted first");
+    }
+
+    // pinned indexes should never be evicted, even if they are the only preferred ones
+    // (a full cache of tiles in view, but the tile being written)
+    lru.pin(1);
+    lru.pin(2);
+    lru.pin(2);
+    if (lru.getIndexToEvict([](size_t index) { return index == 1 || index == 2; }) != 3)
+    {
+        throw std::runtime_error("a pinned index was evicted");
+    }
+    lru.unpin(2);
+    if (!lru.isPinned(2) || lru.getIndexToEvict([](size_t index) { return index == 2; }) != 3)
+    {
+        throw std::runtime_error("an index pinned twice was evicted after being unpinned once");
+    }
+    lru.unpin(2);
+    if (lru.getIndexToEvict([](size_t index) { return index == 2; }) != 2)
+    {
+        throw std::runtime_error("an unpinned index was not evicted");
+    }
+    for (size_t i = 0; i < 8; i++)
+    {
+        if (i != 1)
+        {
+            lru.pin(i);
+        }
+    }
+    lru.remove(1);
+    if (lru.getSize() != 7 || lru.getIndexToEvict([](size_t) { return true; }).has_value())
+    {
+        throw std::runtime_error("an index was evicted while all the indexes left were pinned");
+    }
+
+    // while a level 2 tile is created, the written level 0 tile and the level 1 tile merged from it are pinned,
+    // so the written tile is not evicted even if it is the only one out of view
+    LruIndexList chain(4);
+    for (size_t i = 0; i < 4; i++)
+    {
+        chain.markUsed(i);
+    }
+    chain.pin(0);
+    chain.pin(1);
+    if (chain.getIndexToEvict([](size_t index) { return index == 0; }) != 2)
+    {
+        throw std::runtime_error("the written tile was evicted for a coarser level of detail merged from it");
+    }
+    chain.unpin(0);
+    chain.unpin(1);
+
+    // removed indexes should be added back as the most recently used ones
+    lru.unpin(1);
+    lru.unpin(4);
+    lru.markUsed(1);
+    if (lru.getSize() != 8 || lru.getIndexToEvict([](size_t) { return false; }) != 4)
+    {
+        throw std::runtime_error("a removed index was not added back as the most recently used one");
+    }
 }
\ No newline at end of file